@@ -22,6 +22,9 @@
 #include "demoitem.h"
 #include "appversion.h"
 
+#include "graphics/graphicscapture.h"
+#include "graphics/softwarescene.h"
+
 #include "ccl/app/components/eulacomponent.h"
 #include "ccl/app/navigation/navigator.h"
 #include "ccl/app/options/mainoption.h"
@@ -29,6 +32,7 @@
 #include "ccl/app/params.h"
 
 #include "ccl/base/storage/attributes.h"
+#include "ccl/base/storage/url.h"
 #include "ccl/base/development.h"
 
 #include "ccl/public/app/inavigationserver.h"
@@ -39,6 +43,8 @@
 #include "ccl/public/gui/framework/viewbox.h"
 #include "ccl/public/plugins/itypelibregistry.h"
 #include "ccl/public/system/ifileutilities.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/text/cstring.h"
 #include "ccl/public/text/istringdict.h"
 #include "ccl/public/text/stringbuilder.h"
 
@@ -46,6 +52,8 @@
 #include "ccl/public/plugservices.h"
 #include "ccl/public/systemservices.h"
 
+#include <cstdio>
+
 namespace CCL {
 
 //************************************************************************************************
@@ -87,6 +95,66 @@ namespace GitHubDocs
 	}
 }
 
+//************************************************************************************************
+// CommandLine
+/** Headless runs: "-replay <file.gcap>" profiles a graphics capture and prints the timings,
+	"-render3d <file.png>" renders the 3D demo scene with the software rasterizer into a file. */
+//************************************************************************************************
+
+namespace CommandLine
+{
+	// value following the option in the arguments passed to the executable
+	static bool getOption (String& value, CStringPtr option)
+	{
+		const IArgumentList& arguments = System::GetSystem ().getArguments ();
+		for(int i = 1; i + 1 < arguments.count (); i++)
+			if(arguments.at (i) == option)
+			{
+				value = arguments.at (i + 1);
+				return true;
+			}
+		return false;
+	}
+
+	static void print (StringRef text)
+	{
+		::printf ("%s\n", MutableCString (text, Text::kUTF8).str ());
+	}
+
+	// returns true if a tool ran, the application quits afterwards
+	static bool run ()
+	{
+		String value;
+		if(getOption (value, "-replay"))
+		{
+			Url path;
+			path.fromNativePath (value);
+			AutoPtr<GraphicsCapture> capture = NEW GraphicsCapture;
+			if(capture->load (path))
+				print (capture->profile ());
+			else
+				print (String ("Can't load capture ") << value);
+			return true;
+		}
+		if(getOption (value, "-render3d"))
+		{
+			static constexpr int kWidth = 800;
+			static constexpr int kHeight = 600;
+
+			Url path;
+			path.fromNativePath (value);
+			Url skinFolder;
+			GET_DEVELOPMENT_FOLDER_LOCATION (skinFolder, CCL_APPLICATIONS_DIRECTORY, "ccldemo/skin")
+			if(SoftwareScene::renderToFile (path, skinFolder, kWidth, kHeight))
+				print (String ("Rendered ") << kWidth << "x" << kHeight << " to " << value);
+			else
+				print (String ("Can't render to ") << value);
+			return true;
+		}
+		return false;
+	}
+}
+
 //************************************************************************************************
 // DemoResult
 //************************************************************************************************
@@ -177,6 +245,7 @@ tresult CCL_API DemoNavigationServer::navigateTo (NavigateArgs& args)
 	ITheme* theme = getTheme ();
 	ASSERT (theme)
 	IView* contentView = nullptr;
+	String pageName ("DemoIndex");
 
 	StringRef idString = args.url.getParameters ().lookupValue (CCLSTR ("id"));
 	const DemoItem* currentItem = DemoRegistry::instance ().findItem (idString);
@@ -193,6 +262,7 @@ tresult CCL_API DemoNavigationServer::navigateTo (NavigateArgs& args)
 			Attributes arguments;
 			MutableCString formName = pageItem->getFormName ();
 			arguments.set ("demoFormName", formName);
+			pageName = String (formName);
 			contentView = theme->createView ("DemoPage", demoComponent->asUnknown (), &arguments);
 		}
 	}
@@ -226,9 +296,19 @@ tresult CCL_API DemoNavigationServer::navigateTo (NavigateArgs& args)
 	size.moveTo (Point ());
 	if(!size.isEmpty ())
 		contentView->setSize (size);
-	
+
 	args.contentFrame.getChildren ().removeAll ();
-	args.contentFrame.getChildren ().add (contentView);
+
+	// while a page capture is armed, the page is hosted in a capture view that records its first frame
+	if(PageCapture::instance ().isArmed () && !pageName.isEmpty ())
+	{
+		CaptureView* captureView = NEW CaptureView (size.isEmpty () ? Rect (contentView->getSize ()) : size, pageName);
+		captureView->setSizeMode (IView::kAttachAll);
+		captureView->getChildren ().add (contentView);
+		args.contentFrame.getChildren ().add (*captureView);
+	}
+	else
+		args.contentFrame.getChildren ().add (contentView);
 	return kResultOk;
 }
 
@@ -361,6 +441,9 @@ bool DemoApp::startup ()
 	if(!SuperClass::startup ())
 		return false;
 
+	if(CommandLine::run ())
+		return false;
+
 	// init color scheme
 	MainColorSchemeOption* appSchemeOption = UserOption::init<MainColorSchemeOption> ();
 	appSchemeOption->addConfigurationSavers ();
@@ -19,9 +19,12 @@
 //************************************************************************************************
 
 #include "../demoitem.h"
+#include "../graphics/progressiveimage.h"
+#include "../graphics/scaledimagecache.h"
 
 #include "ccl/app/navigation/webnavigator.h"
 #include "ccl/app/components/colorpicker.h"
+#include "ccl/app/controls/usercontrol.h"
 
 #include "ccl/base/message.h"
 #include "ccl/base/storage/textfile.h"
@@ -32,6 +35,10 @@
 #include "ccl/public/gui/framework/ialert.h"
 #include "ccl/public/gui/framework/ihelpmanager.h"
 #include "ccl/public/gui/framework/guievent.h"
+#include "ccl/public/gui/framework/ifileselector.h"
+#include "ccl/public/gui/framework/itimer.h"
+#include "ccl/public/gui/framework/itheme.h"
+#include "ccl/public/gui/framework/iwindow.h"
 #include "ccl/public/gui/graphics/graphicsfactory.h"
 #include "ccl/public/gui/graphics/igraphics.h"
 #include "ccl/public/gui/graphics/markuptags.h"
@@ -314,10 +321,244 @@ public:
 	}
 };
 
+//************************************************************************************************
+// CachedImageView
+/** Shows an image fitted to the view like ImageView with "fitimage", drawn from the mip level
+	of the scaled image cache instead of resampling the full resolution source. */
+//************************************************************************************************
+
+class CachedImageView: public UserControl
+{
+public:
+	CachedImageView (RectRef size, StringID imageName)
+	: UserControl (size)
+	{
+		image = getTheme ().getImage (imageName);
+	}
+
+	// UserControl
+	void draw (const DrawEvent& event) override
+	{
+		if(!image)
+			return;
+
+		Rect client;
+		getClientRect (client);
+
+		Rect src (0, 0, image->getWidth (), image->getHeight ());
+		float scale = ccl_min (float (client.getWidth ()) / src.getWidth (), float (client.getHeight ()) / src.getHeight ());
+		Rect dst (0, 0, Coord (src.getWidth () * scale), Coord (src.getHeight () * scale));
+		dst.offset ((client.getWidth () - dst.getWidth ()) / 2, (client.getHeight () - dst.getHeight ()) / 2);
+
+		IWindow* window = getWindow ();
+		ScaledImageCache::instance ().drawImage (event.graphics, image, src, dst, window ? window->getContentScaleFactor () : 1.f);
+	}
+
+protected:
+	SharedPtr<IImage> image;
+};
+
+//************************************************************************************************
+// ProgressiveImageView
+/** Loads the file named by the path parameter in the background, shows the coarse preview
+	first and reports timing and memory of the load when it is complete. */
+//************************************************************************************************
+
+class ProgressiveImageView: public UserControl,
+							public ITimerTask
+{
+public:
+	ProgressiveImageView (RectRef size, IParameter* imagePath, IParameter* loadReport)
+	: UserControl (size),
+	  imagePath (imagePath),
+	  loadReport (loadReport),
+	  shownState (ProgressiveImage::kLoading),
+	  polling (false)
+	{
+		ISubject::addObserver (imagePath, this);
+	}
+
+	~ProgressiveImageView ()
+	{
+		ISubject::removeObserver (imagePath, this);
+		setPolling (false);
+		if(image)
+			image->cancel ();
+	}
+
+	// UserControl
+	void notify (ISubject* subject, MessageRef msg) override
+	{
+		if(msg == kChanged && isEqualUnknown (imagePath, subject))
+			startLoading ();
+		else
+			UserControl::notify (subject, msg);
+	}
+
+	void draw (const DrawEvent& event) override
+	{
+		Rect client;
+		getClientRect (client);
+		event.graphics.drawRect (client, Pen (Colors::kGray));
+
+		AutoPtr<IImage> current = image ? image->retainImage () : nullptr;
+		if(!current)
+			return;
+
+		// fitted with the aspect ratio of the source, the preview is stretched to the same rect
+		Rect dst (client);
+		dst.contract (1);
+		ProgressiveImage::Report report = image->getReport ();
+		float sourceWidth = float (report.sourceWidth > 0 ? report.sourceWidth : current->getWidth ());
+		float sourceHeight = float (report.sourceHeight > 0 ? report.sourceHeight : current->getHeight ());
+		IWindow* window = getWindow ();
+		float contentScale = window ? window->getContentScaleFactor () : 1.f;
+
+		// small images are shown at their pixel size, not enlarged
+		float fit = ccl_min (1.f / contentScale, ccl_min (dst.getWidth () / sourceWidth, dst.getHeight () / sourceHeight));
+		Coord width = ccl_max (Coord (sourceWidth * fit + .5f), 1);
+		Coord height = ccl_max (Coord (sourceHeight * fit + .5f), 1);
+		Coord left = dst.left + (dst.getWidth () - width) / 2;
+		Coord top = dst.top + (dst.getHeight () - height) / 2;
+		event.graphics.drawImage (current, Rect (0, 0, current->getWidth (), current->getHeight ()), Rect (left, top, left + width, top + height));
+	}
+
+	// ITimerTask
+	void CCL_API onTimer (ITimer* timer) override
+	{
+		if(!image)
+			return;
+
+		ProgressiveImage::State state = image->getState ();
+		if(state == shownState)
+			return;
+
+		shownState = state;
+		updateClient ();
+
+		if(state == ProgressiveImage::kComplete)
+			loadReport->fromString (image->getReportString ());
+		else if(state == ProgressiveImage::kFailed)
+			loadReport->fromString (CCLSTR ("Loading failed"));
+		else if(state == ProgressiveImage::kCanceled)
+			loadReport->fromString (CCLSTR ("Loading canceled"));
+
+		if(state == ProgressiveImage::kComplete || state == ProgressiveImage::kFailed || state == ProgressiveImage::kCanceled)
+			setPolling (false);
+	}
+
+	CLASS_INTERFACE (ITimerTask, UserControl)
+
+protected:
+	SharedPtr<IParameter> imagePath;
+	SharedPtr<IParameter> loadReport;
+	AutoPtr<ProgressiveImage> image;
+	ProgressiveImage::State shownState;
+	bool polling;
+
+	void startLoading ()
+	{
+		if(image)
+			image->cancel ();
+
+		String pathString;
+		imagePath->toString (pathString);
+		if(pathString.isEmpty ())
+			return;
+
+		Rect client;
+		getClientRect (client);
+		IWindow* window = getWindow ();
+		float scale = window ? window->getContentScaleFactor () : 1.f;
+
+		image = NEW ProgressiveImage (Url (pathString), int (client.getWidth () * scale), int (client.getHeight () * scale));
+		shownState = ProgressiveImage::kLoading;
+		loadReport->fromString (CCLSTR ("Loading..."));
+		image->start ();
+		setPolling (true);
+		updateClient ();
+	}
+
+	void setPolling (bool state)
+	{
+		if(state == polling)
+			return;
+
+		polling = state;
+		if(polling)
+			System::GetGUI ().addIdleTask (this);
+		else
+			System::GetGUI ().removeIdleTask (this);
+	}
+};
+
+//************************************************************************************************
+// ImageViewDemo
+//************************************************************************************************
+
+class ImageViewDemo: public DemoComponent
+{
+public:
+	ImageViewDemo ()
+	{
+		showCacheStats = paramList.addParam ("showImageCacheStats");
+		cacheStats = paramList.addString ("imageCacheStats");
+		openLargeImage = paramList.addParam ("openLargeImage");
+		largeImagePath = paramList.addString ("largeImagePath");
+		largeImageReport = paramList.addString ("largeImageReport");
+	}
+
+	// Component
+	IView* CCL_API createView (StringID name, VariantRef data, const Rect& bounds) override
+	{
+		if(name == "CachedImageView")
+			return *NEW CachedImageView (bounds, "Example1");
+		if(name == "ProgressiveImageView")
+			return *NEW ProgressiveImageView (bounds, largeImagePath, largeImageReport);
+		return nullptr;
+	}
+
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == showCacheStats)
+		{
+			cacheStats->fromString (ScaledImageCache::instance ().getStatisticsString ());
+			return true;
+		}
+		if(param == openLargeImage)
+		{
+			openImageFile ();
+			return true;
+		}
+		return DemoComponent::paramChanged (param);
+	}
+
+protected:
+	IParameter* showCacheStats;
+	IParameter* cacheStats;
+	IParameter* openLargeImage;
+	IParameter* largeImagePath;
+	IParameter* largeImageReport;
+
+	void openImageFile ()
+	{
+		if(AutoPtr<IFileSelector> fileSelector = ccl_new<IFileSelector> (ClassID::FileSelector))
+		{
+			Promise p = fileSelector->runAsync (IFileSelector::kOpenFile, CCLSTR ("Open Image"), 0, nullptr);
+			p.then ([this, fileSelector] (IAsyncOperation& operation)
+			{
+				if(operation.getResult ().asBool ())
+					if(const IUrl* path = fileSelector->getPath (0))
+						largeImagePath->fromString (UrlFullString (*path)); // observed by the view
+			});
+		}
+	}
+};
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 REGISTER_DEMO ("Controls", "WebView", WebViewDemo)
 REGISTER_DEMO ("Controls", "TextEditor", TextEditorDemo)
 REGISTER_DEMO ("Controls", "Headings", DemoComponent)
-REGISTER_DEMO ("Controls", "ImageView", DemoComponent)
+REGISTER_DEMO ("Controls", "ImageView", ImageViewDemo)
 REGISTER_DEMO ("Experimental", "More Controls", ControlsDemo)
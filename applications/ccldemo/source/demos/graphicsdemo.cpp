@@ -19,6 +19,14 @@
 //************************************************************************************************
 
 #include "../demoitem.h"
+#include "../workerpool.h"
+#include "../graphics/clipmask.h"
+#include "../graphics/fontmetricscache.h"
+#include "../graphics/framestatistics.h"
+#include "../graphics/frozenpath.h"
+#include "../graphics/gradientspans.h"
+#include "../graphics/primitivebatch.h"
+#include "../graphics/tiledrenderer.h"
 #include "exampletext.h"
 
 #include "ccl/app/controls/usercontrol.h"
@@ -27,19 +35,25 @@
 #include "ccl/public/gui/iparameter.h"
 
 #include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/ibitmap.h"
 #include "ccl/public/gui/graphics/itextlayout.h"
 #include "ccl/public/gui/graphics/graphicsfactory.h"
 
 #include "ccl/public/gui/framework/itimer.h"
 #include "ccl/public/gui/framework/itheme.h"
+#include "ccl/public/gui/framework/iwindow.h"
 #include "ccl/public/gui/framework/iuserinterface.h"
 
+#include "ccl/public/math/mathprimitives.h"
+
 #include "ccl/public/systemservices.h"
 #include "ccl/public/guiservices.h"
 #include "ccl/public/plugservices.h"
 
 #include "ccl/public/cclversion.h"
 
+#include <cmath>
+
 using namespace CCL;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -55,14 +69,15 @@ FontRef CCL::getStandardFont ()
 //************************************************************************************************
 
 class TestView: public UserControl,
-				public ITimerTask
+				public ITimerTask,
+				public TileContent
 {
 public:
 
-	TestView (RectRef size = Rect (), IParameter* performance = nullptr, IParameter* stats = nullptr)
+	TestView (RectRef size = Rect (), FrameStatistics* frameStatistics = nullptr, TiledRenderer* tiledRenderer = nullptr)
 	: UserControl (size),
-	  performance (performance),
-	  stats (stats),
+	  frameStatistics (frameStatistics),
+	  tiledRenderer (tiledRenderer),
 	  standardFont (getStandardFont ())
 	{
 		System::GetGUI ().addIdleTask (this);
@@ -73,72 +88,94 @@ public:
 		System::GetGUI ().removeIdleTask (this);
 	}
 
-	// ITimerTask
-	void CCL_API onTimer (ITimer* timer) override
+	/** Render content offscreen with 1 to 16 threads and report the average time per frame.
+		Tiles are drawn on the worker pool for this measurement, whether or not the page draws
+		them in parallel. */
+	String measureTileScaling (int iterations = 10)
 	{
-		updateClient ();
-	}
+		Rect clientRect;
+		getClientRect (clientRect);
 
-	CLASS_INTERFACE (ITimerTask, UserControl)
+		AutoPtr<IImage> bitmap = GraphicsFactory::createBitmap (clientRect.getWidth (), clientRect.getHeight (), IBitmap::kRGBAlpha);
+		AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (bitmap);
+		if(!graphics)
+			return String ();
 
-protected:
-	SharedPtr<IParameter> performance;
-	SharedPtr<IParameter> stats;
-	Vector<double> drawTimes;
-	Font standardFont;
+		TiledRenderer renderer;
+		renderer.setEnabled (true);
+		renderer.setParallel (true);
+
+		String result;
+		double singleThreadTime = 0.;
+		static const int kThreadCounts[] = {1, 2, 4, 8, 16};
+		for(int threadCount : kThreadCounts)
+		{
+			renderer.setThreadCount (threadCount);
+			renderer.render (*graphics, clientRect, *this); // warm up tile bitmaps
+
+			double startTime = System::GetProfileTime ();
+			for(int i = 0; i < iterations; i++)
+				renderer.render (*graphics, clientRect, *this);
+			double ms = (System::GetProfileTime () - startTime) * 1000. / iterations;
+			if(threadCount == 1)
+				singleThreadTime = ms;
+
+			result << threadCount << "T ";
+			result.appendFloatValue (ms, 2);
+			result << "ms (x";
+			result.appendFloatValue (ms > 0. ? singleThreadTime / ms : 0., 1);
+			result << ")  ";
+		}
+		return result;
+	}
 
-	struct PerformanceScope
+	/** Compare tiled rendering with the settings of renderer against drawing without tiles. */
+	String verifyTiles (TiledRenderer& renderer)
 	{
-		PerformanceScope (TestView* view)
-		: view (view), startTime (System::GetProfileTime ())
-		{}
+		Rect clientRect;
+		getClientRect (clientRect);
 
-		~PerformanceScope ()
-		{
-			double endTime = System::GetProfileTime ();
-			double ms = (endTime - startTime) * 1000.;
-			if(view->performance)
-			{
-				String s;
-				s << "Draw took ";
-				s.appendFloatValue (ms, 2);
-				s << "ms";
-				view->performance->fromString (s);
-			}
+		int maxDelta = 0;
+		int tileCount = 0;
+		int mismatches = renderer.compare (clientRect.getWidth (), clientRect.getHeight (), *this, &maxDelta, &tileCount);
+		String result;
+		if(mismatches < 0)
+			result << "FAILED: bitmaps not available";
+		else if(mismatches > 0)
+			result << "FAILED: " << mismatches << " pixels differ, max delta " << maxDelta;
+		else
+			result << "identical, " << tileCount << " tiles";
+		return result;
+	}
 
-			if(view->stats)
-			{
-				Vector<double>& times = view->drawTimes;
+	// UserControl
+	void draw (const DrawEvent& event) override
+	{
+		FrameStatistics::Scope scope (frameStatistics, partialFrame);
 
-				times.add (ms);
-				if(times.count () > 100)
-					times.removeFirst ();
+		IWindow* window = getWindow ();
+		deviceScale = window ? window->getContentScaleFactor () : 1.f;
 
-				double min = 1000;
-				double max = 0;
-				double sum = 0;
-				for(double ms : times)
-				{
-					min = ccl_min (min, ms);
-					max = ccl_max (max, ms);
-					sum += ms;
-				}
+		if(tiledRenderer && tiledRenderer->isEnabled ())
+			tiledRenderer->render (event.graphics, event.updateRgn.bounds, *this, deviceScale);
+		else
+			drawTile (event.graphics);
+	}
 
-				String s;
-				s << "min ";
-				s.appendFloatValue (min, 2);
-				s << "ms / max ";
-				s.appendFloatValue (max, 2);
-				s << "ms / avg ";
-				s.appendFloatValue (sum / times.count (), 2);
-				s << "ms";
-				view->stats->fromString (s);
-			}
-		}
+	// ITimerTask
+	void CCL_API onTimer (ITimer* timer) override
+	{
+		updateClient ();
+	}
 
-		TestView* view;
-		double startTime;
-	};
+	CLASS_INTERFACE (ITimerTask, UserControl)
+
+protected:
+	SharedPtr<FrameStatistics> frameStatistics;
+	SharedPtr<TiledRenderer> tiledRenderer;
+	Font standardFont;
+	bool partialFrame = false;	///< one of several views sharing the statistics
+	float deviceScale = 1.f;	///< updated in draw (), tiles may be drawn on other threads
 };
 
 //************************************************************************************************
@@ -148,17 +185,15 @@ protected:
 class GraphicsTestView: public TestView
 {
 public:
-	GraphicsTestView (RectRef size, IParameter* performance, IParameter* stats)
-	: TestView (size, performance, stats)
-	{}
-
-	// UserControl
-	void draw (const DrawEvent& event) override
+	GraphicsTestView (RectRef size, FrameStatistics* frameStatistics, TiledRenderer* tiledRenderer = nullptr)
+	: TestView (size, frameStatistics, tiledRenderer)
 	{
-		IGraphics& graphics = event.graphics;
-
-		PerformanceScope scope (this);
+		buildPaths ();
+	}
 
+	// TileContent
+	void drawTile (IGraphics& graphics) override
+	{
 		Rect clientRect;
 		getClientRect (clientRect);
 
@@ -359,16 +394,14 @@ public:
 
 		// text with float coords
 		f.setSize (12);
+		RectF glyphRects[40];
 		RectF rectF (0, 300, PointF (20, 20));
 		for(char i = 0; i < 20; i++)
 		{
 			String x ("X");
 			RectF size;
 			graphics.measureString (size, x, f);
-
-			AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
-			path->addRect (size.moveTo (rectF.getLeftTop ()));
-			graphics.drawPath (path, Pen (Colors::kBlack));
+			glyphRects[i] = size.moveTo (rectF.getLeftTop ());
 
 			graphics.drawString (rectF, x, f, SolidBrush (Colors::kBlack), Alignment::kLeftTop);
 			rectF.offset (size.getWidth (), 0.1f);
@@ -380,15 +413,15 @@ public:
 			String x ("X");
 			RectF size;
 			graphics.measureString (size, x, f);
-
-			AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
-			path->addRect (size.moveTo (rectF.getLeftTop ()));
-			graphics.drawPath (path, Pen (Colors::kBlack));
+			glyphRects[20 + i] = size.moveTo (rectF.getLeftTop ());
 
 			graphics.drawString (rectF, x, f, SolidBrush (Colors::kBlack), Alignment::kLeftTop);
 			rectF.offset (0.1f, size.getHeight ());
 		}
 
+		Pen glyphPen (Colors::kBlack);
+		PrimitiveBatch::drawRects (graphics, glyphRects, ARRAY_COUNT (glyphRects), &glyphPen);
+
 		// line caps / join
 		r = Rect (0, 350, Point (100, 30));
 		const Pen::LineCap lineCaps[] = { Pen::kLineCapButt, Pen::kLineCapSquare, Pen::kLineCapRound };
@@ -447,6 +480,44 @@ public:
 		graphics.drawLine (PointF (outsideRect.getCenter ().x, outsideRect.top), PointF (outsideRect.getCenter ().x, outsideRect.bottom), pen);
 
 		graphics.restoreState ();
+
+		// same clip with a cached mask, rotated around its center: the mask follows the transform
+		PointF clipCenter = clipPathRect.getCenter ();
+		PathTransform clipTransform;
+		clipTransform.translate (clipCenter.x, clipCenter.y).rotate (Math::degreesToRad (15.f)).translate (-clipCenter.x, -clipCenter.y);
+
+		outsideRect = clipPathRect;
+		outsideRect.expand (100);
+
+		// clipped content only lands inside the clip path, so the masked layer covers its transformed bounds
+		RectF maskBounds = clipTransform.mapBounds (clipPathRect);
+		Rect layerBounds (Coord (std::floor (maskBounds.left)), Coord (std::floor (maskBounds.top)), Coord (std::ceil (maskBounds.right)), Coord (std::ceil (maskBounds.bottom)));
+		ClipMaskLayer layer (graphics, layerBounds, deviceScale, clipTransform);
+		layer.addClip (*clipPath);
+		if(IGraphics* clipped = layer.getGraphics ())
+		{
+			clipped->fillRect (outsideRect, SolidBrush (Colors::kRed));
+			clipped->drawLine (PointF (outsideRect.left, outsideRect.getCenter ().y), PointF (outsideRect.right, outsideRect.getCenter ().y), pen);
+			clipped->drawLine (PointF (outsideRect.getCenter ().x, outsideRect.top), PointF (outsideRect.getCenter ().x, outsideRect.bottom), pen);
+		}
+	}
+
+protected:
+	// the mask layer caches its rasterized clip per path, so the path is built once
+	AutoPtr<FrozenPath> clipPath;
+	RectF clipPathRect;
+
+	void buildPaths ()
+	{
+		clipPathRect = RectF (280, 450, PointF (100, 100));
+		clipPath = NEW FrozenPath (true);
+		clipPath->setEvenOdd (true).addRect (clipPathRect);
+		RectF circleRect = clipPathRect;
+		circleRect.offset (35, 10).setWidth (30).setHeight (30);
+		clipPath->addArc (circleRect, 45, 360);
+		circleRect.offset (10, 50).setWidth (10).setHeight (10);
+		clipPath->addArc (circleRect, 0, 360);
+		clipPath->freeze ();
 	}
 };
 
@@ -457,18 +528,22 @@ public:
 class TextAlignView: public TestView
 {
 public:
-	TextAlignView (FontRef font, IParameter* _customText)
-	: customText (_customText),
+	TextAlignView (FontRef font, IParameter* _customText, FrameStatistics* frameStatistics = nullptr, TiledRenderer* tiledRenderer = nullptr)
+	: TestView (Rect (), frameStatistics, tiledRenderer),
+	  customText (_customText),
 	  font (font),
 	  boxHeight (10)
 	{
+		partialFrame = true; // the page shows one view per font size
 		updateTexts ();
-		ISubject::addObserver (customText, this);
+		if(customText)
+			ISubject::addObserver (customText, this);
 	}
 
 	~TextAlignView ()
 	{
-		ISubject::removeObserver (customText, this);
+		if(customText)
+			ISubject::removeObserver (customText, this);
 	}
 
 	// UserControl
@@ -480,10 +555,9 @@ public:
 			TestView::notify (subject, msg);
 	}
 	
-	void draw (const DrawEvent& event) override
+	// TileContent
+	void drawTile (IGraphics& graphics) override
 	{
-		IGraphics& graphics = event.graphics;
-
 		RectF rect (1, 1);
 		Font headerFont (standardFont);
 		graphics.drawString (Rect (rect.left, 0, Point (200, 50)), String ("size: ") << font.getSize (), headerFont, SolidBrush (Colors::kBlack), Alignment::kLeftTop);
@@ -491,7 +565,7 @@ public:
 		texts.forEach ([&] (StringRef text)
 		{
 			Rect measuredSize;
-			Font::measureString (measuredSize, text, font);
+			FontMetricsCache::instance ().measureString (measuredSize, text, font);
 
 			rect.top = + kHeaderH;
 			rect.setWidth (measuredSize.getWidth () * 1.3);
@@ -526,11 +600,19 @@ public:
 					graphics.drawString (origin, text, font, SolidBrush (Colors::kBlack), IGraphics::kDrawAtBaseline);
 
 					RectF size;
-					Font::measureStringImage (size, text, font, true);
+					FontMetricsCache::instance ().measureStringImage (size, text, font, true);
 					graphics.drawRect (size.offset (pointIntToF (origin)), Pen (Colors::kRed));
 
 					graphics.drawLine (Point (origin.x - 2, origin.y), Point (origin.x + rect.getWidth (), origin.y), Pen (Colors::kGreen));
 					graphics.drawLine (Point (origin.x, origin.y - 2), Point (origin.x, origin.y + 2), Pen (Colors::kGreen));
+
+					CoordF ascent = 0, descent = 0;
+					FontMetricsCache::instance ().getAscentDescent (ascent, descent, font);
+					Pen metricsPen (Color (Colors::kGreen).setAlphaF (0.4));
+					CoordF left = CoordF (origin.x);
+					CoordF right = CoordF (origin.x + rect.getWidth ());
+					graphics.drawLine (PointF (left, origin.y - ascent), PointF (right, origin.y - ascent), metricsPen);
+					graphics.drawLine (PointF (left, origin.y + descent), PointF (right, origin.y + descent), metricsPen);
 				}
 				r.offset (0, rect.getHeight () + kSpacing);
 			}
@@ -550,7 +632,8 @@ protected:
 	void updateTexts ()
 	{
 		String text;
-		customText->toString (text);
+		if(customText)
+			customText->toString (text);
 
 		bool changed = false;
 		if(text.isEmpty ())
@@ -592,7 +675,7 @@ protected:
 		texts.forEach ([&] (StringRef text)
 		{
 			Rect measuredSize;
-			Font::measureString (measuredSize, text, font);
+			FontMetricsCache::instance ().measureString (measuredSize, text, font);
 			totalSize.right += (Coord)(measuredSize.right * 1.3 + kSpacing);
 
 			ccl_lower_limit (boxHeight, (Coord)(measuredSize.bottom * 1.3));
@@ -602,42 +685,593 @@ protected:
 	}
 };
 
+//************************************************************************************************
+// BatchingBenchmark
+//************************************************************************************************
+
+namespace BatchingBenchmark
+{
+	static constexpr Coord kSize = 1024;
+	static constexpr int kPrimitiveCount = 100000;
+	static constexpr int kStyleCount = 4;
+	static constexpr Coord kImageSize = 16;
+
+	struct Scene
+	{
+		Vector<RectF> rects;
+		Vector<PointF> points;
+		Vector<uint16> styles;
+		Vector<PrimitiveBatch::ImageItem> imageItems;
+		Vector<uint16> imageStyles;
+		Pen pens[kStyleCount];
+		SolidBrush brushes[kStyleCount];
+		AutoPtr<IImage> bitmaps[kStyleCount];
+		IImage* images[kStyleCount];
+
+		Scene ()
+		{
+			rects.resize (kPrimitiveCount);
+			points.resize (2 * kPrimitiveCount);
+			styles.resize (kPrimitiveCount);
+			imageItems.resize (kPrimitiveCount);
+			imageStyles.resize (kPrimitiveCount);
+
+			// fixed seed, so runs are comparable
+			uint32 seed = 0x12345678;
+			auto random = [&seed] (float range)
+			{
+				seed = seed * 1664525 + 1013904223;
+				return range * float (seed >> 8) / float (1 << 24);
+			};
+
+			for(int i = 0; i < kPrimitiveCount; i++)
+			{
+				PointF p (random (kSize), random (kSize));
+				rects.add (RectF (p.x, p.y, PointF (1.f + random (20.f), 1.f + random (20.f))));
+				points.add (p);
+				points.add (PointF (p.x + random (40.f) - 20.f, p.y + random (40.f) - 20.f));
+				styles.add (uint16 (i * kStyleCount / kPrimitiveCount)); // long runs, like grid lines or cells
+
+				PrimitiveBatch::ImageItem item;
+				item.src = Rect (0, 0, kImageSize, kImageSize);
+				item.dst = Rect (Coord (p.x), Coord (p.y), Point (kImageSize, kImageSize));
+				imageItems.add (item);
+				imageStyles.add (uint16 (i % kStyleCount)); // icons of a list, images alternate
+			}
+
+			const Color colors[kStyleCount] = {Colors::kRed, Colors::kGreen, Colors::kBlue, Colors::kBlack};
+			for(int s = 0; s < kStyleCount; s++)
+			{
+				pens[s] = Pen (colors[s]);
+				brushes[s] = SolidBrush (colors[s]);
+
+				bitmaps[s] = GraphicsFactory::createBitmap (kImageSize, kImageSize, IBitmap::kRGBAlpha);
+				if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (bitmaps[s]))
+					graphics->fillRect (Rect (0, 0, kImageSize, kImageSize), brushes[s]);
+				images[s] = bitmaps[s];
+			}
+		}
+	};
+
+	static String run ()
+	{
+		Scene scene;
+		AutoPtr<IImage> bitmap = GraphicsFactory::createBitmap (kSize, kSize, IBitmap::kRGBAlpha);
+		AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (bitmap);
+		if(!graphics)
+			return String ("no bitmap graphics");
+
+		auto measure = [&] (auto draw)
+		{
+			graphics->fillRect (Rect (0, 0, kSize, kSize), SolidBrush (Colors::kWhite));
+			double startTime = System::GetProfileTime ();
+			draw ();
+			return (System::GetProfileTime () - startTime) * 1000.;
+		};
+
+		double rectsSingle = measure ([&] ()
+		{
+			for(int i = 0; i < kPrimitiveCount; i++)
+				graphics->drawRect (scene.rects[i], scene.pens[scene.styles[i]]);
+		});
+		int rectSubmissions = 0;
+		double rectsBatched = measure ([&] ()
+		{
+			rectSubmissions = PrimitiveBatch::drawRects (*graphics, scene.rects.getItems (), kPrimitiveCount, scene.pens, scene.styles.getItems ());
+		});
+
+		double fillsSingle = measure ([&] ()
+		{
+			for(int i = 0; i < kPrimitiveCount; i++)
+				graphics->fillRect (scene.rects[i], scene.brushes[scene.styles[i]]);
+		});
+		int fillSubmissions = 0;
+		double fillsBatched = measure ([&] ()
+		{
+			fillSubmissions = PrimitiveBatch::fillRects (*graphics, scene.rects.getItems (), kPrimitiveCount, scene.brushes, scene.styles.getItems ());
+		});
+
+		double linesSingle = measure ([&] ()
+		{
+			for(int i = 0; i < kPrimitiveCount; i++)
+				graphics->drawLine (scene.points[2 * i], scene.points[2 * i + 1], scene.pens[scene.styles[i]]);
+		});
+		int lineSubmissions = 0;
+		double linesBatched = measure ([&] ()
+		{
+			lineSubmissions = PrimitiveBatch::drawLines (*graphics, scene.points.getItems (), kPrimitiveCount, scene.pens, scene.styles.getItems ());
+		});
+
+		// images can't be merged, the batch only groups them by image
+		double imagesSingle = measure ([&] ()
+		{
+			for(int i = 0; i < kPrimitiveCount; i++)
+				graphics->drawImage (scene.images[scene.imageStyles[i]], scene.imageItems[i].src, scene.imageItems[i].dst);
+		});
+		double imagesGrouped = measure ([&] ()
+		{
+			PrimitiveBatch::drawImages (*graphics, scene.imageItems.getItems (), kPrimitiveCount, scene.images, scene.imageStyles.getItems (), PrimitiveBatch::kUnordered);
+		});
+
+		String result;
+		result << kPrimitiveCount << " rects: ";
+		result.appendFloatValue (rectsSingle, 1);
+		result << " ms single / ";
+		result.appendFloatValue (rectsBatched, 1);
+		result << " ms batched (" << rectSubmissions << " calls) | filled: ";
+		result.appendFloatValue (fillsSingle, 1);
+		result << " ms single / ";
+		result.appendFloatValue (fillsBatched, 1);
+		result << " ms batched (" << fillSubmissions << " calls) | lines: ";
+		result.appendFloatValue (linesSingle, 1);
+		result << " ms single / ";
+		result.appendFloatValue (linesBatched, 1);
+		result << " ms batched (" << lineSubmissions << " calls) | images: ";
+		result.appendFloatValue (imagesSingle, 1);
+		result << " ms alternating / ";
+		result.appendFloatValue (imagesGrouped, 1);
+		result << " ms grouped by image";
+		return result;
+	}
+}
+
+//************************************************************************************************
+// TiledRenderingDemo
+//************************************************************************************************
+
+class TiledRenderingDemo: public DemoComponent
+{
+public:
+	TiledRenderingDemo ()
+	: tiledRenderer (NEW TiledRenderer)
+	{
+		addComponent (frameStatistics = NEW FrameStatistics);
+		tiledRendering = paramList.addParam ("tiledRendering");
+		parallelTiles = paramList.addParam ("parallelTiles");
+		renderThreads = paramList.addInteger (1, WorkerPool::kMaxThreads, "renderThreads");
+		renderThreads->setValue (tiledRenderer->getThreadCount ());
+		verifyTiles = paramList.addParam ("verifyTiles");
+		tileCheck = paramList.addString ("tileCheck");
+	}
+
+	// Component
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == tiledRendering)
+			tiledRenderer->setEnabled (param->getValue ().asBool ());
+		else if(param == parallelTiles)
+			tiledRenderer->setParallel (param->getValue ().asBool ());
+		else if(param == renderThreads)
+			tiledRenderer->setThreadCount (param->getValue ().asInt ());
+		else if(param == verifyTiles)
+		{
+			// detached instance, so the visible views keep drawing normally
+			AutoPtr<TestView> view = createDetachedView ();
+			tileCheck->fromString (view->verifyTiles (*tiledRenderer));
+			return true;
+		}
+		return DemoComponent::paramChanged (param);
+	}
+
+protected:
+	AutoPtr<TiledRenderer> tiledRenderer;
+	FrameStatistics* frameStatistics;	///< owned as child component, shown by the "FrameStatisticsHUD" form
+	IParameter* tiledRendering;
+	IParameter* parallelTiles;
+	IParameter* renderThreads;
+	IParameter* verifyTiles;
+	IParameter* tileCheck;
+
+	/** View drawing the same content as the page, not attached to a window. */
+	virtual TestView* createDetachedView () = 0;
+};
+
+//************************************************************************************************
+// GradientKernelBenchmark
+//************************************************************************************************
+
+namespace GradientKernelBenchmark
+{
+	static void setupGradients (GradientSpanFiller& linear, GradientSpanFiller& radial, Coord size)
+	{
+		linear.setLinear (PointF (0, 0), PointF ((CoordF)size, (CoordF)size * .25f))
+			  .addStop (0.f, Colors::kRed)
+			  .addStop (.5f, Color (Colors::kGreen).setAlphaF (.5f))
+			  .addStop (1.f, Colors::kBlue);
+
+		radial.setRadial (PointF ((CoordF)size * .5f, (CoordF)size * .5f), (CoordF)size * .4f)
+			  .addStop (0.f, Colors::kYellow)
+			  .addStop (.7f, Colors::kRed)
+			  .addStop (1.f, Colors::kTransparentBlack);
+	}
+
+	/** Maximum channel difference between the span filler and the graphics backend filling the same gradient. */
+	static int compareWithBackend (const GradientBrush& brush, const GradientSpanFiller& filler, Coord width, Coord height)
+	{
+		AutoPtr<IImage> backendBitmap = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+		if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (backendBitmap))
+			graphics->fillRect (Rect (0, 0, width, height), brush);
+
+		AutoPtr<IImage> spanBitmap = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+		filler.fillBitmap (*UnknownPtr<IBitmap> (spanBitmap), Rect (0, 0, width, height));
+
+		BitmapDataLocker backend (UnknownPtr<IBitmap> (backendBitmap), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+		BitmapDataLocker spans (UnknownPtr<IBitmap> (spanBitmap), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+		if(backend.result != kResultOk || spans.result != kResultOk)
+			return -1;
+
+		int maxDelta = 0;
+		for(int y = 0; y < height; y++)
+		{
+			const uint8* a = static_cast<const uint8*> (backend.data.scan0) + y * backend.data.rowBytes;
+			const uint8* b = static_cast<const uint8*> (spans.data.scan0) + y * spans.data.rowBytes;
+			for(int i = 0; i < width * 4; i++)
+				maxDelta = ccl_max (maxDelta, ccl_abs (int (a[i]) - int (b[i])));
+		}
+		return maxDelta;
+	}
+
+	/** Two stops as in GraphicsTestView, more stops with a translucent one, and a radial gradient. */
+	static String compareWithBackend ()
+	{
+		static constexpr Coord kWidth = 256;
+		static constexpr Coord kHeight = 64;
+
+		PointF start (0, 0);
+		PointF end ((CoordF)kWidth, (CoordF)kHeight * .25f);
+		PointF center ((CoordF)kWidth * .5f, (CoordF)kHeight * .5f);
+		CoordF radius = (CoordF)kWidth * .4f;
+
+		GradientSpanFiller twoStops;
+		twoStops.setLinear (start, end).addStop (0.f, Colors::kRed).addStop (1.f, Colors::kBlue);
+
+		const GradientStop linearStops[] = {{0.f, Colors::kRed}, {.5f, Color (Colors::kGreen).setAlphaF (.5f)}, {1.f, Colors::kBlue}};
+		GradientSpanFiller multiStop;
+		multiStop.setLinear (start, end);
+		for(const GradientStop& stop : linearStops)
+			multiStop.addStop (stop.position, stop.color);
+
+		const GradientStop radialStops[] = {{0.f, Colors::kYellow}, {.7f, Colors::kRed}, {1.f, Colors::kTransparentBlack}};
+		GradientSpanFiller radial;
+		radial.setRadial (center, radius);
+		for(const GradientStop& stop : radialStops)
+			radial.addStop (stop.position, stop.color);
+
+		struct Case { CStringPtr name; int delta; };
+		Case cases[] =
+		{
+			{"linear", compareWithBackend (LinearGradientBrush (start, end, Colors::kRed, Colors::kBlue), twoStops, kWidth, kHeight)},
+			{"multi-stop", compareWithBackend (LinearGradientBrush (start, end, linearStops, ARRAY_COUNT (linearStops)), multiStop, kWidth, kHeight)},
+			{"radial", compareWithBackend (RadialGradientBrush (center, radius, radialStops, ARRAY_COUNT (radialStops)), radial, kWidth, kHeight)}
+		};
+
+		String result;
+		for(const Case& c : cases)
+		{
+			if(c.delta < 0)
+				return String ("FAILED: bitmaps not available");
+			if(c.delta > 0)
+				result << (result.isEmpty () ? "FAILED: " : ", ") << c.name << " max delta " << c.delta;
+		}
+		if(result.isEmpty ())
+			result << "identical to backend";
+		else
+			result << " vs. backend";
+		return result;
+	}
+
+	static String run ()
+	{
+		static constexpr Coord kSize = 512;
+		static constexpr int kIterations = 20;
+
+		Vector<uint32> pixels;
+		pixels.resize (kSize);
+		pixels.setCount (kSize);
+
+		GradientSpanFiller linear, radial;
+		setupGradients (linear, radial, kSize);
+
+		String result;
+		for(int k = 0; k < GradientSpanFiller::kNumKernels; k++)
+		{
+			auto kernel = GradientSpanFiller::Kernel (k);
+			if(!GradientSpanFiller::isKernelSupported (kernel))
+				continue;
+
+			linear.setKernel (kernel);
+			radial.setKernel (kernel);
+
+			auto measure = [&] (const GradientSpanFiller& filler)
+			{
+				double startTime = System::GetProfileTime ();
+				for(int i = 0; i < kIterations; i++)
+					for(int y = 0; y < kSize; y++)
+						filler.fillSpan (pixels.getItems (), 0, y, kSize);
+				double seconds = System::GetProfileTime () - startTime;
+				return seconds > 0. ? double (kSize) * kSize * kIterations / seconds / 1e6 : 0.;
+			};
+
+			result << GradientSpanFiller::getKernelName (kernel) << " linear ";
+			result.appendFloatValue (measure (linear), 0);
+			result << " / radial ";
+			result.appendFloatValue (measure (radial), 0);
+			result << " Mpx/s  ";
+		}
+
+		// the SIMD kernels must match the scalar spans pixel by pixel, the backend may round differently
+		int mismatches = linear.verifyKernels () + radial.verifyKernels ();
+		if(mismatches != 0)
+			result << "| FAILED: " << mismatches << " pixels differ from scalar";
+		else
+			result << "| identical to scalar";
+		result << " | " << compareWithBackend ();
+		return result;
+	}
+}
+
+//************************************************************************************************
+// FrozenPathView
+/** Arcs and line caps / joins of GraphicsTestView under a zoom transform, stroked by the backend
+	on the left and from cached FrozenPath outlines on the right. */
+//************************************************************************************************
+
+class FrozenPathView: public TestView
+{
+public:
+	FrozenPathView (RectRef size, IParameter* zoom, FrameStatistics* frameStatistics)
+	: TestView (size, frameStatistics),
+	  zoom (zoom)
+	{
+		buildPaths ();
+	}
+
+	// TileContent
+	void drawTile (IGraphics& graphics) override
+	{
+		Rect clientRect;
+		getClientRect (clientRect);
+
+		graphics.fillRect (clientRect, SolidBrush (Colors::kWhite));
+		graphics.drawLine (Point (clientRect.getWidth () / 2, 0), Point (clientRect.getWidth () / 2, clientRect.bottom), Pen (Colors::kGray));
+
+		float zoomFactor = zoom ? float (zoom->getValue ().asDouble ()) : 1.f;
+		for(int side = 0; side < 2; side++)
+		{
+			PathTransform transform;
+			transform.translate (float (side * clientRect.getWidth () / 2) + 10.f, 10.f).scale (zoomFactor, zoomFactor);
+
+			for(int i = 0; i < kShapeCount; i++)
+			{
+				if(side == 1)
+					frozenPaths[i]->stroke (graphics, pens[i], transform, deviceScale);
+				else
+				{
+					graphics.saveState ();
+					graphics.addTransform (transform.toTransform ());
+					graphics.drawPath (backendPaths[i], pens[i]);
+					graphics.restoreState ();
+				}
+			}
+		}
+	}
+
+protected:
+	static constexpr int kShapeCount = 12;
+
+	IParameter* zoom;
+	AutoPtr<IGraphicsPath> backendPaths[kShapeCount];
+	AutoPtr<FrozenPath> frozenPaths[kShapeCount];
+	Pen pens[kShapeCount];
+
+	void buildPaths ()
+	{
+		int index = 0;
+		auto addArc = [&] (RectFRef rect, float start, float range)
+		{
+			backendPaths[index] = GraphicsFactory::createPath ();
+			backendPaths[index]->addArc (rect, start, range);
+			frozenPaths[index] = NEW FrozenPath;
+			frozenPaths[index]->addArc (rect, start, range).freeze ();
+			pens[index] = Pen (Colors::kGreen, 7);
+			index++;
+		};
+
+		RectF circle (10, 10, 50, 50);
+		addArc (circle, 120.f, 300.f);
+		circle.offset (circle.getWidth () + 20);
+		circle.setWidth (circle.getWidth () * 2);
+		addArc (circle, 120.f, 300.f);
+		circle.offset (circle.getWidth () + 20);
+		circle.setWidth (circle.getHeight ());
+		addArc (circle, 0.f, 360.f);
+
+		const Pen::LineCap lineCaps[] = { Pen::kLineCapButt, Pen::kLineCapSquare, Pen::kLineCapRound };
+		const Pen::LineJoin lineJoins[] = { Pen::kLineJoinMiter, Pen::kLineJoinBevel, Pen::kLineJoinRound };
+		RectF r (10, 80, PointF (60, 30));
+		for(int c = 0; c < ARRAY_COUNT (lineCaps); c++)
+		{
+			for(int j = 0; j < ARRAY_COUNT (lineJoins); j++)
+			{
+				const PointF points[] =
+				{
+					r.getLeftTop (),
+					PointF (r.left + r.getWidth () * .3f, r.bottom),
+					PointF (r.left + r.getWidth () * .6f, r.top),
+					r.getRightTop ()
+				};
+
+				backendPaths[index] = GraphicsFactory::createPath ();
+				backendPaths[index]->startFigure (points[0]);
+				frozenPaths[index] = NEW FrozenPath;
+				frozenPaths[index]->startFigure (points[0]);
+				for(int p = 1; p < ARRAY_COUNT (points); p++)
+				{
+					backendPaths[index]->lineTo (points[p]);
+					frozenPaths[index]->lineTo (points[p]);
+				}
+				frozenPaths[index]->freeze ();
+
+				pens[index] = Pen (Colors::kBlack, 7);
+				pens[index].setLineCap (lineCaps[c]);
+				pens[index].setLineJoin (lineJoins[j]);
+				index++;
+
+				r.offset (r.getWidth () + 10, 0);
+			}
+			r.offset (0, r.getHeight () + 10);
+			r.moveTo (PointF (10, r.top));
+		}
+	}
+};
+
+//************************************************************************************************
+// FrozenPathDemo
+//************************************************************************************************
+
+class FrozenPathDemo: public DemoComponent
+{
+public:
+	FrozenPathDemo ()
+	{
+		addComponent (frameStatistics = NEW FrameStatistics);
+		zoom = paramList.addFloat (.25f, 4.f, "pathZoom");
+		zoom->setValue (1.f);
+		zoom->setDefaultValue (1.f);
+		showPathStats = paramList.addParam ("showPathStats");
+		pathStats = paramList.addString ("pathStats");
+	}
+
+	// Component
+	IView* CCL_API createView (StringID name, VariantRef data, const Rect& bounds) override
+	{
+		if(name == "TestView")
+			return *NEW FrozenPathView (bounds, zoom, frameStatistics);
+		return nullptr;
+	}
+
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == showPathStats)
+		{
+			pathStats->fromString (FrozenPath::getStatisticsString ());
+			return true;
+		}
+		return DemoComponent::paramChanged (param);
+	}
+
+protected:
+	FrameStatistics* frameStatistics;	///< owned as child component, shown by the "FrameStatisticsHUD" form
+	IParameter* zoom;
+	IParameter* showPathStats;
+	IParameter* pathStats;
+};
+
 //************************************************************************************************
 // GraphicsDemo
 //************************************************************************************************
 
-class GraphicsDemo: public DemoComponent
+class GraphicsDemo: public TiledRenderingDemo
 {
 public:
 	GraphicsDemo ()
 	{
-		performance = paramList.addString ("performance");
-		stats = paramList.addString ("stats");
+		measureScaling = paramList.addParam ("measureScaling");
+		scaling = paramList.addString ("scaling");
+		benchmarkGradients = paramList.addParam ("benchmarkGradients");
+		gradientResults = paramList.addString ("gradientResults");
+		benchmarkBatching = paramList.addParam ("benchmarkBatching");
+		batchingResults = paramList.addString ("batchingResults");
+		showPathStats = paramList.addParam ("showPathStats");
+		pathStats = paramList.addString ("pathStats");
 	}
 
 	// Component
 	IView* CCL_API createView (StringID name, VariantRef data, const Rect& bounds) override
 	{
 		if(name == "TestView")
-			return *NEW GraphicsTestView (bounds, performance, stats);
+			return *NEW GraphicsTestView (bounds, frameStatistics, tiledRenderer);
 		return nullptr;
 	}
 
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == measureScaling)
+		{
+			AutoPtr<TestView> view = createDetachedView ();
+			scaling->fromString (view->measureTileScaling ());
+			return true;
+		}
+		if(param == benchmarkGradients)
+		{
+			gradientResults->fromString (GradientKernelBenchmark::run ());
+			return true;
+		}
+		if(param == benchmarkBatching)
+		{
+			batchingResults->fromString (BatchingBenchmark::run ());
+			return true;
+		}
+		if(param == showPathStats)
+		{
+			pathStats->fromString (String ("clip ") << ClipMaskCache::instance ().getStatisticsString ());
+			return true;
+		}
+		return TiledRenderingDemo::paramChanged (param);
+	}
+
 protected:
-	IParameter* performance;
-	IParameter* stats;
+	IParameter* measureScaling;
+	IParameter* scaling;
+	IParameter* benchmarkGradients;
+	IParameter* gradientResults;
+	IParameter* benchmarkBatching;
+	IParameter* batchingResults;
+	IParameter* showPathStats;
+	IParameter* pathStats;
+
+	// TiledRenderingDemo
+	TestView* createDetachedView () override
+	{
+		return NEW GraphicsTestView (Rect (0, 0, 640, 580), nullptr);
+	}
 };
 
 //************************************************************************************************
 // TextAlignDemo
 //************************************************************************************************
 
-class TextAlignDemo: public DemoComponent
+class TextAlignDemo: public TiledRenderingDemo
 {
 public:
 	TextAlignDemo ()
 	{
 		customText = paramList.addString ("customText");
+		showCacheStats = paramList.addParam ("showCacheStats");
+		cacheStats = paramList.addString ("cacheStats");
+		latinFastPath = paramList.addParam ("latinFastPath");
+		latinFastPath->setValue (FontMetricsCache::instance ().isLatinFastPath ());
+		verifyFastPath = paramList.addParam ("verifyFastPath");
 	}
 
 	// Component
@@ -655,18 +1289,53 @@ public:
 			VectorForEach (ConstVector<float> (fontSizes, ARRAY_COUNT (fontSizes)), float, fontSize)
 				Font f (font);
 				f.setSize (fontSize);
-				layout.getChildren ().add (*NEW TextAlignView (f, customText));
+				layout.getChildren ().add (*NEW TextAlignView (f, customText, frameStatistics, tiledRenderer));
 			EndFor
 			return layout;
 		}
 		return nullptr;
 	}
 
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == showCacheStats)
+		{
+			cacheStats->fromString (FontMetricsCache::instance ().getStatisticsString ());
+			return true;
+		}
+		if(param == latinFastPath)
+		{
+			FontMetricsCache::instance ().setLatinFastPath (param->getValue ().asBool ());
+			return true;
+		}
+		if(param == verifyFastPath)
+		{
+			Font font (getStandardFont ());
+			font.setSize (12);
+			cacheStats->fromString (FontMetricsCache::instance ().verifyLatinFastPath (font));
+			return true;
+		}
+		return TiledRenderingDemo::paramChanged (param);
+	}
+
 protected:
 	IParameter* customText;
+	IParameter* showCacheStats;
+	IParameter* cacheStats;
+	IParameter* latinFastPath;
+	IParameter* verifyFastPath;
+
+	// TiledRenderingDemo
+	TestView* createDetachedView () override
+	{
+		Font font (getStandardFont ());
+		font.setSize (16);
+		return NEW TextAlignView (font, customText);
+	}
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 REGISTER_DEMO ("Graphics", "Graphics 2D", GraphicsDemo)
 REGISTER_DEMO ("Graphics", "Text Alignment", TextAlignDemo)
+REGISTER_DEMO ("Graphics", "Frozen Paths", FrozenPathDemo)
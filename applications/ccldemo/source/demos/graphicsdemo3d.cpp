@@ -21,12 +21,25 @@
 #define DEBUG_LOG 0
 
 #include "../demoitem.h"
+#include "../graphics/framestatistics.h"
+#include "../graphics/geometrycache.h"
+#include "../graphics/instancedmodel.h"
+#include "../graphics/lodmodel.h"
+#include "../graphics/meshoptimizer.h"
+#include "../graphics/objimporter.h"
+#include "../graphics/scenebvh.h"
+#include "../graphics/scenenodeindex.h"
+#include "../graphics/scenepicker.h"
+#include "../graphics/scrollingtexture.h"
+#include "../graphics/softwarescene.h"
+#include "../workerpool.h"
 #include "exampletext.h"
 
 #include "ccl/app/components/scenecomponent3d.h"
 #include "ccl/app/controls/usersceneview3d.h"
 
 #include "ccl/base/storage/url.h"
+#include "ccl/base/development.h"
 
 #include "ccl/public/gui/iparameter.h"
 #include "ccl/public/gui/framework/itheme.h"
@@ -48,6 +61,7 @@
 #include "ccl/public/math/mathprimitives.h"
 
 #include "ccl/public/plugservices.h"
+#include "ccl/public/systemservices.h"
 
 namespace Tag 
 {
@@ -69,7 +83,15 @@ namespace Tag
 		kBillboardActive,
 		kTextBillboardActive,
 		kUserView3DActive,
-		kAnimate
+		kAnimate,
+		kBenchmarkImport,
+		kStressNodes,
+		kStressCulling,
+		kInstances,
+		kBenchmarkPicking,
+		kSphereLOD,
+		kBenchmarkOptimizer,
+		kBenchmarkSoftware
 	};
 }
 
@@ -148,11 +170,11 @@ public:
 
 	CLASS_INTERFACE (IGraphicsContent3D, Object)
 
+	static const VertexP kVertices[3];
+
 private:
 	AutoPtr<IGraphicsBuffer3D> vertexBuffer;
 	AutoPtr<IGraphicsPipeline3D> pipeline;
-
-	static const VertexP kVertices[3];
 };
 
 const VertexP DemoContent3D::kVertices[3] =
@@ -162,6 +184,27 @@ const VertexP DemoContent3D::kVertices[3] =
 	{{  0.0f,  0.5f, 0.0f }}
 };
 
+//************************************************************************************************
+// SphereLevels
+//************************************************************************************************
+
+struct SphereLevels: LODContent
+{
+	float radius = 0.f;
+	Vector<int> segments;	///< per level
+	AutoPtr<IMaterial3D> material;
+	SharedPtr<GeometryCache> geometryCache;
+
+	// LODContent
+	IModel3D* createLevel (int level) override
+	{
+		IModel3D* model = geometryCache->getSphere (material, radius, segments[level], segments[level]);
+		if(model)
+			model->retain ();
+		return model;
+	}
+};
+
 //************************************************************************************************
 // DemoSceneView
 //************************************************************************************************
@@ -171,11 +214,17 @@ class DemoSceneView: public UserSceneView3D
 public:
 	DECLARE_CLASS (DemoSceneView, UserSceneView3D)
 
-	DemoSceneView (RectRef size = Rect (), StyleRef style = 0, StringRef title = 0);
+	DemoSceneView (RectRef size = Rect (), StyleRef style = 0, StringRef title = 0, SceneNodeIndex* nodeIndex = nullptr,
+				   ScenePicker* picker = nullptr, ICamera3D* camera = nullptr);
 
 	// UserSceneView3D
 	bool onMouseEnter (const MouseEvent& event) override;
 	bool onMouseMove (const MouseEvent& event) override;
+
+protected:
+	SharedPtr<SceneNodeIndex> nodeIndex;
+	SharedPtr<ScenePicker> picker;
+	SharedPtr<ICamera3D> camera;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -184,8 +233,12 @@ DEFINE_CLASS_HIDDEN (DemoSceneView, UserSceneView3D)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-DemoSceneView::DemoSceneView (RectRef size, StyleRef style, StringRef title)
-: UserSceneView3D (size, style, title)
+DemoSceneView::DemoSceneView (RectRef size, StyleRef style, StringRef title, SceneNodeIndex* nodeIndex,
+							  ScenePicker* picker, ICamera3D* camera)
+: UserSceneView3D (size, style, title),
+  nodeIndex (nodeIndex),
+  picker (picker),
+  camera (camera)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -203,7 +256,7 @@ bool DemoSceneView::onMouseMove (const MouseEvent& event)
 	if(scene == nullptr)
 		return true;
 
-	ISceneNode3D* billboard = scene->getChildren ()->findNode ("textBillboard");
+	ISceneNode3D* billboard = nodeIndex ? nodeIndex->findNode ("textBillboard") : scene->getChildren ()->findNode ("textBillboard");
 	UnknownPtr<IModelNode3D> modelNode (billboard);
 	UnknownPtr<IModel3D> model = modelNode ? modelNode->getModelData () : nullptr;
 	UnknownPtr<ITextureMaterial3D> material = model ? model->getFirstMaterial () : nullptr;
@@ -211,8 +264,20 @@ bool DemoSceneView::onMouseMove (const MouseEvent& event)
 	if(!material.isValid ())
 		return true;
 
+	// the picker rejects most positions, the exact test of the billboard facing the camera
+	// is left to findNodeAt () when the ray reaches its bounds before anything else
+	bool hit = true;
+	if(picker && camera)
+	{
+		Rect client;
+		getClientRect (client);
+		ScenePicker::Hit pickHit;
+		hit = picker->pickAt (pickHit, *camera, PointF (CoordF (event.where.x), CoordF (event.where.y)),
+							  PointF (CoordF (client.getWidth ()), CoordF (client.getHeight ()))) && pickHit.node == billboard;
+	}
+
 	SceneEdit3D scope (scene, billboard, IScene3D::kUserEdit);
-	if(findNodeAt (event.where) == billboard)
+	if(hit && findNodeAt (event.where) == billboard)
 		material->setOpacity (.9f);
 	else
 		material->setOpacity (.6f);
@@ -231,6 +296,7 @@ public:
 	DECLARE_CLASS (DemoSceneComponent, SceneComponent3D)
 
 	DemoSceneComponent ();
+	~DemoSceneComponent ();
 
 	// SceneComponent3D
 	tbool CCL_API paramChanged (IParameter* param) override;
@@ -247,16 +313,79 @@ private:
 	static constexpr CoordF kCameraPosRange = 20;
 	static constexpr float kFieldOfViewAngleMin = 0.1f;
 	static constexpr float kFieldOfViewAngleMax = 135.f;
+	static constexpr float kStressRange = 18.f;
+	static constexpr float kStressNodeRadius = .08f;
+	static constexpr int kStressMovesPerFrame = 1000;
+	static constexpr float kCullingAspectRatio = 2.f;	///< widest expected view, culls conservatively
+	static constexpr float kCullingNearDistance = .01f;
+	static constexpr int kInstanceGridSize = 10;
+	static constexpr float kInstanceSpacing = 1.5f;
+	static constexpr CoordF kPickBenchmarkWidth = 800;
+	static constexpr CoordF kPickBenchmarkHeight = 600;
+	static constexpr CoordF kLODViewHeight = 600;	///< reference view for projected sizes
+	static constexpr float kSphereRadius = .5f;
+	static constexpr int kSoftwareRenderWidth = 800;
+	static constexpr int kSoftwareRenderHeight = 600;
+	static constexpr int kSoftwareRenderFrames = 5;
+
+	enum InstanceMode { kInstancesOff, kInstancesAsNodes, kInstancesBaked };
+
+	struct StressNode
+	{
+		IModelNode3D* node = nullptr;	///< owned, retained again by the scene while attached
+		PointF3D position;
+		PointF3D velocity;
+		int proxy = -1;
+		int visibleFrame = -1;
+		bool attached = false;
+	};
+
+	/** Demo node culled with the stress nodes, kept in the culling tree under the user index -tag. */
+	struct CulledSceneNode
+	{
+		ISceneNode3D* node = nullptr;	///< owned by the scene, by this entry while detached
+		int tag = 0;
+		BoundingBox3D localBounds;
+		bool billboard = false;			///< turns towards the camera, bounds hold any orientation
+		int proxy = -1;
+		int visibleFrame = -1;
+		bool detached = false;
+	};
 
 	SharedPtr<ICamera3D> camera;
-	AutoPtr<ITextLayout> textLayout;
-	AutoPtr<IImage> dynamicTexture;
+	AutoPtr<ScrollingTexture> scrollingTexture;
 	AutoPtr<ITextureMaterial3D> dynamicTextureMaterial;
 	ILightSource3D* ambientLight;
 	ILightSource3D* directionalLight;
 	UnknownPtr<IPointLight3D> bluePointLight;
 	UnknownPtr<IPointLight3D> redPointLight;
-	int idleCounter;
+	AutoPtr<SceneNodeIndex> nodeIndex;
+	AutoPtr<ScenePicker> picker;
+	AutoPtr<GeometryCache> geometryCache;
+	AutoPtr<IMaterial3D> gridMaterial;
+	AutoPtr<IMaterial3D> outlineCubeMaterial;
+	AutoPtr<IMaterial3D> transparentCubeMaterial;
+	AutoPtr<IMaterial3D> sphereMaterial;
+	IParameter* cacheReport;
+	FrameStatistics* frameStatistics;
+	IParameter* stressReport;
+	Vector<StressNode> stressNodes;
+	Vector<CulledSceneNode> culledSceneNodes;
+	DynamicBVH cullingTree;
+	Vector<int> visibleNodes;
+	int stressFrame;
+	double lastStressReportTime;
+	MeshData instanceSource;
+	Vector<ISceneNode3D*> instanceNodes;
+	IParameter* instancesReport;
+	MeshData instanceBaked;
+	IParameter* pickReport;
+	IParameter* softwareReport;
+	IParameter* textureReport;
+	double lastTextureReportTime;
+	AutoPtr<LODModel> sphereLOD;
+	IParameter* lodReport;
+	double lastLODReportTime;
 	
 	ICamera3D* addCamera (IScene3D* scene);
 	void addLight (IScene3D* scene);
@@ -272,10 +401,23 @@ private:
 	void applyToCamera ();
 	void syncCameraParams ();
 	void updateDynamicTextBillboard ();
-	void setNodeNameFromTag (IModelNode3D* node, int tag);
+	void addNodeWithTag (ISceneNode3D* node, int tag);
 	ISceneNode3D* findNodeByTag (int tag);
 	bool removeNodeWithTag (int tag);
 	void animateScene ();
+	void createStressNodes (int count);
+	void removeStressNodes ();
+	void updateStressTest ();
+	bool getLocalBounds (BoundingBox3D& bounds, bool& billboard, int tag);
+	BoundingBox3D getWorldBounds (const CulledSceneNode& entry) const;
+	void addCulledNode (ISceneNode3D* node, int tag);
+	void removeCulledNode (int tag);
+	void cullNodes (DynamicBVH::QueryStatistics& queryStatistics, bool culling);
+	bool loadInstanceSource ();
+	void updateInstances (int mode);
+	void runSoftwareBenchmark ();
+	void updateSphereLOD ();
+	void updateCacheReport ();
 
 	// SceneComponent3D
 	void buildScene () override;
@@ -294,7 +436,21 @@ DemoSceneComponent::DemoSceneComponent ()
   directionalLight (nullptr),
   bluePointLight (nullptr),
   redPointLight (nullptr),
-  idleCounter (0)
+  nodeIndex (NEW SceneNodeIndex),
+  picker (NEW ScenePicker),
+  geometryCache (NEW GeometryCache),
+  cacheReport (nullptr),
+  frameStatistics (nullptr),
+  stressReport (nullptr),
+  stressFrame (0),
+  lastStressReportTime (0.),
+  instancesReport (nullptr),
+  pickReport (nullptr),
+  softwareReport (nullptr),
+  textureReport (nullptr),
+  lastTextureReportTime (0.),
+  lodReport (nullptr),
+  lastLODReportTime (0.)
 {
 	createCameraParameters ();
 	buildScene ();
@@ -303,6 +459,38 @@ DemoSceneComponent::DemoSceneComponent ()
 	setMainCamera (camera);
 
 	paramList.addParam ("animate", Tag::kAnimate);
+
+	UnknownPtr<IListParameter> stressList (paramList.addList ("stressNodes", Tag::kStressNodes));
+	stressList->appendString (CCLSTR ("Off"));
+	stressList->appendString (CCLSTR ("10k Nodes"));
+	stressList->appendString (CCLSTR ("50k Nodes"));
+	stressList->appendString (CCLSTR ("100k Nodes"));
+	paramList.addParam ("stressCulling", Tag::kStressCulling)->setValue (true);
+	stressReport = paramList.addString ("stressReport");
+	addComponent (frameStatistics = NEW FrameStatistics);
+
+	UnknownPtr<IListParameter> instancesList (paramList.addList ("instances", Tag::kInstances));
+	instancesList->appendString (CCLSTR ("Off"));
+	instancesList->appendString (CCLSTR ("1,000 Nodes"));
+	instancesList->appendString (CCLSTR ("1,000 Instances"));
+	instancesReport = paramList.addString ("instancesReport");
+	paramList.addParam ("benchmarkPicking", Tag::kBenchmarkPicking);
+	pickReport = paramList.addString ("pickReport");
+	paramList.addParam ("benchmarkSoftware", Tag::kBenchmarkSoftware);
+	softwareReport = paramList.addString ("softwareReport");
+	textureReport = paramList.addString ("textureReport");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+DemoSceneComponent::~DemoSceneComponent ()
+{
+	// attached nodes are released by the scene as well
+	for(StressNode& stressNode : stressNodes)
+		stressNode.node->release ();
+	for(CulledSceneNode& entry : culledSceneNodes)
+		if(entry.detached)
+			entry.node->release ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -324,7 +512,7 @@ void DemoSceneComponent::buildScene ()
 
 UserSceneView3D* DemoSceneComponent::createSceneView (RectRef bounds)
 {
-	return NEW DemoSceneView (bounds);
+	return NEW DemoSceneView (bounds, 0, 0, nodeIndex, picker, camera);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -356,6 +544,16 @@ void CCL_API DemoSceneComponent::sceneChanged (IScene3D& scene, ISceneNode3D* no
 void DemoSceneComponent::onIdleTimer ()
 {
 	updateDynamicTextBillboard ();
+	updateSphereLOD ();
+
+	if(!stressNodes.isEmpty ())
+		updateStressTest ();
+	else if(!culledSceneNodes.isEmpty ())
+	{
+		SceneEdit3D scope (scene);
+		DynamicBVH::QueryStatistics queryStatistics;
+		cullNodes (queryStatistics, paramList.byTag (Tag::kStressCulling)->getValue ().asBool ());
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -387,6 +585,39 @@ tbool CCL_API DemoSceneComponent::paramChanged (IParameter* param)
 	case Tag::kAnimate :
 		animateScene ();
 		break;
+
+	case Tag::kStressNodes :
+		{
+			static const int kStressNodeCounts[] = {0, 10000, 50000, 100000};
+			removeStressNodes ();
+			createStressNodes (kStressNodeCounts[param->getValue ().asInt ()]);
+			frameStatistics->reset ();
+		}
+		break;
+
+	case Tag::kStressCulling :
+		frameStatistics->reset ();
+		break;
+
+	case Tag::kInstances :
+		updateInstances (param->getValue ().asInt ());
+		break;
+
+	case Tag::kBenchmarkPicking :
+		pickReport->fromString (picker->runBenchmark (*camera, PointF (kPickBenchmarkWidth, kPickBenchmarkHeight)));
+		break;
+
+	case Tag::kBenchmarkSoftware :
+		runSoftwareBenchmark ();
+		break;
+
+	case Tag::kSphereLOD :
+		if(paramList.byTag (Tag::kSphereActive)->getValue ().asBool ())
+		{
+			removeNodeWithTag (Tag::kSphereActive);
+			updateSphere (scene, true);
+		}
+		break;
 	}
 	return true;
 }
@@ -396,7 +627,6 @@ tbool CCL_API DemoSceneComponent::paramChanged (IParameter* param)
 ICamera3D* DemoSceneComponent::addCamera (IScene3D* scene)
 {
 	auto cam = ccl_new<ICamera3D> (ClassID::Camera3D);
-	cam->setNodeName ("cam1");
 
 	constexpr float kDefaultFieldOfViewAngle = 33;
 	const PointF3D kDefaultCameraPos (6.f, 8.f, 12.f);
@@ -417,7 +647,7 @@ ICamera3D* DemoSceneComponent::addCamera (IScene3D* scene)
 
 	cam->getConstraints ()->addConstraints (NEW TranslationConstraints3D ({-kCameraPosRange, -kCameraPosRange, -kCameraPosRange}, {kCameraPosRange, kCameraPosRange, kCameraPosRange}));
 
-	scene->getChildren ()->addNode (cam);
+	nodeIndex->addNode (*scene, cam, "cam1");
 	return cam;
 }
 
@@ -458,17 +688,20 @@ void DemoSceneComponent::updateGrid (IScene3D* scene, bool visible)
 			return;
 
 	auto* gridModelNode = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
-	#if 1
-	AutoPtr<IMaterial3D> gridMaterial = ModelFactory3D::createSolidColorMaterial (Colors::kLtGray);
-	#else
-	AutoPtr<IMaterial3D> gridMaterial = ModelFactory3D::createTextureMaterial (demoTexture, Colors::kLtGray);
-	#endif
-	gridMaterial->setDepthBias (20.f);
-	gridModelNode->setModelData (ModelFactory3D::createGrid (4, 4, 1.f, 1.f, gridMaterial));
+	if(!gridMaterial)
+	{
+		#if 1
+		gridMaterial = ModelFactory3D::createSolidColorMaterial (Colors::kLtGray);
+		#else
+		gridMaterial = ModelFactory3D::createTextureMaterial (demoTexture, Colors::kLtGray);
+		#endif
+		gridMaterial->setDepthBias (20.f);
+	}
+	gridModelNode->setModelData (geometryCache->getGrid (gridMaterial, 4, 4, 1.f, 1.f));
 
 	gridModelNode->setPosition ({-2.5f, 0.f, -2.5f});
-	setNodeNameFromTag (gridModelNode, Tag::kGridNodeActive);
-	scene->getChildren ()->addNode (gridModelNode);
+	addNodeWithTag (gridModelNode, Tag::kGridNodeActive);
+	updateCacheReport ();
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -490,8 +723,7 @@ void DemoSceneComponent::updateTeapot (IScene3D* scene, bool visible)
 
 	teapotModelNode->setModelData (demoModel);
 	teapotModelNode->setPosition ({0.f, 1.f, 0.f});
-	setNodeNameFromTag (teapotModelNode, Tag::kTeapotNodeActive);
-	scene->getChildren ()->addNode (teapotModelNode);
+	addNodeWithTag (teapotModelNode, Tag::kTeapotNodeActive);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -503,31 +735,24 @@ void DemoSceneComponent::updateOutlineCube (IScene3D* scene, bool visible)
 			return;
 
 	auto* outlineCubeModelNode = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
-	AutoPtr<IModel3D> cubeModel = ccl_new<IModel3D> (ClassID::Model3D);
-
-	AutoPtr<ICubeTessellator3D> cubeTessellator = ccl_new<ICubeTessellator3D> (ClassID::CubeTessellator3D);
-	cubeTessellator->generate (ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kGenerateInverseNormals | ITessellator3D::kWindingOrderCW);
-	IGeometry3D* innerCubeGeometry = cubeModel->createGeometry ();
-	innerCubeGeometry->copyFrom (*cubeTessellator);
-	cubeTessellator->generate (ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kWindingOrderCCW);
-	IGeometry3D* outerCubeGeometry = cubeModel->createGeometry ();
-	outerCubeGeometry->copyFrom (*cubeTessellator);
-
-	cubeModel->addGeometry (outerCubeGeometry);
-	cubeModel->addGeometry (innerCubeGeometry);
-
-	UnknownPtr<IBitmap> outlineTexture = getTheme ()->getImage ("OutlineTexture");
-	cubeModel->setMaterialForGeometries (ModelFactory3D::createTextureMaterial (outlineTexture));
+	if(!outlineCubeMaterial)
+	{
+		UnknownPtr<IBitmap> outlineTexture = getTheme ()->getImage ("OutlineTexture");
+		outlineCubeMaterial = ModelFactory3D::createTextureMaterial (outlineTexture);
+	}
 
-	outlineCubeModelNode->setModelData (cubeModel);
+	// outer faces first, then the inner ones facing inwards
+	outlineCubeModelNode->setModelData (geometryCache->getCube (outlineCubeMaterial,
+		ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kWindingOrderCCW,
+		ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kGenerateInverseNormals | ITessellator3D::kWindingOrderCW));
 	outlineCubeModelNode->setPosition ({2.5f, 1.f, -1.f});
 	outlineCubeModelNode->setScaleX (.5f);
 	outlineCubeModelNode->setScaleY (.5f);
 	outlineCubeModelNode->setScaleZ (.5f);
 	outlineCubeModelNode->setRollAngle (2.5f);
 	outlineCubeModelNode->setYawAngle (2.f);
-	setNodeNameFromTag (outlineCubeModelNode, Tag::kOutlineCubeActive);
-	scene->getChildren ()->addNode (outlineCubeModelNode);
+	addNodeWithTag (outlineCubeModelNode, Tag::kOutlineCubeActive);
+	updateCacheReport ();
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -538,27 +763,23 @@ void DemoSceneComponent::updateTransparentCube (IScene3D* scene, bool visible)
 		if(removeNodeWithTag (Tag::kTransparentCubeActive))
 			return;
 
-	UnknownPtr<IBitmap> demoTexture = getTheme ()->getImage ("DemoTexture");
 	auto* texturedCubeModelNode = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
-	AutoPtr<IModel3D> texturedCubeModel = ccl_new<IModel3D> (ClassID::Model3D);
-
-	AutoPtr<ICubeTessellator3D> cubeTessellator = ccl_new<ICubeTessellator3D> (ClassID::CubeTessellator3D);
-	cubeTessellator->generate (ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kWindingOrderCCW);
-	IGeometry3D* outerCubeGeometry = texturedCubeModel->createGeometry ();
-	outerCubeGeometry->copyFrom (*cubeTessellator);
-
-	texturedCubeModel->addGeometry (outerCubeGeometry);
-	AutoPtr<ITextureMaterial3D> textureMaterial = ModelFactory3D::createTextureMaterial (demoTexture, Colors::kBlue);
-	textureMaterial->setOpacity (.7f);
-	textureMaterial->setLightMask (ambientLight->getLightMask () | directionalLight->getLightMask () | redPointLight->getLightMask ());
-	texturedCubeModel->setMaterialForGeometries (textureMaterial);
-	texturedCubeModelNode->setModelData (texturedCubeModel);
+	if(!transparentCubeMaterial)
+	{
+		UnknownPtr<IBitmap> demoTexture = getTheme ()->getImage ("DemoTexture");
+		ITextureMaterial3D* textureMaterial = ModelFactory3D::createTextureMaterial (demoTexture, Colors::kBlue);
+		textureMaterial->setOpacity (.7f);
+		textureMaterial->setLightMask (ambientLight->getLightMask () | directionalLight->getLightMask () | redPointLight->getLightMask ());
+		transparentCubeMaterial = textureMaterial;
+	}
+
+	texturedCubeModelNode->setModelData (geometryCache->getCube (transparentCubeMaterial, ITessellator3D::kGenerateTextureCoordinates | ITessellator3D::kWindingOrderCCW));
 	texturedCubeModelNode->setPosition ({4.f, 1.f, 1.f});
 	texturedCubeModelNode->setScaleX (1.2f);
 	texturedCubeModelNode->setScaleY (1.2f);
 	texturedCubeModelNode->setScaleZ (1.2f);
-	setNodeNameFromTag (texturedCubeModelNode, Tag::kTransparentCubeActive);
-	scene->getChildren ()->addNode (texturedCubeModelNode);
+	addNodeWithTag (texturedCubeModelNode, Tag::kTransparentCubeActive);
+	updateCacheReport ();
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -566,22 +787,52 @@ void DemoSceneComponent::updateTransparentCube (IScene3D* scene, bool visible)
 void DemoSceneComponent::updateSphere (IScene3D* scene, bool visible)
 {
 	if(!visible)
+	{
+		sphereLOD = nullptr;
+		lodReport->fromString (String ());
 		if(removeNodeWithTag (Tag::kSphereActive))
 			return;
+	}
 
 	auto* sphereModelNode = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
-	#if 1
-	AutoPtr<IMaterial3D> sphereMaterial = ModelFactory3D::createSolidColorMaterial ({255, 0, 0, 200});
-	#else
-	UnknownPtr<IBitmap> demoTexture = getTheme ()->getImage ("DemoTexture");
-	AutoPtr<IMaterial3D> sphereMaterial = ModelFactory3D::createTextureMaterial (demoTexture, {255, 0, 0, 200});
-	#endif
-	sphereMaterial->setDepthBias (-1.0f);
-	sphereMaterial->setLightMask (ambientLight->getLightMask () | directionalLight->getLightMask () | bluePointLight->getLightMask ());
-	sphereModelNode->setModelData (ModelFactory3D::createSphere (0.5f, 50, 50, sphereMaterial));
+	if(!sphereMaterial)
+	{
+		#if 1
+		sphereMaterial = ModelFactory3D::createSolidColorMaterial ({255, 0, 0, 200});
+		#else
+		UnknownPtr<IBitmap> demoTexture = getTheme ()->getImage ("DemoTexture");
+		sphereMaterial = ModelFactory3D::createTextureMaterial (demoTexture, {255, 0, 0, 200});
+		#endif
+		sphereMaterial->setDepthBias (-1.0f);
+		sphereMaterial->setLightMask (ambientLight->getLightMask () | directionalLight->getLightMask () | bluePointLight->getLightMask ());
+	}
 	sphereModelNode->setPosition ({0.f, 1.f, 2.5f});
-	setNodeNameFromTag (sphereModelNode, Tag::kSphereActive);
-	scene->getChildren ()->addNode (sphereModelNode);
+
+	if(paramList.byTag (Tag::kSphereLOD)->getValue ().asBool ())
+	{
+		// segments and the smallest projected diameter in pixels each level is used for
+		static const struct { int segments; float minScreenSize; } kLevels[] = {{50, 300.f}, {24, 120.f}, {12, 40.f}, {6, 0.f}};
+
+		auto* levels = NEW SphereLevels;
+		levels->radius = kSphereRadius;
+		levels->material.share (sphereMaterial);
+		levels->geometryCache = geometryCache;
+		sphereLOD = NEW LODModel (levels);
+		for(const auto& level : kLevels)
+		{
+			levels->segments.add (level.segments);
+			sphereLOD->addLevel (level.minScreenSize, 2 * level.segments * level.segments);
+		}
+		sphereLOD->update (*sphereModelNode, LODModel::getScreenSize (*camera, sphereModelNode->getPosition (), kSphereRadius, kLODViewHeight));
+	}
+	else
+	{
+		sphereLOD = nullptr;
+		sphereModelNode->setModelData (geometryCache->getSphere (sphereMaterial, kSphereRadius, 50, 50));
+	}
+
+	addNodeWithTag (sphereModelNode, Tag::kSphereActive);
+	updateCacheReport ();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -598,8 +849,7 @@ void DemoSceneComponent::updateBillboard (IScene3D* scene, bool visible)
 	billboardModelNode->setPosition ({0.f, 1.f, 2.5f});
 	billboardModelNode->setScaleX (0.8f * demoTexture->getPixelSize ().x / demoTexture->getPixelSize ().y);
 	billboardModelNode->setScaleY (0.8f);
-	setNodeNameFromTag (billboardModelNode, Tag::kBillboardActive);
-	scene->getChildren ()->addNode (billboardModelNode);
+	addNodeWithTag (billboardModelNode, Tag::kBillboardActive);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -610,22 +860,40 @@ void DemoSceneComponent::updateTextBillboard (IScene3D* scene, bool visible)
 		if(removeNodeWithTag (Tag::kTextBillboardActive))
 			return;
 
-	textLayout = GraphicsFactory::createTextLayout ();
+	// the text is rendered once, scrolling only copies it into the texture
+	AutoPtr<ITextLayout> textLayout = GraphicsFactory::createTextLayout ();
 	Font font (getStandardFont ());
 	font.setSize (40);
 	String text (kExampleText);	
 	textLayout->construct (text, 512, 512, font, ITextLayout::kMultiLine, TextFormat (Alignment::kCenter, TextFormat::kWordBreak));
-	dynamicTexture = GraphicsFactory::createBitmap (512, 512, IBitmap::kRGBAlpha);
-	dynamicTextureMaterial = ModelFactory3D::createTextureMaterial (UnknownPtr<IBitmap> (dynamicTexture), Colors::kWhite);
+	AutoPtr<IImage> textImage = GraphicsFactory::createBitmap (512, 512, IBitmap::kRGBAlpha);
+	if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (textImage))
+	{
+		graphics->clearRect (Rect (0, 0, 512, 512));
+		graphics->drawTextLayout (Point (), textLayout, SolidBrush (Colors::kBlack));
+	}
+
+	scrollingTexture = NEW ScrollingTexture;
+	scrollingTexture->setup (textImage, 512, 512);
+	dynamicTextureMaterial = ModelFactory3D::createTextureMaterial (UnknownPtr<IBitmap> (scrollingTexture->getTexture ()), Colors::kWhite);
 	dynamicTextureMaterial->setLightMask (0);
 	dynamicTextureMaterial->setOpacity (.6f);
+
+	// the texture changes on most frames, building mip levels for each upload is not worth it
+	dynamicTextureMaterial->setTextureFlags (kDiffuseTexture, 0);
+	lastTextureReportTime = System::GetProfileTime ();
 	
 	auto* dynamicTextureModelNode = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
 	dynamicTextureModelNode->setModelData (ModelFactory3D::createBillboard (dynamicTextureMaterial));
 	dynamicTextureModelNode->setPosition ({2.5f, 1.f, 0.f});
 	dynamicTextureModelNode->enableHitTesting (true);
-	setNodeNameFromTag (dynamicTextureModelNode, Tag::kTextBillboardActive);
-	scene->getChildren ()->addNode (dynamicTextureModelNode);
+	addNodeWithTag (dynamicTextureModelNode, Tag::kTextBillboardActive);
+
+	// the unit quad turns towards the camera, its box has to hold it in any orientation
+	ScenePicker::Placement placement;
+	placement.position = PointF3D (2.5f, 1.f, 0.f);
+	BoundingBox3D billboardBounds (PointF3D (-.71f, -.71f, -.71f), PointF3D (.71f, .71f, .71f));
+	picker->addNode (dynamicTextureModelNode, billboardBounds, placement);
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -654,6 +922,11 @@ void DemoSceneComponent::createCameraParameters ()
 
 void DemoSceneComponent::createNodeParameters ()
 {
+	// used by the node updates below
+	cacheReport = paramList.addString ("cacheReport");
+	paramList.addParam ("sphereLOD", Tag::kSphereLOD);
+	lodReport = paramList.addString ("lodReport");
+
 	paramList.addParam ("grid", Tag::kGridNodeActive)->setValue (false, true);
 	paramList.addParam ("teapot", Tag::kTeapotNodeActive)->setValue (true, true);
 	paramList.addParam ("outlineCube", Tag::kOutlineCubeActive)->setValue (false, true);
@@ -707,54 +980,115 @@ void DemoSceneComponent::syncCameraParams ()
 
 void DemoSceneComponent::updateDynamicTextBillboard ()
 {
-	if(ISceneNode3D* billboard = scene->getChildren ()->findNode ("textBillboard"))
+	if(ISceneNode3D* billboard = findNodeByTag (Tag::kTextBillboardActive))
 	{
-		Rect size (0, 0, dynamicTexture->getWidth (), dynamicTexture->getHeight ());
-		if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (dynamicTexture))
+		double now = System::GetProfileTime ();
+		if(scrollingTexture->update (now))
+		{
+			SceneEdit3D scope (scene, billboard);
+			dynamicTextureMaterial->setTexture (kDiffuseTexture, UnknownPtr<IBitmap> (scrollingTexture->getTexture ()));
+		}
+
+		double elapsed = now - lastTextureReportTime;
+		if(elapsed >= FrameStatistics::kUpdateInterval)
 		{
-			graphics->clearRect (size);
+			lastTextureReportTime = now;
+
+			// compared with redrawing and uploading the texture with mip levels on every tick
+			const ScrollingTexture::Statistics& statistics = scrollingTexture->getStatistics ();
+			int64 fullBytes = statistics.ticks * (statistics.textureBytes + statistics.textureBytes / 3);
+			auto kilobytesPerSecond = [&] (int64 bytes) { return int (bytes / 1024. / elapsed); };
 
-			Point offset (0, size.getHeight () - idleCounter);
-			graphics->drawTextLayout (offset, textLayout, SolidBrush (Colors::kBlack));
+			String report;
+			report << int (statistics.ticks / elapsed) << " ticks/s, " << int (statistics.uploads / elapsed) << " uploads/s";
+			report << " | uploaded " << kilobytesPerSecond (statistics.uploadedBytes) << " KB/s (was " << kilobytesPerSecond (fullBytes) << " KB/s)";
+			report << " | changed rows " << kilobytesPerSecond (statistics.dirtyBytes) << " KB/s";
+			textureReport->fromString (report);
+
+			scrollingTexture->resetStatistics ();
 		}
+	}
+}
 
-		idleCounter++;
-		if(idleCounter > 2 * size.getHeight ())
-			idleCounter = 0;
+//////////////////////////////////////////////////////////////////////////////////////////////////
 
-		SceneEdit3D scope (scene, billboard);
-		dynamicTextureMaterial->setTextureFlags (kDiffuseTexture, kTextureMipmapEnabled);
-		dynamicTextureMaterial->setTexture (kDiffuseTexture, UnknownPtr<IBitmap> (dynamicTexture));
+void DemoSceneComponent::updateSphereLOD ()
+{
+	if(!sphereLOD)
+		return;
+
+	UnknownPtr<IModelNode3D> sphereModelNode (findNodeByTag (Tag::kSphereActive));
+	if(!sphereModelNode)
+		return;
+
+	float screenSize = LODModel::getScreenSize (*camera, sphereModelNode->getPosition (), kSphereRadius, kLODViewHeight);
+	bool changed = sphereLOD->selectLevel (screenSize) != sphereLOD->getCurrentLevel ();
+	if(changed)
+	{
+		SceneEdit3D scope (scene, sphereModelNode);
+		sphereLOD->update (*sphereModelNode, screenSize);
+	}
+
+	double now = System::GetProfileTime ();
+	if(changed || now - lastLODReportTime >= FrameStatistics::kUpdateInterval)
+	{
+		lastLODReportTime = now;
+
+		int level = sphereLOD->getCurrentLevel ();
+		String report;
+		report << "level " << level << " of " << sphereLOD->countLevels () << " | " << sphereLOD->getTriangleCount (level)
+			   << " triangles, " << sphereLOD->getTriangleCount (0) << " at full detail | " << int (screenSize) << " px";
+		lodReport->fromString (report);
 	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-void DemoSceneComponent::setNodeNameFromTag (IModelNode3D* node, int tag)
+void DemoSceneComponent::updateCacheReport ()
 {
-	if(IParameter* param = paramList.byTag (tag))
-		node->setNodeName (param->getName ());
+	String report;
+	report << "geometry cache: " << geometryCache->count () << " entries | " << geometryCache->getHits () << " hits, "
+		   << geometryCache->getMisses () << " tessellated";
+	cacheReport->fromString (report);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-ISceneNode3D* DemoSceneComponent::findNodeByTag (int tag)
+void DemoSceneComponent::addNodeWithTag (ISceneNode3D* node, int tag)
 {
 	if(IParameter* param = paramList.byTag (tag))
-		return scene->getChildren ()->findNode (param->getName ());
+		nodeIndex->addNode (*scene, node, param->getName (), tag);
 	else
-		return nullptr;
+		scene->getChildren ()->addNode (node);
+
+	addCulledNode (node, tag);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ISceneNode3D* DemoSceneComponent::findNodeByTag (int tag)
+{
+	return nodeIndex->findNodeByTag (tag);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool DemoSceneComponent::removeNodeWithTag (int tag)
 {
+	// a culled node is attached again first, so it is removed from the scene like the others
+	removeCulledNode (tag);
+
+	bool removed = false;
 	if(AutoPtr<ISceneNode3D> node = findNodeByTag (tag))
-		if(scene->getChildren ()->removeNode (node) == kResultOk)
-			return true;
+	{
+		picker->removeNode (node);
+		removed = nodeIndex->removeNode (*scene, node) == kResultOk;
+	}
 
-	return false;
+	// the node is released now, cached models only it used can go
+	if(removed && geometryCache->purge () > 0)
+		updateCacheReport ();
+	return removed;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -782,6 +1116,495 @@ void DemoSceneComponent::animateScene ()
 	node->addAnimation (ISceneNode3D::kPosition, animation);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::createStressNodes (int count)
+{
+	if(count <= 0)
+		return;
+
+	// one shared low polygon model, its bounds are known without reading the geometry back
+	AutoPtr<IMaterial3D> material = ModelFactory3D::createSolidColorMaterial ({80, 160, 230, 255});
+	AutoPtr<IModel3D> model = ModelFactory3D::createSphere (kStressNodeRadius, 6, 6, material);
+	BoundingBox3D localBounds (PointF3D (-kStressNodeRadius, -kStressNodeRadius, -kStressNodeRadius),
+							   PointF3D (kStressNodeRadius, kStressNodeRadius, kStressNodeRadius));
+
+	uint32 seed = 0x2545F491;
+	auto random = [&seed] (float range)
+	{
+		seed = seed * 1664525 + 1013904223;
+		return (float (seed >> 8) / float (1 << 24) * 2.f - 1.f) * range;
+	};
+
+	stressNodes.setCount (count);
+	for(int i = 0; i < count; i++)
+	{
+		StressNode& stressNode = stressNodes[i];
+		stressNode.node = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
+		stressNode.node->setModelData (model);
+		stressNode.position = PointF3D (random (kStressRange), random (kStressRange), random (kStressRange));
+		stressNode.velocity = PointF3D (random (.02f), random (.02f), random (.02f));
+		stressNode.node->setPosition (stressNode.position);
+
+		BoundingBox3D bounds = localBounds.transformed (PointF3D (1.f, 1.f, 1.f), 0.f, 0.f, 0.f, stressNode.position);
+		stressNode.proxy = cullingTree.insert (bounds, i);
+	}
+	stressFrame = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::removeStressNodes ()
+{
+	for(StressNode& stressNode : stressNodes)
+	{
+		if(stressNode.attached && scene->getChildren ()->removeNode (stressNode.node) == kResultOk)
+			stressNode.node->release ();
+		stressNode.node->release ();
+		cullingTree.remove (stressNode.proxy);
+	}
+	stressNodes.removeAll ();
+	stressReport->fromString (String ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::updateStressTest ()
+{
+	FrameStatistics::Scope frameScope (frameStatistics);
+	SceneEdit3D scope (scene);
+
+	// Move a slice of the nodes each frame, the tree only changes for nodes leaving their margin
+	int count = stressNodes.count ();
+	int moves = ccl_min (kStressMovesPerFrame, count);
+	int reinserted = 0;
+	BoundingBox3D localBounds (PointF3D (-kStressNodeRadius, -kStressNodeRadius, -kStressNodeRadius),
+							   PointF3D (kStressNodeRadius, kStressNodeRadius, kStressNodeRadius));
+	for(int k = 0; k < moves; k++)
+	{
+		StressNode& stressNode = stressNodes[int ((int64 (stressFrame) * moves + k) % count)];
+		float* position[3] = {&stressNode.position.x, &stressNode.position.y, &stressNode.position.z};
+		float* velocity[3] = {&stressNode.velocity.x, &stressNode.velocity.y, &stressNode.velocity.z};
+		for(int axis = 0; axis < 3; axis++)
+		{
+			*position[axis] += *velocity[axis];
+			if(*position[axis] < -kStressRange || *position[axis] > kStressRange)
+				*velocity[axis] = -*velocity[axis];
+		}
+		stressNode.node->setPosition (stressNode.position);
+
+		BoundingBox3D bounds = localBounds.transformed (PointF3D (1.f, 1.f, 1.f), 0.f, 0.f, 0.f, stressNode.position);
+		if(cullingTree.move (stressNode.proxy, bounds))
+			reinserted++;
+	}
+
+	DynamicBVH::QueryStatistics queryStatistics;
+	bool culling = paramList.byTag (Tag::kStressCulling)->getValue ().asBool ();
+	cullNodes (queryStatistics, culling);
+
+	double now = System::GetProfileTime ();
+	if(now - lastStressReportTime >= FrameStatistics::kUpdateInterval)
+	{
+		lastStressReportTime = now;
+
+		String report;
+		int total = count + culledSceneNodes.count ();
+		report << "visible " << visibleNodes.count () << " / culled " << (total - visibleNodes.count ());
+		if(culling)
+			report << " | tree height " << cullingTree.getHeight () << ", " << queryStatistics.visitedNodes << " boxes tested, "
+				   << queryStatistics.acceptedSubtrees << " subtrees inside";
+		report << " | " << reinserted << " of " << moves << " moved nodes reinserted";
+		stressReport->fromString (report);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DemoSceneComponent::getLocalBounds (BoundingBox3D& bounds, bool& billboard, int tag)
+{
+	billboard = false;
+	switch(tag)
+	{
+	case Tag::kGridNodeActive :
+		// cells from the origin along x and z
+		bounds = BoundingBox3D (PointF3D (0.f, -.01f, 0.f), PointF3D (5.f, .01f, 5.f));
+		return true;
+
+	case Tag::kTeapotNodeActive :
+		// same file as the "DemoModel" resource
+		if(!loadInstanceSource ())
+			return false;
+		bounds = BoundingBox3D (instanceSource.boundsMin, instanceSource.boundsMax);
+		return true;
+
+	case Tag::kOutlineCubeActive :
+	case Tag::kTransparentCubeActive :
+		bounds = BoundingBox3D (PointF3D (-1.f, -1.f, -1.f), PointF3D (1.f, 1.f, 1.f));
+		return true;
+
+	case Tag::kSphereActive :
+		bounds = BoundingBox3D (PointF3D (-kSphereRadius, -kSphereRadius, -kSphereRadius), PointF3D (kSphereRadius, kSphereRadius, kSphereRadius));
+		return true;
+
+	case Tag::kBillboardActive :
+	case Tag::kTextBillboardActive :
+		// the unit quad in any orientation
+		billboard = true;
+		bounds = BoundingBox3D (PointF3D (-.71f, -.71f, -.71f), PointF3D (.71f, .71f, .71f));
+		return true;
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+BoundingBox3D DemoSceneComponent::getWorldBounds (const CulledSceneNode& entry) const
+{
+	ISceneNode3D* node = entry.node;
+	if(entry.billboard)
+	{
+		float size = ccl_max (node->getScaleX (), node->getScaleY ());
+		return entry.localBounds.transformed (PointF3D (size, size, size), 0.f, 0.f, 0.f, node->getPosition ());
+	}
+	return entry.localBounds.transformed (PointF3D (node->getScaleX (), node->getScaleY (), node->getScaleZ ()),
+										  node->getYawAngle (), node->getPitchAngle (), node->getRollAngle (), node->getPosition ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::addCulledNode (ISceneNode3D* node, int tag)
+{
+	CulledSceneNode entry;
+	if(!getLocalBounds (entry.localBounds, entry.billboard, tag))
+		return;
+
+	entry.node = node;
+	entry.tag = tag;
+	entry.proxy = cullingTree.insert (getWorldBounds (entry), -tag);
+	culledSceneNodes.add (entry);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::removeCulledNode (int tag)
+{
+	for(int i = 0; i < culledSceneNodes.count (); i++)
+		if(culledSceneNodes[i].tag == tag)
+		{
+			CulledSceneNode& entry = culledSceneNodes[i];
+			if(entry.detached)
+				scene->getChildren ()->addNode (entry.node);
+			cullingTree.remove (entry.proxy);
+			culledSceneNodes.removeAt (i);
+			return;
+		}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::cullNodes (DynamicBVH::QueryStatistics& queryStatistics, bool culling)
+{
+	// Demo nodes move by animations and parameters, refitting them is free while they stay in their margin
+	for(CulledSceneNode& entry : culledSceneNodes)
+		cullingTree.move (entry.proxy, getWorldBounds (entry));
+
+	// Collect the visible nodes, stress nodes by index, demo nodes by -tag
+	visibleNodes.removeAll ();
+	if(culling)
+	{
+		Frustum3D frustum = Frustum3D::fromCamera (camera->getPosition (), camera->getYawAngle (), camera->getPitchAngle (), camera->getRollAngle (),
+												   camera->getFieldOfViewAngle (), kCullingAspectRatio, kCullingNearDistance);
+		cullingTree.query (visibleNodes, frustum, &queryStatistics);
+	}
+	else
+	{
+		for(int i = 0; i < stressNodes.count (); i++)
+			visibleNodes.add (i);
+		for(const CulledSceneNode& entry : culledSceneNodes)
+			visibleNodes.add (-entry.tag);
+	}
+
+	// Attach newly visible nodes and detach the others
+	stressFrame++;
+	for(int index : visibleNodes)
+	{
+		if(index < 0)
+		{
+			for(CulledSceneNode& entry : culledSceneNodes)
+				if(entry.tag == -index)
+				{
+					entry.visibleFrame = stressFrame;
+					if(entry.detached)
+					{
+						scene->getChildren ()->addNode (entry.node);
+						entry.detached = false;
+					}
+				}
+			continue;
+		}
+
+		StressNode& stressNode = stressNodes[index];
+		stressNode.visibleFrame = stressFrame;
+		if(!stressNode.attached)
+		{
+			stressNode.node->retain ();
+			scene->getChildren ()->addNode (stressNode.node);
+			stressNode.attached = true;
+		}
+	}
+
+	for(StressNode& stressNode : stressNodes)
+		if(stressNode.attached && stressNode.visibleFrame != stressFrame)
+		{
+			if(scene->getChildren ()->removeNode (stressNode.node) == kResultOk)
+				stressNode.node->release ();
+			stressNode.attached = false;
+		}
+
+	// the reference of the scene moves to the entry while detached
+	for(CulledSceneNode& entry : culledSceneNodes)
+		if(!entry.detached && entry.visibleFrame != stressFrame)
+			entry.detached = scene->getChildren ()->removeNode (entry.node) == kResultOk;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DemoSceneComponent::loadInstanceSource ()
+{
+	if(!instanceSource.isEmpty ())
+		return true;
+
+	// same file as the "DemoModel" resource of the skin
+	Url modelPath;
+	GET_DEVELOPMENT_FOLDER_LOCATION (modelPath, CCL_APPLICATIONS_DIRECTORY, "ccldemo/skin")
+	modelPath.descend ("3d/demo.obj");
+
+	ObjImporter importer;
+	return importer.import (instanceSource, modelPath);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::updateInstances (int mode)
+{
+	for(ISceneNode3D* node : instanceNodes)
+	{
+		picker->removeNode (node);
+		if(nodeIndex->removeNode (*scene, node) == kResultOk)
+			node->release ();
+	}
+	instanceNodes.removeAll ();
+	picker->removeMesh (instanceBaked);
+	instanceBaked.removeAll ();
+	instancesReport->fromString (String ());
+
+	if(mode == kInstancesOff)
+		return;
+
+	// same file as the "DemoModel" resource of the skin, the model itself can't be read back
+	Url modelPath;
+	GET_DEVELOPMENT_FOLDER_LOCATION (modelPath, CCL_APPLICATIONS_DIRECTORY, "ccldemo/skin")
+	modelPath.descend ("3d/demo.obj");
+	Url folder (modelPath);
+	folder.ascend ();
+
+	if(!loadInstanceSource ())
+	{
+		instancesReport->fromString ("Demo model not found.");
+		return;
+	}
+
+	// Grid of copies above the scene, scaled to fit their cell
+	static const float kPalette[][3] =
+	{
+		{1.f, .4f, .4f}, {.4f, 1.f, .4f}, {.4f, .4f, 1.f}, {1.f, 1.f, .4f},
+		{1.f, .4f, 1.f}, {.4f, 1.f, 1.f}, {1.f, .7f, .3f}, {1.f, 1.f, 1.f}
+	};
+	static constexpr int kPaletteSize = ARRAY_COUNT (kPalette);
+
+	PointF3D size (instanceSource.boundsMax.x - instanceSource.boundsMin.x, instanceSource.boundsMax.y - instanceSource.boundsMin.y,
+				   instanceSource.boundsMax.z - instanceSource.boundsMin.z);
+	float scale = kInstanceSpacing * .7f / ccl_max (ccl_max (size.x, size.y), ccl_max (size.z, .001f));
+
+	InstancedModel instancedModel;
+	instancedModel.setSource (&instanceSource);
+	for(int z = 0; z < kInstanceGridSize; z++)
+		for(int y = 0; y < kInstanceGridSize; y++)
+			for(int x = 0; x < kInstanceGridSize; x++)
+			{
+				float offset = (kInstanceGridSize - 1) * kInstanceSpacing * .5f;
+				InstancedModel::Instance instance;
+				instance.position = PointF3D (x * kInstanceSpacing - offset, y * kInstanceSpacing + 3.f, z * kInstanceSpacing - offset);
+				instance.scale = PointF3D (scale, scale, scale);
+				instance.yaw = .7f * instancedModel.instances.count ();
+				const float* color = kPalette[instancedModel.instances.count () % kPaletteSize];
+				for(int c = 0; c < 3; c++)
+					instance.color[c] = color[c];
+				instancedModel.instances.add (instance);
+			}
+
+	int instanceCount = instancedModel.instances.count ();
+	int groupsPerModel = ccl_max (1, instanceSource.groups.count ());
+	double startTime = System::GetProfileTime ();
+	String report;
+
+	if(mode == kInstancesAsNodes)
+	{
+		// one model per color, shared by the nodes using it
+		AutoPtr<IModel3D> colorModels[kPaletteSize];
+		InstancedModel single;
+		single.setSource (&instanceSource);
+		single.instances.setCount (1);
+		for(int p = 0; p < kPaletteSize; p++)
+		{
+			for(int c = 0; c < 3; c++)
+				single.instances[0].color[c] = kPalette[p][c];
+			colorModels[p] = single.createModel (folder);
+		}
+
+		for(int i = 0; i < instanceCount; i++)
+		{
+			const InstancedModel::Instance& instance = instancedModel.instances[i];
+			auto* node = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
+			node->setModelData (colorModels[i % kPaletteSize]);
+			node->setPosition (instance.position);
+			node->setScaleX (scale);
+			node->setScaleY (scale);
+			node->setScaleZ (scale);
+			node->setYawAngle (instance.yaw);
+			scene->getChildren ()->addNode (node);
+			instanceNodes.add (node);
+
+			ScenePicker::Placement placement;
+			placement.position = instance.position;
+			placement.scale = instance.scale;
+			placement.yaw = instance.yaw;
+			picker->addNode (node, instanceSource, placement);
+		}
+
+		report << instanceCount << " nodes, " << (instanceCount * groupsPerModel) << " draws";
+	}
+	else
+	{
+		// the baked mesh is kept for picking
+		if(!instancedModel.bake (instanceBaked))
+			return;
+		double bakeMs = (System::GetProfileTime () - startTime) * 1000.;
+
+		// turn every 100th copy, only those are transformed again
+		double updateStart = System::GetProfileTime ();
+		int changedCount = 0;
+		for(int i = 0; i < instanceCount; i += 100, changedCount++)
+		{
+			instancedModel.instances[i].yaw += 1.f;
+			instancedModel.invalidate (i);
+		}
+		if(!instancedModel.update (instanceBaked))
+			return;
+		double updateMs = (System::GetProfileTime () - updateStart) * 1000.;
+
+		AutoPtr<IModel3D> model = instanceBaked.createModel (folder);
+		if(!model)
+			return;
+
+		auto* node = ccl_new<IModelNode3D> (ClassID::ModelNode3D);
+		node->setModelData (model);
+		nodeIndex->addNode (*scene, node, "instances");
+		instanceNodes.add (node);
+		picker->addNode (node, instanceBaked, ScenePicker::Placement ());
+
+		report << instanceCount << " instances baked on the CPU into 1 node, " << instanceBaked.groups.count () << " draws, "
+			   << (instanceCount * instanceSource.getVertexCount ()) << " vertices | bake ";
+		report.appendFloatValue (bakeMs, 1);
+		report << " ms, " << changedCount << " changed ";
+		report.appendFloatValue (updateMs, 2);
+		report << " ms";
+	}
+
+	report << " | setup " << int ((System::GetProfileTime () - startTime) * 1000.) << " ms";
+	instancesReport->fromString (report);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DemoSceneComponent::runSoftwareBenchmark ()
+{
+	Url skinFolder;
+	GET_DEVELOPMENT_FOLDER_LOCATION (skinFolder, CCL_APPLICATIONS_DIRECTORY, "ccldemo/skin")
+	SoftwareScene softwareScene;
+	if(!softwareScene.load (skinFolder))
+	{
+		softwareReport->fromString ("Demo model or textures not found.");
+		return;
+	}
+
+	// All demo nodes where they are placed, the instances if baked and the triangle of the user
+	// view in front, lit by the directional light of the scene which shines along its -z axis
+	SoftwareRasterizer rasterizer;
+	rasterizer.setCamera (*camera);
+	RotationMatrix3D lightRotation (directionalLight->getYawAngle (), directionalLight->getPitchAngle (), directionalLight->getRollAngle ());
+	rasterizer.setLight (lightRotation * PointF3D (0.f, 0.f, -1.f), .25f);
+	rasterizer.setClearColor (.1f, .1f, .12f);
+
+	softwareScene.addOpaque (rasterizer);
+	if(!instanceBaked.isEmpty ())
+		rasterizer.addMesh (instanceBaked, SoftwareRasterizer::Placement ());
+	softwareScene.addBlended (rasterizer, *camera);
+
+	SoftwareRasterizer::Material triangleMaterial;
+	triangleMaterial.color[0] = 1.f;
+	triangleMaterial.color[1] = 0.f;
+	triangleMaterial.color[2] = 0.f;
+	triangleMaterial.color[3] = 50.f / 255.f;
+	triangleMaterial.cullBackFaces = false;
+	SoftwareRasterizer::Placement trianglePlacement;
+	trianglePlacement.position = PointF3D (0.f, 1.f, 1.f);
+	rasterizer.addTriangles (DemoContent3D::kVertices, sizeof(VertexP), ARRAY_COUNT (DemoContent3D::kVertices), triangleMaterial, trianglePlacement);
+
+	// Best of several frames per configuration, each including the copy into a bitmap
+	AutoPtr<IImage> frame = GraphicsFactory::createBitmap (kSoftwareRenderWidth, kSoftwareRenderHeight, IBitmap::kRGBAlpha);
+	UnknownPtr<IBitmap> bitmap (frame);
+
+	struct Configuration { int threads; int samples; double bestMs; SoftwareRasterizer::Statistics statistics; };
+	int threadCount = WorkerPool::getHardwareThreadCount ();
+	Configuration configurations[] = {{1, 1, 0.}, {threadCount, 1, 0.}, {threadCount, 4, 0.}};
+	for(Configuration& configuration : configurations)
+	{
+		rasterizer.setThreadCount (configuration.threads);
+		rasterizer.setup (kSoftwareRenderWidth, kSoftwareRenderHeight, configuration.samples);
+		configuration.bestMs = HUGE_VAL;
+		for(int i = 0; i < kSoftwareRenderFrames; i++)
+		{
+			double startTime = System::GetProfileTime ();
+			rasterizer.render ();
+			if(bitmap)
+				rasterizer.copyTo (*bitmap);
+			configuration.bestMs = ccl_min (configuration.bestMs, (System::GetProfileTime () - startTime) * 1000.);
+		}
+		configuration.statistics = rasterizer.getStatistics ();
+	}
+
+	const SoftwareRasterizer::Statistics& statistics = configurations[2].statistics;
+	String report;
+	report << kSoftwareRenderWidth << "x" << kSoftwareRenderHeight << ", " << statistics.triangles << " triangles, "
+		   << statistics.rasterized << " drawn in " << statistics.tiles << " tiles";
+	for(const Configuration& configuration : configurations)
+	{
+		report << " | " << configuration.threads << (configuration.threads == 1 ? " thread " : " threads ")
+			   << configuration.samples << "x ";
+		report.appendFloatValue (configuration.bestMs, 1);
+		report << " ms";
+	}
+	report << " (vertex ";
+	report.appendFloatValue (statistics.vertexMs, 1);
+	report << ", bin ";
+	report.appendFloatValue (statistics.binMs, 1);
+	report << ", raster ";
+	report.appendFloatValue (statistics.rasterMs, 1);
+	report << " ms)";
+	softwareReport->fromString (report);
+}
+
 //************************************************************************************************
 // Graphics3DDemo
 //************************************************************************************************
@@ -793,6 +1616,11 @@ public:
 	
 	// Component
 	IView* CCL_API createView (StringID name, VariantRef data, const Rect& bounds) override;
+	tbool CCL_API paramChanged (IParameter* param) override;
+
+protected:
+	IParameter* importReport;
+	IParameter* optimizerReport;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -803,6 +1631,10 @@ Graphics3DDemo::Graphics3DDemo ()
 
 	paramList.addParam ("user3D", Tag::kUserView3DActive);
 	paramList.addParam ("animate", Tag::kAnimate);
+	paramList.addParam ("benchmarkImport", Tag::kBenchmarkImport);
+	importReport = paramList.addString ("importReport");
+	paramList.addParam ("benchmarkOptimizer", Tag::kBenchmarkOptimizer);
+	optimizerReport = paramList.addString ("optimizerReport");
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -820,4 +1652,33 @@ IView* CCL_API Graphics3DDemo::createView (StringID name, VariantRef data, const
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
+tbool CCL_API Graphics3DDemo::paramChanged (IParameter* param)
+{
+	if(param->getTag () == Tag::kBenchmarkImport || param->getTag () == Tag::kBenchmarkOptimizer)
+	{
+		// same file as the "DemoModel" resource of the skin
+		Url modelPath;
+		GET_DEVELOPMENT_FOLDER_LOCATION (modelPath, CCL_APPLICATIONS_DIRECTORY, "ccldemo/skin")
+		modelPath.descend ("3d/demo.obj");
+
+		if(param->getTag () == Tag::kBenchmarkImport)
+			importReport->fromString (ObjImporter::runBenchmark (modelPath));
+		else
+		{
+			// the mesh as parsed, in file order, including every optional step
+			ObjImporter importer;
+			importer.setOptimizing (false);
+			MeshData mesh;
+			if(importer.parse (mesh, modelPath))
+				optimizerReport->fromString (MeshOptimizer::runBenchmark (mesh, MeshOptimizer::kDefaultSteps|MeshOptimizer::kQuantize));
+			else
+				optimizerReport->fromString ("Demo model not found.");
+		}
+		return true;
+	}
+	return DemoComponent::paramChanged (param);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
 REGISTER_DEMO ("Graphics", "Graphics 3D", Graphics3DDemo)
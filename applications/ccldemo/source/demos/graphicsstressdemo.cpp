@@ -0,0 +1,481 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : graphicsstressdemo.cpp
+// Description : Graphics Stress Test Demo
+//
+//************************************************************************************************
+
+#include "../demoitem.h"
+#include "../graphics/framestatistics.h"
+#include "../graphics/graphicscapture.h"
+
+#include "ccl/app/controls/usercontrol.h"
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/gui/iparameter.h"
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/framework/itimer.h"
+#include "ccl/public/gui/framework/itheme.h"
+#include "ccl/public/gui/framework/iuserinterface.h"
+
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/inativefilesystem.h"
+
+#include "ccl/public/systemservices.h"
+#include "ccl/public/guiservices.h"
+
+#if CCL_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace StressTest
+{
+	/** CPU time of the calling thread in seconds. std::clock () can't be used, it returns the
+		wall time on Windows and the time of all threads of the process elsewhere. Windows
+		updates thread times with the scheduler tick, only averages over many frames are exact. */
+	static double getThreadCpuTime ()
+	{
+		#if CCL_PLATFORM_WINDOWS
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if(!::GetThreadTimes (::GetCurrentThread (), &creationTime, &exitTime, &kernelTime, &userTime))
+			return 0.;
+		auto toSeconds = [] (const FILETIME& t) { return double ((uint64 (t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7; };
+		return toSeconds (kernelTime) + toSeconds (userTime);
+		#else
+		timespec threadTime;
+		if(::clock_gettime (CLOCK_THREAD_CPUTIME_ID, &threadTime) != 0)
+			return 0.;
+		return double (threadTime.tv_sec) + double (threadTime.tv_nsec) * 1e-9;
+		#endif
+	}
+}
+
+using namespace StressTest;
+
+//************************************************************************************************
+// StressTestView
+/** Draws a configurable number of primitives of one type on every idle timer tick and
+	reports throughput and CPU time, frame times go to the shared frame statistics HUD.
+	A frame requested for capture is drawn through a GraphicsRecorder and saved for offline
+	replay, it is left out of the statistics. Settings are read from the parameters of the
+	demo component before each frame. */
+//************************************************************************************************
+
+class StressTestView: public UserControl,
+					  public ITimerTask
+{
+public:
+	enum PrimitiveType
+	{
+		kRects,
+		kPaths,
+		kText,
+		kImages,
+		kGradients,
+
+		kNumPrimitiveTypes
+	};
+
+	static constexpr int kMaxPrimitives = 1000000;
+
+	struct Settings
+	{
+		SharedPtr<IParameter> primitiveType;
+		SharedPtr<IParameter> primitiveCount;
+		SharedPtr<IParameter> antiAlias;
+		SharedPtr<IParameter> transform;
+		SharedPtr<IParameter> clipping;
+		SharedPtr<IParameter> throughput;
+		SharedPtr<FrameStatistics> frameStatistics;
+		SharedPtr<GraphicsCapture> capture;
+		SharedPtr<IParameter> captureResults;
+	};
+
+	static constexpr CStringPtr kCaptureName = "stress";
+
+	StressTestView (RectRef size, const Settings& settings)
+	: UserControl (size),
+	  settings (settings),
+	  primitiveType (kRects),
+	  primitiveCount (0),
+	  antiAlias (false),
+	  transformed (false),
+	  clipped (false),
+	  sceneCount (-1),
+	  cpuSum (0.),
+	  cpuFrames (0),
+	  lastReportTime (0.),
+	  font (getTheme ().getStatics ().getStandardFont ())
+	{
+		testImage = getTheme ().getImage (kTestImageName);
+		System::GetGUI ().addIdleTask (this);
+	}
+
+	~StressTestView ()
+	{
+		System::GetGUI ().removeIdleTask (this);
+	}
+
+	// UserControl
+	void draw (const DrawEvent& event) override
+	{
+		Rect clientRect;
+		getClientRect (clientRect);
+		updateSettings ();
+		prepareScene (clientRect);
+
+		GraphicsCapture* capture = settings.capture;
+		if(capture && capture->isPending ())
+		{
+			capture->removeAll ();
+			capture->setWidth (clientRect.getWidth ());
+			capture->setHeight (clientRect.getHeight ());
+
+			AutoPtr<GraphicsRecorder> recorder = NEW GraphicsRecorder (event.graphics, capture);
+			drawFrame (*recorder, clientRect);
+			finishCapture (*capture, clientRect);
+			return;
+		}
+
+		// measured frames draw directly, without the recorder in between
+		double cpuStart = getThreadCpuTime ();
+		double startTime = System::GetProfileTime ();
+
+		drawFrame (event.graphics, clientRect);
+
+		double ms = (System::GetProfileTime () - startTime) * 1000.;
+		double cpuMs = (getThreadCpuTime () - cpuStart) * 1000.;
+		addFrame (ms, cpuMs);
+	}
+
+	// ITimerTask
+	void CCL_API onTimer (ITimer* timer) override
+	{
+		updateClient ();
+	}
+
+	CLASS_INTERFACE (ITimerTask, UserControl)
+
+protected:
+	static constexpr double kReportInterval = .25;
+	static constexpr CStringPtr kTestImageName = "CompositionDemo";
+
+	Settings settings;
+	int primitiveType;
+	int primitiveCount;
+	bool antiAlias;
+	bool transformed;
+	bool clipped;
+	SharedPtr<IImage> testImage;
+	Font font;
+
+	Vector<RectF> rects;
+	Vector<Color> colors;
+	int sceneCount;
+	Rect sceneBounds;
+
+	double cpuSum;
+	int cpuFrames;
+	double lastReportTime;
+
+	void updateSettings ()
+	{
+		int newType = settings.primitiveType->getValue ().asInt ();
+		int newCount = settings.primitiveCount->getValue ().asInt ();
+		bool newAntiAlias = settings.antiAlias->getValue ().asBool ();
+		bool newTransformed = settings.transform->getValue ().asBool ();
+		bool newClipped = settings.clipping->getValue ().asBool ();
+
+		if(newType != primitiveType || newCount != primitiveCount || newAntiAlias != antiAlias || newTransformed != transformed || newClipped != clipped)
+		{
+			// statistics of different settings must not be mixed
+			if(settings.frameStatistics)
+				settings.frameStatistics->reset ();
+			cpuSum = 0.;
+			cpuFrames = 0;
+		}
+
+		primitiveType = newType;
+		primitiveCount = ccl_bound (newCount, 1, kMaxPrimitives);
+		antiAlias = newAntiAlias;
+		transformed = newTransformed;
+		clipped = newClipped;
+	}
+
+	void prepareScene (RectRef bounds)
+	{
+		if(sceneCount == primitiveCount && sceneBounds == bounds)
+			return;
+
+		sceneCount = primitiveCount;
+		sceneBounds = bounds;
+		rects.removeAll ();
+		colors.removeAll ();
+		rects.resize (sceneCount);
+		colors.resize (sceneCount);
+
+		// fixed seed, so runs with the same settings are comparable
+		uint32 seed = 0x2545F491;
+		auto random = [&seed] ()
+		{
+			seed = seed * 1664525 + 1013904223;
+			return float (seed >> 8) / float (1 << 24);
+		};
+
+		CoordF primitiveSize = ccl_bound<CoordF> (CoordF (bounds.getWidth ()) / 20.f, 8.f, 64.f);
+		for(int i = 0; i < sceneCount; i++)
+		{
+			PointF p (bounds.left + random () * (bounds.getWidth () - primitiveSize), bounds.top + random () * (bounds.getHeight () - primitiveSize));
+			CoordF w = primitiveSize * (.25f + .75f * random ());
+			CoordF h = primitiveSize * (.25f + .75f * random ());
+			rects.add (RectF (p.x, p.y, PointF (w, h)));
+			colors.add (Color (uint8 (random () * 255), uint8 (random () * 255), uint8 (random () * 255), 192));
+		}
+	}
+
+	void finishCapture (GraphicsCapture& capture, RectRef clientRect)
+	{
+		capture.setPending (false);
+
+		String s;
+		Url path;
+		if(!capture.isComplete ())
+			s << "Capture failed, calls can't be recorded: " << capture.getUnrecordedCalls ();
+		else
+		{
+			s << "Captured " << capture.getCommandCount () << " calls (" << capture.getByteSize () / 1024 << " KB)";
+			if(GraphicsCapture::getCapturePath (path, kCaptureName) && capture.save (path))
+				s << ", saved to " << UrlFullString (path);
+			else
+				s << ", saving failed";
+		}
+		if(settings.captureResults)
+			settings.captureResults->fromString (s);
+	}
+
+	// shapes with recordable replacements, see GraphicsRecorder
+	static void addClipEllipse (IGraphics& graphics, RectFRef rect) { GraphicsRecorder::addClipEllipse (graphics, rect); }
+	static void addClipEllipse (GraphicsRecorder& recorder, RectFRef rect) { recorder.addClipEllipse (rect); }
+	static void fillPolygon (IGraphics& graphics, const PointF points[], int count, ColorRef color) { GraphicsRecorder::fillPolygon (graphics, points, count, color); }
+	static void fillPolygon (GraphicsRecorder& recorder, const PointF points[], int count, ColorRef color) { recorder.fillPolygon (points, count, color); }
+	static void fillGradientRect (IGraphics& graphics, RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2) { GraphicsRecorder::fillGradientRect (graphics, rect, start, end, color1, color2); }
+	static void fillGradientRect (GraphicsRecorder& recorder, RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2) { recorder.fillGradientRect (rect, start, end, color1, color2); }
+
+	/** Graphics is IGraphics or GraphicsRecorder. */
+	template<class Graphics>
+	void drawFrame (Graphics& graphics, RectRef clientRect)
+	{
+		graphics.fillRect (clientRect, SolidBrush (Colors::kWhite));
+		graphics.saveState ();
+
+		if(clipped)
+		{
+			// elliptic clip, so the backend can't reduce it to a scissor rect
+			RectF clipRect = rectIntToF (clientRect);
+			clipRect.contract (clientRect.getWidth () * .1f, clientRect.getHeight () * .1f);
+			addClipEllipse (graphics, clipRect);
+		}
+
+		if(transformed)
+		{
+			CoordF centerX = clientRect.getWidth () * .5f;
+			CoordF centerY = clientRect.getHeight () * .5f;
+			graphics.addTransform (Transform ().translate (centerX, centerY).rotate (.2f).scale (.8f, .8f).translate (-centerX, -centerY));
+		}
+
+		if(antiAlias)
+		{
+			AntiAliasSetter smoother (graphics);
+			drawPrimitives (graphics);
+		}
+		else
+			drawPrimitives (graphics);
+
+		graphics.restoreState ();
+	}
+
+	template<class Graphics>
+	void drawPrimitives (Graphics& graphics)
+	{
+		int count = rects.count ();
+		switch(primitiveType)
+		{
+		case kRects :
+			for(int i = 0; i < count; i++)
+				graphics.fillRect (rects[i], SolidBrush (colors[i]));
+			break;
+
+		case kPaths :
+			for(int i = 0; i < count; i++)
+			{
+				RectFRef r = rects[i];
+				PointF triangle[3] = {PointF (r.getCenter ().x, r.top), r.getRightBottom (), r.getLeftBottom ()};
+				fillPolygon (graphics, triangle, 3, colors[i]);
+			}
+			break;
+
+		case kText :
+			{
+				String text (CCLSTR ("Text"));
+				for(int i = 0; i < count; i++)
+					graphics.drawString (rects[i], text, font, SolidBrush (colors[i]), Alignment::kLeftTop);
+			}
+			break;
+
+		case kImages :
+			if(testImage)
+			{
+				Rect src (0, 0, testImage->getWidth (), testImage->getHeight ());
+				for(int i = 0; i < count; i++)
+				{
+					RectFRef r = rects[i];
+					graphics.drawImage (testImage, src, Rect (Coord (r.left), Coord (r.top), Coord (r.right) + 1, Coord (r.bottom) + 1), nullptr);
+				}
+			}
+			break;
+
+		case kGradients :
+			for(int i = 0; i < count; i++)
+			{
+				RectFRef r = rects[i];
+				fillGradientRect (graphics, r, r.getLeftTop (), r.getRightBottom (), colors[i], Colors::kWhite);
+			}
+			break;
+		}
+	}
+
+	void addFrame (double ms, double cpuMs)
+	{
+		if(settings.frameStatistics)
+			settings.frameStatistics->addFrame (ms);
+		cpuSum += cpuMs;
+		cpuFrames++;
+
+		// reporting every frame would cause extra redraws of the text boxes
+		double now = System::GetProfileTime ();
+		if(now - lastReportTime < kReportInterval)
+			return;
+		lastReportTime = now;
+
+		if(settings.throughput)
+		{
+			double average = settings.frameStatistics ? settings.frameStatistics->getAverage () : ms;
+			String s;
+			s.appendFloatValue (average > 0. ? rects.count () / average / 1000. : 0., 2);
+			s << "M primitives/s / CPU ";
+			s.appendFloatValue (cpuSum / cpuFrames, 2);
+			s << "ms per frame";
+			settings.throughput->fromString (s);
+		}
+		cpuSum = 0.;
+		cpuFrames = 0;
+	}
+};
+
+//************************************************************************************************
+// GraphicsStressDemo
+//************************************************************************************************
+
+class GraphicsStressDemo: public DemoComponent
+{
+public:
+	GraphicsStressDemo ()
+	: capture (NEW GraphicsCapture)
+	{
+		UnknownPtr<IListParameter> typeList (paramList.addList ("primitiveType"));
+		typeList->appendString (CCLSTR ("Rects"));
+		typeList->appendString (CCLSTR ("Paths"));
+		typeList->appendString (CCLSTR ("Text"));
+		typeList->appendString (CCLSTR ("Images"));
+		typeList->appendString (CCLSTR ("Gradients"));
+		settings.primitiveType = typeList;
+
+		settings.primitiveCount = paramList.addInteger (1, StressTestView::kMaxPrimitives, "primitiveCount");
+		settings.primitiveCount->setValue (1000);
+		settings.antiAlias = paramList.addParam ("antiAlias");
+		settings.transform = paramList.addParam ("transform");
+		settings.clipping = paramList.addParam ("clipping");
+		settings.throughput = paramList.addString ("throughput");
+		settings.frameStatistics = NEW FrameStatistics;
+		addComponent (settings.frameStatistics);
+
+		settings.capture = capture;
+		settings.captureResults = paramList.addString ("captureResults");
+		captureFrame = paramList.addParam ("captureFrame");
+		replayCapture = paramList.addParam ("replayCapture");
+		capturePage = paramList.addParam ("capturePage");
+
+		// result of a page capture armed on an earlier visit
+		if(!PageCapture::instance ().getLastResult ().isEmpty ())
+			settings.captureResults->fromString (PageCapture::instance ().getLastResult ());
+	}
+
+	// Component
+	IView* CCL_API createView (StringID name, VariantRef data, const Rect& bounds) override
+	{
+		if(name == "StressTestView")
+			return *NEW StressTestView (bounds, settings);
+		return nullptr;
+	}
+
+	tbool CCL_API paramChanged (IParameter* param) override
+	{
+		if(param == captureFrame)
+		{
+			// the view records its next frame
+			settings.capture->setPending (true);
+			settings.captureResults->fromString (CCLSTR ("Capturing next frame..."));
+			return true;
+		}
+		if(param == replayCapture)
+		{
+			// replay from the file, like an offline profiling run would
+			Url path;
+			AutoPtr<GraphicsCapture> loaded = NEW GraphicsCapture;
+			if(!GraphicsCapture::getCapturePath (path, StressTestView::kCaptureName) || !loaded->load (path))
+				settings.captureResults->fromString (CCLSTR ("No capture found, capture a frame first"));
+			else
+				settings.captureResults->fromString (loaded->profile ());
+			return true;
+		}
+		if(param == capturePage)
+		{
+			PageCapture::instance ().setArmed (true);
+			settings.captureResults->fromString (CCLSTR ("Open a demo page, its first frame is saved to the Captures folder"));
+			return true;
+		}
+		return DemoComponent::paramChanged (param);
+	}
+
+protected:
+	StressTestView::Settings settings;
+	AutoPtr<GraphicsCapture> capture;
+	IParameter* captureFrame;
+	IParameter* replayCapture;
+	IParameter* capturePage;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+REGISTER_DEMO ("Graphics", "Graphics Stress", GraphicsStressDemo)
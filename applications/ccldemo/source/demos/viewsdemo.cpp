@@ -19,71 +19,169 @@
 //************************************************************************************************
 
 #include "../demoitem.h"
+#include "../graphics/scaledimagecache.h"
+#include "../graphics/transformedlayer.h"
 
 #include "ccl/app/controls/usercontrol.h"
 
+#include "ccl/base/message.h"
+
 #include "ccl/public/gui/iparameter.h"
 #include "ccl/public/gui/graphics/igraphics.h"
 #include "ccl/public/gui/framework/iskinmodel.h"
 #include "ccl/public/gui/framework/itheme.h"
+#include "ccl/public/gui/framework/iwindow.h"
+#include "ccl/public/gui/framework/icolorscheme.h"
+#include "ccl/public/math/mathprimitives.h"
+#include "ccl/public/plugservices.h"
 
 using namespace CCL;
 
 //************************************************************************************************
 // TransformTest
+/** Static content under an outer scale (simulating window scaling) and an adjustable rotation.
+	With the layer enabled the content is rasterized once and only the bitmap is transformed,
+	until the color scheme changes or the view is attached again. */
 //************************************************************************************************
 
-class TransformTest: public UserControl
+class TransformTest: public UserControl,
+					 public LayerContent
 {
 public:
 	float scaleFactor;
 	
-	TransformTest (RectRef size, float scaleFactor = 1.f)
+	TransformTest (RectRef size, float scaleFactor = 1.f, IParameter* angle = nullptr, IParameter* layerEnabled = nullptr)
 	: UserControl (size),
-	  scaleFactor (scaleFactor)
+	  scaleFactor (scaleFactor),
+	  angle (angle),
+	  layerEnabled (layerEnabled)
 	{
 		testImage = getTheme ().getImage ("TransformTestImage");
+		if(angle)
+			ISubject::addObserver (angle, this);
+		if(layerEnabled)
+			ISubject::addObserver (layerEnabled, this);
+
+		AutoPtr<IColorSchemes> colorSchemes = ccl_new<IColorSchemes> (ClassID::ColorSchemes);
+		if(colorSchemes)
+			colorScheme = colorSchemes->getScheme (ThemeNames::kMain);
+		if(colorScheme)
+			ISubject::addObserver (colorScheme, this);
+	}
+
+	~TransformTest ()
+	{
+		if(angle)
+			ISubject::removeObserver (angle, this);
+		if(layerEnabled)
+			ISubject::removeObserver (layerEnabled, this);
+		if(colorScheme)
+			ISubject::removeObserver (colorScheme, this);
+	}
+
+	// UserControl
+	void notify (ISubject* subject, MessageRef msg) override
+	{
+		if(msg == kChanged && isEqualUnknown (colorScheme, subject))
+		{
+			// theme colors and images are part of the rasterized content
+			layer.invalidate ();
+			updateClient ();
+		}
+		else if(msg == kChanged && (isEqualUnknown (angle, subject) || isEqualUnknown (layerEnabled, subject)))
+			updateClient (); // only the transform changes, the layer stays valid
+		else
+			UserControl::notify (subject, msg);
+	}
+
+	void attached (IView* parent) override
+	{
+		UserControl::attached (parent);
+
+		// the theme of the new parent may provide different content
+		testImage = getTheme ().getImage ("TransformTestImage");
+		layer.invalidate ();
 	}
 	
 	void draw (const DrawEvent& event) override
 	{
 		IGraphics& graphics (event.graphics);
-		AntiAliasSetter smoother (graphics);
 
 		Rect client;
 		getClientRect (client);
-		client.setSize (client.getSize () *  (1.f / scaleFactor));
-		
-		// outer transform (simulate window scaling)
-		graphics.saveState ();
-		graphics.addTransform (Transform ().scale (scaleFactor, scaleFactor));
+		Point size (client.getSize () * (1.f / scaleFactor));
+
+		// outer transform (simulate window scaling), rotated around the center
+		float radians = angle ? Math::degreesToRad (angle->getValue ().asFloat ()) : 0.f;
+		Transform t;
+		t.translate (client.getWidth () * .5f, client.getHeight () * .5f);
+		t.rotate (radians);
+		t.translate (client.getWidth () * -.5f, client.getHeight () * -.5f);
+		t.scale (scaleFactor, scaleFactor);
+
+		// rotation keeps the scale, the layer resolution only depends on scaling
+		IWindow* window = getWindow ();
+		float deviceScale = scaleFactor * (window ? window->getContentScaleFactor () : 1.f);
+
+		if(layerEnabled && layerEnabled->getValue ().asBool ())
+		{
+			// smooth edges of the rotated bitmap, drawContent () sets the mode for the content itself
+			AntiAliasSetter smoother (graphics);
+			layer.draw (graphics, *this, size, t, deviceScale);
+		}
+		else
 		{
-			graphics.drawRect (client, Pen (Colors::kBlack));
-			FontRef standardFont = getTheme ().getStatics ().getStandardFont ();
-			graphics.drawString (client, String ("abcdefghijk"), standardFont, SolidBrush (Colors::kWhite), Alignment::kLeftTop);
-			
-			if(testImage)
-				graphics.drawImage (testImage, Point (client.getCenter ()));
-			
-			// some inner transform
-			Transform t;
-			t.translate (client.getWidth () * 0.5f, client.getHeight () * .5f);
-			t.rotate (.785f);
-			t.translate (client.getWidth () * -0.25f, client.getHeight () * -0.25f);
 			graphics.saveState ();
 			graphics.addTransform (t);
-			
-			Rect rect (0, 0, client.getSize () * 0.5f);
-			graphics.drawRect (rect, Pen (Colors::kBlue));
-			graphics.drawLine (rect.getLeftTop (), rect.getRightBottom (), Pen (Colors::kBlue));
-			graphics.drawLine (rect.getRightTop (), rect.getLeftBottom (), Pen (Colors::kBlue));
+			drawContent (graphics, deviceScale);
 			graphics.restoreState ();
 		}
+	}
+
+	// LayerContent
+	void drawContent (IGraphics& graphics, float deviceScale) override
+	{
+		AntiAliasSetter smoother (graphics);
+
+		Rect client;
+		getClientRect (client);
+		client.setSize (client.getSize () * (1.f / scaleFactor));
+
+		graphics.drawRect (client, Pen (Colors::kBlack));
+		FontRef standardFont = getTheme ().getStatics ().getStandardFont ();
+		graphics.drawString (client, String ("abcdefghijk"), standardFont, SolidBrush (Colors::kWhite), Alignment::kLeftTop);
+		
+		if(testImage)
+		{
+			// downscaled by the outer transform, the cache provides a prefiltered level instead of the full source
+			Rect src (0, 0, testImage->getWidth (), testImage->getHeight ());
+			Point center (client.getCenter ());
+			Rect dst (src);
+			dst.offset (center.x, center.y);
+			ScaledImageCache::instance ().drawImage (graphics, testImage, src, dst, deviceScale);
+		}
+		
+		// some inner transform
+		Transform t;
+		t.translate (client.getWidth () * 0.5f, client.getHeight () * .5f);
+		t.rotate (.785f);
+		t.translate (client.getWidth () * -0.25f, client.getHeight () * -0.25f);
+		graphics.saveState ();
+		graphics.addTransform (t);
+		
+		Rect rect (0, 0, client.getSize () * 0.5f);
+		graphics.drawRect (rect, Pen (Colors::kBlue));
+		graphics.drawLine (rect.getLeftTop (), rect.getRightBottom (), Pen (Colors::kBlue));
+		graphics.drawLine (rect.getRightTop (), rect.getLeftBottom (), Pen (Colors::kBlue));
 		graphics.restoreState ();
 	}
 	
 private:
 	SharedPtr<IImage> testImage;
+	SharedPtr<IParameter> angle;
+	SharedPtr<IParameter> layerEnabled;
+	SharedPtr<IColorScheme> colorScheme;
+	TransformedLayer layer;
 };
 
 //************************************************************************************************
@@ -101,6 +199,11 @@ public:
 		p->fromString (CCLSTR ("View 2"));
 		p = paramList.addString (CSTR ("string3"), 'str3');
 		p->fromString (CCLSTR ("View 3"));
+
+		transformAngle = paramList.addFloat (-180.f, 180.f, CSTR ("transformAngle"));
+		transformAngle->setValue (0.f);
+		transformAngle->setDefaultValue (0.f);
+		transformLayer = paramList.addParam (CSTR ("transformLayer"));
 	}
 	
 	// Component
@@ -116,7 +219,7 @@ public:
 				args->getElement ()->getDataDefinition (string, "scaleFactor");
 				string.getFloatValue (scaleFactor);
 			}
-			return *NEW TransformTest (bounds, (float)scaleFactor);
+			return *NEW TransformTest (bounds, (float)scaleFactor, transformAngle, transformLayer);
 		}
 		return nullptr;
 	}
@@ -127,6 +230,8 @@ public:
 	}
 	
 protected:
+	IParameter* transformAngle;
+	IParameter* transformLayer;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
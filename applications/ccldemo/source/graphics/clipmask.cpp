@@ -0,0 +1,498 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : clipmask.cpp
+// Description : Clip Mask Cache
+//
+//************************************************************************************************
+
+#include "clipmask.h"
+#include "frozenpath.h"
+
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+	#define CLIP_MASK_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+	#define CLIP_MASK_NEON 1
+	#include <arm_neon.h>
+#endif
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace ClipMaskPrimitives
+{
+	static constexpr int kSubsamples = 4;
+
+	inline uint8 multiply (uint8 value, uint8 coverage)
+	{
+		uint32 x = uint32 (value) * coverage + 128;
+		return uint8 ((x + (x >> 8)) >> 8); // exact rounding of value * coverage / 255
+	}
+
+	static void minimum (uint8* dest, const uint8* a, const uint8* b, int count)
+	{
+		int i = 0;
+		#if CLIP_MASK_SSE2
+		for(; i + 16 <= count; i += 16)
+			_mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), _mm_min_epu8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (a + i)), _mm_loadu_si128 (reinterpret_cast<const __m128i*> (b + i))));
+		#elif CLIP_MASK_NEON
+		for(; i + 16 <= count; i += 16)
+			vst1q_u8 (dest + i, vminq_u8 (vld1q_u8 (a + i), vld1q_u8 (b + i)));
+		#endif
+		for(; i < count; i++)
+			dest[i] = ccl_min (a[i], b[i]);
+	}
+
+	/** Multiply count RGBA pixels by one coverage value per pixel. */
+	static void applyCoverage (uint8* pixels, const uint8* coverage, int count)
+	{
+		int i = 0;
+		#if CLIP_MASK_SSE2
+		const __m128i zero = _mm_setzero_si128 ();
+		const __m128i bias = _mm_set1_epi16 (128);
+		for(; i + 4 <= count; i += 4)
+		{
+			int32 c;
+			::memcpy (&c, coverage + i, 4);
+			__m128i cv = _mm_cvtsi32_si128 (c);
+			cv = _mm_unpacklo_epi8 (cv, cv);
+			cv = _mm_unpacklo_epi16 (cv, cv); // each coverage value repeated for 4 channels
+
+			__m128i px = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (pixels + i * 4));
+			__m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (px, zero), _mm_unpacklo_epi8 (cv, zero)), bias);
+			__m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (px, zero), _mm_unpackhi_epi8 (cv, zero)), bias);
+			lo = _mm_srli_epi16 (_mm_add_epi16 (lo, _mm_srli_epi16 (lo, 8)), 8);
+			hi = _mm_srli_epi16 (_mm_add_epi16 (hi, _mm_srli_epi16 (hi, 8)), 8);
+			_mm_storeu_si128 (reinterpret_cast<__m128i*> (pixels + i * 4), _mm_packus_epi16 (lo, hi));
+		}
+		#elif CLIP_MASK_NEON
+		for(; i + 4 <= count; i += 4)
+		{
+			uint8x8_t c = vreinterpret_u8_u32 (vld1_dup_u32 (reinterpret_cast<const uint32_t*> (coverage + i)));
+			static const uint8_t kExpand[16] = {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3};
+			uint8x16_t cv = vcombine_u8 (vtbl1_u8 (c, vld1_u8 (kExpand)), vtbl1_u8 (c, vld1_u8 (kExpand + 8)));
+
+			uint8x16_t px = vld1q_u8 (pixels + i * 4);
+			uint16x8_t lo = vaddq_u16 (vmull_u8 (vget_low_u8 (px), vget_low_u8 (cv)), vdupq_n_u16 (128));
+			uint16x8_t hi = vaddq_u16 (vmull_u8 (vget_high_u8 (px), vget_high_u8 (cv)), vdupq_n_u16 (128));
+			lo = vshrq_n_u16 (vaddq_u16 (lo, vshrq_n_u16 (lo, 8)), 8);
+			hi = vshrq_n_u16 (vaddq_u16 (hi, vshrq_n_u16 (hi, 8)), 8);
+			vst1q_u8 (pixels + i * 4, vcombine_u8 (vmovn_u16 (lo), vmovn_u16 (hi)));
+		}
+		#endif
+		for(; i < count; i++)
+			for(int c = 0; c < 4; c++)
+				pixels[i * 4 + c] = multiply (pixels[i * 4 + c], coverage[i]);
+	}
+
+	struct Edge
+	{
+		float x0, y0, x1, y1;
+		int direction;
+	};
+}
+
+using namespace ClipMaskPrimitives;
+
+//************************************************************************************************
+// ClipMask
+//************************************************************************************************
+
+static std::atomic<uint32> nextMaskId {0};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMask::ClipMask (int width, int height)
+: width (ccl_max (width, 0)),
+  height (ccl_max (height, 0)),
+  id (++nextMaskId)
+{
+	int size = this->width * this->height;
+	coverage.resize (size);
+	coverage.setCount (size);
+	if(size > 0)
+		::memset (coverage.getItems (), 0, size);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMask* ClipMask::rasterize (const FrozenPath& path, const PathTransform& transform, int width, int height)
+{
+	ClipMask* mask = NEW ClipMask (width, height);
+
+	Vector<PointF> points;
+	Vector<int> counts;
+	path.getPolygons (points, counts, transform.getScale ());
+
+	// all figures are closed for filling
+	std::vector<Edge> edges;
+	int first = 0;
+	for(int figure = 0; figure < counts.count (); figure++)
+	{
+		int count = counts[figure];
+		for(int i = 0; i < count; i++)
+		{
+			PointF p0 = transform.map (points[first + i]);
+			PointF p1 = transform.map (points[first + (i + 1) % count]);
+			Edge edge {p0.x, p0.y, p1.x, p1.y, 1};
+			if(edge.y0 == edge.y1)
+				continue;
+			if(edge.y0 > edge.y1)
+			{
+				std::swap (edge.x0, edge.x1);
+				std::swap (edge.y0, edge.y1);
+				edge.direction = -1;
+			}
+			edges.push_back (edge);
+		}
+		first += count;
+	}
+
+	bool evenOdd = path.isEvenOdd ();
+	std::vector<int> accumulator (width + 1);
+	std::vector<std::pair<float, int>> crossings;
+	static constexpr int kSubsampleCoverage = 256 / kSubsamples;
+
+	for(int y = 0; y < height; y++)
+	{
+		std::fill (accumulator.begin (), accumulator.end (), 0);
+		bool empty = true;
+
+		for(int s = 0; s < kSubsamples; s++)
+		{
+			float sampleY = y + (s + .5f) / kSubsamples;
+			crossings.clear ();
+			for(const Edge& edge : edges)
+				if(sampleY >= edge.y0 && sampleY < edge.y1)
+					crossings.push_back ({edge.x0 + (sampleY - edge.y0) * (edge.x1 - edge.x0) / (edge.y1 - edge.y0), edge.direction});
+			if(crossings.empty ())
+				continue;
+
+			std::sort (crossings.begin (), crossings.end ());
+			int winding = 0;
+			for(size_t i = 0; i + 1 < crossings.size (); i++)
+			{
+				winding += crossings[i].second;
+				bool inside = evenOdd ? (winding & 1) != 0 : winding != 0;
+				if(!inside)
+					continue;
+
+				float xa = ccl_bound<float> (crossings[i].first, 0.f, float (width));
+				float xb = ccl_bound<float> (crossings[i + 1].first, 0.f, float (width));
+				if(xb <= xa)
+					continue;
+
+				empty = false;
+				int ia = int (xa);
+				int ib = int (xb);
+				if(ia == ib)
+					accumulator[ia] += int ((xb - xa) * kSubsampleCoverage + .5f);
+				else
+				{
+					accumulator[ia] += int ((ia + 1 - xa) * kSubsampleCoverage + .5f);
+					for(int x = ia + 1; x < ib; x++)
+						accumulator[x] += kSubsampleCoverage;
+					accumulator[ib] += int ((xb - ib) * kSubsampleCoverage + .5f);
+				}
+			}
+		}
+
+		if(empty)
+			continue;
+
+		uint8* row = mask->getMutableRow (y);
+		for(int x = 0; x < width; x++)
+			row[x] = uint8 (ccl_min (accumulator[x], 255));
+	}
+	return mask;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMask* ClipMask::createIntersection (const ClipMask& a, const ClipMask& b)
+{
+	// masks of one layer have the same size, parts outside the smaller one are not covered
+	int width = ccl_min (a.width, b.width);
+	int height = ccl_min (a.height, b.height);
+
+	ClipMask* mask = NEW ClipMask (a.width, a.height);
+	for(int y = 0; y < height; y++)
+		minimum (mask->getMutableRow (y), a.getRow (y), b.getRow (y), width);
+	return mask;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ClipMask::apply (BitmapData& data) const
+{
+	int w = ccl_min (width, data.width);
+	int h = ccl_min (height, data.height);
+	for(int y = 0; y < data.height; y++)
+	{
+		uint8* pixels = static_cast<uint8*> (data.scan0) + y * data.rowBytes;
+		if(y < h)
+		{
+			applyCoverage (pixels, getRow (y), w);
+			if(data.width > w)
+				::memset (pixels + w * 4, 0, (data.width - w) * 4);
+		}
+		else
+			::memset (pixels, 0, data.width * 4);
+	}
+}
+
+//************************************************************************************************
+// ClipMaskCache::Implementation
+//************************************************************************************************
+
+struct ClipMaskCache::Implementation
+{
+	struct Entry
+	{
+		enum Type { kMask, kIntersection };
+		Type type;
+		uint32 pathId;		///< kMask: path, kIntersection: first mask
+		uint32 otherId;		///< kIntersection: second mask
+		PathTransform transform;	///< kMask: path to mask pixels
+		int width;
+		int height;
+		ClipMask* mask;
+		int64 lastUse;
+	};
+
+	mutable std::mutex lock;
+	std::vector<Entry> entries;
+	int capacity = kDefaultCapacity;
+	int64 useCounter = 0;
+	Statistics statistics;
+
+	~Implementation ()
+	{
+		clear ();
+	}
+
+	void clear ()
+	{
+		for(Entry& entry : entries)
+			entry.mask->release ();
+		entries.clear ();
+	}
+
+	ClipMask* find (const Entry& key)
+	{
+		for(Entry& entry : entries)
+			if(entry.type == key.type && entry.pathId == key.pathId && entry.otherId == key.otherId && entry.transform == key.transform
+			   && entry.width == key.width && entry.height == key.height)
+			{
+				entry.lastUse = ++useCounter;
+				entry.mask->retain ();
+				return entry.mask;
+			}
+		return nullptr;
+	}
+
+	void add (Entry entry)
+	{
+		if(int (entries.size ()) >= capacity)
+		{
+			auto oldest = std::min_element (entries.begin (), entries.end (), [] (const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+			oldest->mask->release ();
+			entries.erase (oldest);
+			statistics.evictions++;
+		}
+
+		entry.lastUse = ++useCounter;
+		entry.mask->retain ();
+		entries.push_back (entry);
+	}
+};
+
+//************************************************************************************************
+// ClipMaskCache
+//************************************************************************************************
+
+DEFINE_SINGLETON (ClipMaskCache)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMaskCache::ClipMaskCache ()
+: implementation (NEW Implementation)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMaskCache::~ClipMaskCache ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMask* ClipMaskCache::retainMask (const FrozenPath& path, const PathTransform& transform, int width, int height)
+{
+	Implementation::Entry key {Implementation::Entry::kMask, path.getId (), 0, transform, width, height, nullptr, 0};
+	{
+		std::lock_guard<std::mutex> guard (implementation->lock);
+		if(ClipMask* mask = implementation->find (key))
+		{
+			implementation->statistics.maskHits++;
+			return mask;
+		}
+		implementation->statistics.maskMisses++;
+	}
+
+	// rasterize without holding the lock, a concurrent miss for the same key only costs time
+	key.mask = ClipMask::rasterize (path, transform, width, height);
+
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	implementation->add (key);
+	return key.mask;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMask* ClipMaskCache::retainIntersection (const ClipMask& a, const ClipMask& b)
+{
+	Implementation::Entry key {Implementation::Entry::kIntersection, a.getId (), b.getId (), PathTransform (), a.getWidth (), a.getHeight (), nullptr, 0};
+	{
+		std::lock_guard<std::mutex> guard (implementation->lock);
+		if(ClipMask* mask = implementation->find (key))
+		{
+			implementation->statistics.intersectionHits++;
+			return mask;
+		}
+		implementation->statistics.intersectionMisses++;
+	}
+
+	key.mask = ClipMask::createIntersection (a, b);
+
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	implementation->add (key);
+	return key.mask;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ClipMaskCache::removeAll ()
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	implementation->clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMaskCache::Statistics ClipMaskCache::getStatistics () const
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	return implementation->statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String ClipMaskCache::getStatisticsString () const
+{
+	Statistics statistics = getStatistics ();
+
+	String s;
+	s << "masks: " << statistics.maskHits << " hits / " << statistics.maskMisses << " misses, ";
+	s << "intersections: " << statistics.intersectionHits << " hits / " << statistics.intersectionMisses << " misses, ";
+	s << statistics.evictions << " evictions";
+	return s;
+}
+
+//************************************************************************************************
+// ClipMaskLayer
+//************************************************************************************************
+
+ClipMaskLayer::ClipMaskLayer (IGraphics& target, RectRef bounds, float scale, const PathTransform& transform)
+: target (target),
+  bounds (bounds),
+  scale (scale),
+  transform (transform)
+{
+	if(bounds.isEmpty ())
+		return;
+
+	bitmap = GraphicsFactory::createBitmap (bounds.getWidth (), bounds.getHeight (), IBitmap::kRGBAlpha, scale);
+	graphics = GraphicsFactory::createBitmapGraphics (bitmap);
+	if(graphics)
+	{
+		graphics->addTransform (Transform ().translate (CoordF (-bounds.left), CoordF (-bounds.top)));
+		if(!transform.isIdentity ())
+			graphics->addTransform (transform.toTransform ());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ClipMaskLayer::addClip (const FrozenPath& path)
+{
+	clipPaths.add (&path);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ClipMaskLayer::~ClipMaskLayer ()
+{
+	if(!graphics)
+		return;
+
+	graphics.release (); // flush drawing before accessing the pixels
+
+	{
+		BitmapDataLocker locker (UnknownPtr<IBitmap> (bitmap), IBitmap::kRGBAlpha, IBitmap::kLockWrite);
+		if(locker.result != kResultOk)
+			return;
+
+		// the mask is rasterized in layer pixels, with the same transform as the content
+		PathTransform maskTransform;
+		maskTransform.scale (scale, scale).translate (CoordF (-bounds.left), CoordF (-bounds.top)).append (transform);
+		ClipMask* mask = nullptr;
+		for(int i = 0; i < clipPaths.count (); i++)
+		{
+			ClipMask* pathMask = ClipMaskCache::instance ().retainMask (*clipPaths[i], maskTransform, locker.data.width, locker.data.height);
+			if(mask)
+			{
+				ClipMask* combined = ClipMaskCache::instance ().retainIntersection (*mask, *pathMask);
+				mask->release ();
+				pathMask->release ();
+				mask = combined;
+			}
+			else
+				mask = pathMask;
+		}
+
+		if(mask)
+		{
+			mask->apply (locker.data);
+			mask->release ();
+		}
+	}
+
+	target.drawImage (bitmap, bounds.getLeftTop ());
+}
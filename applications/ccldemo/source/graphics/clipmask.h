@@ -0,0 +1,140 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : clipmask.h
+// Description : Clip Mask Cache
+//
+//************************************************************************************************
+
+#ifndef _clipmask_h
+#define _clipmask_h
+
+#include "frozenpath.h"
+
+#include "ccl/base/singleton.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/iimage.h"
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ClipMask
+/** 8 bit coverage of a clip area in device pixels, immutable once created. */
+//************************************************************************************************
+
+class ClipMask: public Object
+{
+public:
+	ClipMask (int width, int height);
+
+	int getWidth () const { return width; }
+	int getHeight () const { return height; }
+	uint32 getId () const { return id; }
+	const uint8* getRow (int y) const { return coverage.getItems () + y * width; }
+
+	/** Rasterize the path mapped to mask pixels by transform, with 4 subsamples per pixel
+		vertically and exact horizontal coverage. */
+	static ClipMask* rasterize (const FrozenPath& path, const PathTransform& transform, int width, int height);
+
+	/** Minimum of both coverages. */
+	static ClipMask* createIntersection (const ClipMask& a, const ClipMask& b);
+
+	/** Multiply premultiplied RGBA pixels by the coverage. */
+	void apply (BitmapData& data) const;
+
+protected:
+	int width;
+	int height;
+	uint32 id;
+	Vector<uint8> coverage;
+
+	uint8* getMutableRow (int y) { return coverage.getItems () + y * width; }
+};
+
+//************************************************************************************************
+// ClipMaskCache
+/** Process-wide cache of rasterized clip masks keyed by path id, transform to mask pixels
+	and device size, plus intersections of mask pairs for nested clips.
+	Least recently used entries are evicted beyond the capacity. */
+//************************************************************************************************
+
+class ClipMaskCache: public Object,
+					 public Singleton<ClipMaskCache>
+{
+public:
+	ClipMaskCache ();
+	~ClipMaskCache ();
+
+	static constexpr int kDefaultCapacity = 32;
+
+	/** Returned masks must be released by the caller. */
+	ClipMask* retainMask (const FrozenPath& path, const PathTransform& transform, int width, int height);
+	ClipMask* retainIntersection (const ClipMask& a, const ClipMask& b);
+
+	struct Statistics
+	{
+		int64 maskHits = 0;
+		int64 maskMisses = 0;
+		int64 intersectionHits = 0;
+		int64 intersectionMisses = 0;
+		int64 evictions = 0;
+	};
+
+	Statistics getStatistics () const;
+	String getStatisticsString () const;
+	void removeAll ();
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+};
+
+//************************************************************************************************
+// ClipMaskLayer
+/** Replacement for saveState ()/addTransform ()/addClip (path)/restoreState () with cached
+	masks: content is drawn into an offscreen bitmap covering bounds (in target coordinates),
+	multiplied with the (intersected) clip masks and composited into the target when the layer
+	goes out of scope. Clip paths and content are drawn with the transform, the masks are
+	rasterized with it too, so they stay aligned with the content. */
+//************************************************************************************************
+
+class ClipMaskLayer
+{
+public:
+	ClipMaskLayer (IGraphics& target, RectRef bounds, float scale, const PathTransform& transform = PathTransform ());
+	~ClipMaskLayer ();
+
+	/** Nested clip, intersected with the previous ones. */
+	void addClip (const FrozenPath& path);
+
+	/** Graphics to draw the clipped content with (in target coordinates, transformed), can be null. */
+	IGraphics* getGraphics () const { return graphics; }
+
+protected:
+	IGraphics& target;
+	Rect bounds;
+	float scale;
+	PathTransform transform;
+	AutoPtr<IImage> bitmap;
+	AutoPtr<IGraphics> graphics;
+	Vector<const FrozenPath*> clipPaths;
+};
+
+} // namespace CCL
+
+#endif // _clipmask_h
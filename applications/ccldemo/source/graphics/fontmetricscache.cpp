@@ -0,0 +1,551 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : fontmetricscache.cpp
+// Description : Font Metrics Cache
+//
+//************************************************************************************************
+
+#include "fontmetricscache.h"
+
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/text/cstring.h"
+#include "ccl/public/systemservices.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CCL;
+
+//************************************************************************************************
+// FontMetricsCache::LatinTable
+/** Advances and pair kerning for code points below 256 of one font. Values are stored as float
+	bits in atomics, so readers fill missing values without locking (concurrent fills
+	store the same value). */
+//************************************************************************************************
+
+struct FontMetricsCache::LatinTable
+{
+	static constexpr uint32 kUnknown = 0xFFFFFFFF; // NaN, never a measured value
+	static constexpr int kCount = 256;
+
+	Font font;
+	CoordF height;
+	std::atomic<int64> lastUse {0};	///< for least recently used eviction
+	std::atomic<uint32> advances[kCount];
+	std::unique_ptr<std::atomic<uint32>[]> kerning; ///< [first * kCount + second]
+
+	LatinTable (FontRef font)
+	: font (font),
+	  height (0),
+	  kerning (new std::atomic<uint32>[kCount * kCount])
+	{
+		for(int i = 0; i < kCount; i++)
+			advances[i].store (kUnknown, std::memory_order_relaxed);
+		for(int i = 0; i < kCount * kCount; i++)
+			kerning[i].store (kUnknown, std::memory_order_relaxed);
+
+		RectF size;
+		Font::measureString (size, String ("X"), font);
+		height = size.getHeight ();
+	}
+
+	static uint32 toBits (float value) { uint32 bits; ::memcpy (&bits, &value, sizeof(bits)); return bits; }
+	static float fromBits (uint32 bits) { float value; ::memcpy (&value, &bits, sizeof(value)); return value; }
+
+	CoordF measureWidth (const uchar* chars, int length) const
+	{
+		RectF size;
+		Font::measureString (size, String ().append (chars, length), font);
+		return size.getWidth ();
+	}
+
+	CoordF getAdvance (uchar c)
+	{
+		uint32 bits = advances[c].load (std::memory_order_relaxed);
+		if(bits == kUnknown)
+		{
+			bits = toBits (measureWidth (&c, 1));
+			advances[c].store (bits, std::memory_order_relaxed);
+		}
+		return fromBits (bits);
+	}
+
+	CoordF getKerning (uchar first, uchar second)
+	{
+		std::atomic<uint32>& slot = kerning[first * kCount + second];
+		uint32 bits = slot.load (std::memory_order_relaxed);
+		if(bits == kUnknown)
+		{
+			const uchar pair[2] = {first, second};
+			bits = toBits (measureWidth (pair, 2) - getAdvance (first) - getAdvance (second));
+			slot.store (bits, std::memory_order_relaxed);
+		}
+		return fromBits (bits);
+	}
+
+	RectF measure (StringRef text)
+	{
+		StringChars chars (text);
+		int length = text.length ();
+		if(length == 0)
+			return RectF ();
+
+		CoordF width = getAdvance (chars[0]);
+		for(int i = 1; i < length; i++)
+			width += getKerning (chars[i - 1], chars[i]) + getAdvance (chars[i]);
+		return RectF (0, 0, width, height);
+	}
+};
+
+//************************************************************************************************
+// FontMetricsCache::Implementation
+//************************************************************************************************
+
+struct FontMetricsCache::Implementation
+{
+	struct Entry
+	{
+		std::string key;
+		RectF value;
+		std::atomic<bool> referenced {false};	///< set by readers, cleared by the clock sweep
+	};
+
+	mutable std::shared_mutex lock;
+	std::unordered_map<std::string, Entry*> index;
+	std::vector<std::unique_ptr<Entry>> entries;
+	int clockHand = 0;
+	int capacity = kDefaultCapacity;
+
+	std::atomic<int64> hits {0};
+	std::atomic<int64> misses {0};
+	std::atomic<int64> evictions {0};
+	std::atomic<int64> fastPathHits {0};
+	std::atomic<bool> latinFastPath {false};
+
+	std::shared_mutex latinLock;
+	std::unordered_map<std::string, std::shared_ptr<LatinTable>> latinTables; ///< ~256 KB each
+	std::atomic<int64> latinClock {0};
+
+	template <typename T>
+	static void appendBytes (std::string& key, T value)
+	{
+		key.append (reinterpret_cast<const char*> (&value), sizeof(value));
+	}
+
+	/** Every font attribute that affects measurement. */
+	static std::string makeFontKey (FontRef font)
+	{
+		MutableCString face (font.getFace (), Text::kUTF8);
+
+		std::string key;
+		key.reserve (face.length () + 1 + 2 * sizeof(int) + 3 * sizeof(float));
+		key.append (face.str (), face.length ());
+		key.push_back ('\0');
+		appendBytes<float> (key, font.getSize ());
+		appendBytes<int> (key, font.getStyle ());
+		appendBytes<int> (key, font.getMode ());
+		appendBytes<float> (key, font.getSpacing ());
+		appendBytes<float> (key, font.getLineSpacing ());
+		return key;
+	}
+
+	static std::string makeKey (Kind kind, StringRef text, FontRef font)
+	{
+		MutableCString string (text, Text::kUTF8);
+
+		std::string key = makeFontKey (font);
+		key.push_back (char (kind));
+		key.append (string.str (), string.length ());
+		return key;
+	}
+
+	bool find (RectF& value, const std::string& key)
+	{
+		std::shared_lock<std::shared_mutex> guard (lock);
+		auto it = index.find (key);
+		if(it == index.end ())
+			return false;
+
+		it->second->referenced.store (true, std::memory_order_relaxed);
+		value = it->second->value;
+		return true;
+	}
+
+	void insert (std::string&& key, RectFRef value)
+	{
+		std::unique_lock<std::shared_mutex> guard (lock);
+		if(index.find (key) != index.end ()) // inserted by another thread in the meantime
+			return;
+
+		Entry* entry = nullptr;
+		if(int (entries.size ()) < capacity)
+		{
+			entries.push_back (std::make_unique<Entry> ());
+			entry = entries.back ().get ();
+		}
+		else
+		{
+			while(true)
+			{
+				Entry* candidate = entries[clockHand].get ();
+				clockHand = (clockHand + 1) % capacity;
+				if(!candidate->referenced.exchange (false, std::memory_order_relaxed))
+				{
+					entry = candidate;
+					break;
+				}
+			}
+			index.erase (entry->key);
+			evictions++;
+		}
+
+		entry->key = std::move (key);
+		entry->value = value;
+		entry->referenced.store (false, std::memory_order_relaxed);
+		index.emplace (entry->key, entry);
+	}
+
+	void clear ()
+	{
+		index.clear ();
+		entries.clear ();
+		clockHand = 0;
+	}
+};
+
+//************************************************************************************************
+// FontMetricsCache
+//************************************************************************************************
+
+DEFINE_SINGLETON (FontMetricsCache)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FontMetricsCache::FontMetricsCache ()
+: implementation (NEW Implementation)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FontMetricsCache::~FontMetricsCache ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::setCapacity (int capacity)
+{
+	std::unique_lock<std::shared_mutex> guard (implementation->lock);
+	implementation->clear ();
+	implementation->capacity = ccl_max (capacity, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int FontMetricsCache::getCapacity () const
+{
+	std::shared_lock<std::shared_mutex> guard (implementation->lock);
+	return implementation->capacity;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::removeAll ()
+{
+	std::unique_lock<std::shared_mutex> guard (implementation->lock);
+	implementation->clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FontMetricsCache::isSimpleLatin (StringRef text)
+{
+	// no control characters and no soft hyphen, everything else below 256 is shaped
+	// character by character with pair kerning, except for the common f-ligatures
+	// (ff, fi, fl, ft, fj) which many fonts substitute by default
+	StringChars chars (text);
+	for(int i = 0, length = text.length (); i < length; i++)
+	{
+		uchar c = chars[i];
+		if(c < 0x20 || (c >= 0x7F && c < 0xA0) || c == 0xAD || c >= 0x100)
+			return false;
+		if(c == 'f' && i + 1 < length)
+		{
+			uchar next = chars[i + 1];
+			if(next == 'f' || next == 'i' || next == 'l' || next == 't' || next == 'j')
+				return false;
+		}
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::setLatinFastPath (bool state)
+{
+	implementation->latinFastPath = state;
+	removeAll ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FontMetricsCache::isLatinFastPath () const
+{
+	return implementation->latinFastPath;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+RectF FontMetricsCache::measureLatin (StringRef text, FontRef font)
+{
+	// the table is kept alive by this reference if another thread evicts it meanwhile
+	std::shared_ptr<LatinTable> table;
+	std::string key = Implementation::makeFontKey (font);
+	int64 now = ++implementation->latinClock;
+	{
+		std::shared_lock<std::shared_mutex> guard (implementation->latinLock);
+		auto it = implementation->latinTables.find (key);
+		if(it != implementation->latinTables.end ())
+		{
+			it->second->lastUse.store (now, std::memory_order_relaxed);
+			table = it->second;
+		}
+	}
+	if(!table)
+	{
+		std::unique_lock<std::shared_mutex> guard (implementation->latinLock);
+		auto& tables = implementation->latinTables;
+		auto it = tables.find (key);
+		if(it == tables.end ())
+		{
+			// evict the least recently used table
+			if(int (tables.size ()) >= kMaxLatinTables)
+			{
+				auto oldest = tables.begin ();
+				for(auto candidate = tables.begin (); candidate != tables.end (); ++candidate)
+					if(candidate->second->lastUse.load (std::memory_order_relaxed) < oldest->second->lastUse.load (std::memory_order_relaxed))
+						oldest = candidate;
+				tables.erase (oldest);
+			}
+			it = tables.emplace (key, std::make_shared<LatinTable> (font)).first;
+		}
+		it->second->lastUse.store (now, std::memory_order_relaxed);
+		table = it->second;
+	}
+	return table->measure (text);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+RectF FontMetricsCache::measure (Kind kind, StringRef text, FontRef font)
+{
+	if(kind == kStringSize && implementation->latinFastPath && isSimpleLatin (text))
+	{
+		implementation->fastPathHits++;
+		return measureLatin (text, font);
+	}
+	return measureWithShaper (kind, text, font);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+RectF FontMetricsCache::measureWithShaper (Kind kind, StringRef text, FontRef font)
+{
+	RectF result;
+	switch(kind)
+	{
+	case kStringSize :
+		Font::measureString (result, text, font);
+		break;
+
+	case kImageBounds :
+	case kImageBoundsAtBaseline :
+		Font::measureStringImage (result, text, font, kind == kImageBoundsAtBaseline);
+		break;
+
+	case kAscentDescent :
+		{
+			// the image bounds relative to the string box and to the baseline differ by the
+			// position of the baseline in the box
+			String reference ("X");
+			RectF box, image, imageAtBaseline;
+			Font::measureString (box, reference, font);
+			Font::measureStringImage (image, reference, font, false);
+			Font::measureStringImage (imageAtBaseline, reference, font, true);
+			CoordF ascent = image.top - imageAtBaseline.top;
+			result = RectF (0, -ascent, 0, box.getHeight () - ascent);
+		}
+		break;
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+RectF FontMetricsCache::lookup (Kind kind, StringRef text, FontRef font)
+{
+	std::string key = Implementation::makeKey (kind, text, font);
+
+	RectF value;
+	if(implementation->find (value, key))
+	{
+		implementation->hits++;
+		return value;
+	}
+
+	// measure outside of the lock, other readers continue meanwhile
+	implementation->misses++;
+	value = measure (kind, text, font);
+	implementation->insert (std::move (key), value);
+	return value;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::measureString (RectF& size, StringRef text, FontRef font)
+{
+	size = lookup (kStringSize, text, font);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::measureString (Rect& size, StringRef text, FontRef font)
+{
+	RectF sizeF = lookup (kStringSize, text, font);
+	size = Rect (0, 0, Coord (std::ceil (sizeF.right)), Coord (std::ceil (sizeF.bottom)));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::measureStringImage (RectF& size, StringRef text, FontRef font, bool shiftToBaseline)
+{
+	size = lookup (shiftToBaseline ? kImageBoundsAtBaseline : kImageBounds, text, font);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FontMetricsCache::getAscentDescent (CoordF& ascent, CoordF& descent, FontRef font)
+{
+	RectF box = lookup (kAscentDescent, String::kEmpty, font);
+	ascent = -box.top;
+	descent = box.bottom;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FontMetricsCache::Statistics FontMetricsCache::getStatistics () const
+{
+	Statistics statistics;
+	statistics.hits = implementation->hits;
+	statistics.misses = implementation->misses;
+	statistics.evictions = implementation->evictions;
+
+	std::shared_lock<std::shared_mutex> guard (implementation->lock);
+	statistics.entries = int (implementation->entries.size ());
+	return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FontMetricsCache::getStatisticsString () const
+{
+	Statistics statistics = getStatistics ();
+	int64 lookups = statistics.hits + statistics.misses;
+
+	String s;
+	s << statistics.entries << " entries, " << statistics.hits << " hits / " << statistics.misses << " misses (";
+	s.appendFloatValue (lookups > 0 ? 100. * statistics.hits / lookups : 0., 1);
+	s << "%), " << statistics.evictions << " evictions, " << implementation->fastPathHits.load () << " Latin-1 fast path";
+	return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FontMetricsCache::verifyLatinFastPath (FontRef font)
+{
+	static const CStringPtr kCorpus[] =
+	{
+		"000000", "wwwwww", "0123456789", "X", "XXXXXXXXXX", "CCL", "OK",
+		"W: [", "H: [", ", ", "oo]", "100]", "fgj", "pqy",
+		"AVAVAV", "To Ty Yo", "LT\"Wa", "ffi fl", "The quick brown fox jumps over the lazy dog.",
+		"Sphinx of black quartz, judge my vow!"
+	};
+	static const uchar kLatin1[] = {0xC6, 'r', 0xF8, 's', 'k', 0xF8, 'b', 'i', 'n', 'g', ' ', 'c', 'a', 'f', 0xE9, ' ', 'n', 'a', 0xEF, 'v', 'e', 0};
+
+	static constexpr CoordF kTolerance = .01f; ///< summing advances rounds differently than the shaper
+
+	// strings the fast path would skip are measured by the shaper in both cases
+	Vector<String> corpus;
+	for(CStringPtr text : kCorpus)
+		corpus.add (String (text));
+	corpus.add (String (kLatin1));
+
+	CoordF maxDelta = 0;
+	int mismatches = 0;
+	int fastCount = 0;
+	for(const String& text : corpus)
+	{
+		if(!isSimpleLatin (text))
+			continue;
+
+		fastCount++;
+		RectF fast = measureLatin (text, font);
+		RectF shaped = measureWithShaper (kStringSize, text, font);
+		CoordF delta = ccl_max (ccl_abs (fast.getWidth () - shaped.getWidth ()), ccl_abs (fast.getHeight () - shaped.getHeight ()));
+		maxDelta = ccl_max (maxDelta, delta);
+
+		// integer sizes are rounded up, so a tiny delta can still change the result
+		if(delta > kTolerance || std::ceil (fast.right) != std::ceil (shaped.right) || std::ceil (fast.bottom) != std::ceil (shaped.bottom))
+			mismatches++;
+	}
+
+	// timing on the fast path strings, bypassing the cache
+	static constexpr int kIterations = 100;
+	double startTime = System::GetProfileTime ();
+	for(int i = 0; i < kIterations; i++)
+		for(const String& text : corpus)
+			if(isSimpleLatin (text))
+				measureLatin (text, font);
+	double fastMs = (System::GetProfileTime () - startTime) * 1000.;
+
+	startTime = System::GetProfileTime ();
+	for(int i = 0; i < kIterations; i++)
+		for(const String& text : corpus)
+			if(isSimpleLatin (text))
+				measureWithShaper (kStringSize, text, font);
+	double shaperMs = (System::GetProfileTime () - startTime) * 1000.;
+
+	String s;
+	if(mismatches > 0)
+		s << "FAILED: ";
+	s << mismatches << " of " << fastCount << " fast path strings differ (" << corpus.count () << " measured)";
+	s << ", max delta ";
+	s.appendFloatValue (maxDelta, 3);
+	s << ", fast ";
+	s.appendFloatValue (fastMs, 2);
+	s << "ms / shaper ";
+	s.appendFloatValue (shaperMs, 2);
+	s << "ms";
+	return s;
+}
@@ -0,0 +1,117 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : fontmetricscache.h
+// Description : Font Metrics Cache
+//
+//************************************************************************************************
+
+#ifndef _fontmetricscache_h
+#define _fontmetricscache_h
+
+#include "ccl/base/singleton.h"
+
+#include "ccl/public/gui/graphics/font.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// FontMetricsCache
+/** Process-wide cache for string measurements per font and string, and for the ascent and
+	descent per font. Fonts are keyed by all attributes that affect measurement (face, size,
+	style, mode, spacing and line spacing).
+	Lookups only take a shared lock, so concurrent readers (e.g. tiles drawn on the worker pool)
+	don't block each other. When the cache is full, entries are evicted in CLOCK order
+	(second chance for entries that were hit since the last sweep).
+
+	Optionally, string sizes of simple Latin-1 text (printable code points below 256, no
+	sequences that commonly form ligatures) are computed from per-font advance and kerning
+	pair tables instead of calling the shaper. The tables are
+	filled lazily from shaper measurements of single characters and character pairs, only the
+	tables of the kMaxLatinTables most recently used fonts are kept. */
+//************************************************************************************************
+
+class FontMetricsCache: public Object,
+						public Singleton<FontMetricsCache>
+{
+public:
+	FontMetricsCache ();
+	~FontMetricsCache ();
+
+	static constexpr int kDefaultCapacity = 4096;
+	static constexpr int kMaxLatinTables = 8;	///< fast path tables, ~256 KB per font
+
+	/** Maximum number of entries, removes all entries. */
+	void setCapacity (int capacity);
+	int getCapacity () const;
+
+	/** Cached Font::measureString (). */
+	void measureString (RectF& size, StringRef text, FontRef font);
+	void measureString (Rect& size, StringRef text, FontRef font); ///< rounded up to whole coordinates
+
+	/** Cached Font::measureStringImage (), bounds are relative to the baseline if shiftToBaseline is set. */
+	void measureStringImage (RectF& size, StringRef text, FontRef font, bool shiftToBaseline);
+
+	/** Cached distances from the baseline to the top (ascent) and bottom (descent) of the string
+		box of a font. */
+	void getAscentDescent (CoordF& ascent, CoordF& descent, FontRef font);
+
+	struct Statistics
+	{
+		int64 hits = 0;
+		int64 misses = 0;
+		int64 evictions = 0;
+		int entries = 0;
+	};
+
+	Statistics getStatistics () const;
+	String getStatisticsString () const;
+	void removeAll ();
+
+	/** Enable the Latin-1 fast path for string sizes (default: off), it misses ligatures and
+		contextual shaping that the check in isSimpleLatin () doesn't catch. */
+	void setLatinFastPath (bool state);
+	bool isLatinFastPath () const;
+
+	/** Check if the fast path applies to a string. */
+	static bool isSimpleLatin (StringRef text);
+
+	/** Compare fast path and shaper on a corpus of demo strings, returns a summary that starts
+		with "FAILED" if a size differs. */
+	String verifyLatinFastPath (FontRef font);
+
+protected:
+	enum Kind
+	{
+		kStringSize,
+		kImageBounds,
+		kImageBoundsAtBaseline,
+		kAscentDescent			///< string box relative to the baseline, the text is empty
+	};
+
+	struct Implementation;
+	Implementation* implementation;
+
+	struct LatinTable;
+
+	RectF lookup (Kind kind, StringRef text, FontRef font);
+	RectF measure (Kind kind, StringRef text, FontRef font);
+	static RectF measureWithShaper (Kind kind, StringRef text, FontRef font);
+	RectF measureLatin (StringRef text, FontRef font);
+};
+
+} // namespace CCL
+
+#endif // _fontmetricscache_h
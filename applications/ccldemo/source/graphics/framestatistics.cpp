@@ -0,0 +1,395 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : framestatistics.cpp
+// Description : Frame Statistics HUD
+//
+//************************************************************************************************
+
+#include "framestatistics.h"
+
+#include "ccl/base/message.h"
+
+#include "ccl/public/gui/iparameter.h"
+#include "ccl/public/systemservices.h"
+
+#include <algorithm>
+#include <cfloat>
+
+using namespace CCL;
+
+//************************************************************************************************
+// FrameStatistics::P2Estimator
+/** Jain/Chlamtac P² quantile estimation: five markers whose heights are adjusted with
+	piecewise-parabolic interpolation as samples arrive. */
+//************************************************************************************************
+
+FrameStatistics::P2Estimator::P2Estimator (double p)
+: p (p)
+{
+	reset ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::P2Estimator::reset ()
+{
+	count = 0;
+	for(int i = 0; i < 5; i++)
+	{
+		heights[i] = 0.;
+		positions[i] = i + 1;
+	}
+
+	desired[0] = 1.;
+	desired[1] = 1. + 2. * p;
+	desired[2] = 1. + 4. * p;
+	desired[3] = 3. + 2. * p;
+	desired[4] = 5.;
+
+	increments[0] = 0.;
+	increments[1] = p / 2.;
+	increments[2] = p;
+	increments[3] = (1. + p) / 2.;
+	increments[4] = 1.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::P2Estimator::add (double x)
+{
+	if(count < 5)
+	{
+		heights[count++] = x;
+		if(count == 5)
+			std::sort (heights, heights + 5);
+		return;
+	}
+	count++;
+
+	int k = 0;
+	if(x < heights[0])
+	{
+		heights[0] = x;
+		k = 0;
+	}
+	else if(x >= heights[4])
+	{
+		heights[4] = x;
+		k = 3;
+	}
+	else
+	{
+		for(k = 0; k < 3; k++)
+			if(x < heights[k + 1])
+				break;
+	}
+
+	for(int i = k + 1; i < 5; i++)
+		positions[i] += 1.;
+	for(int i = 0; i < 5; i++)
+		desired[i] += increments[i];
+
+	for(int i = 1; i < 4; i++)
+	{
+		double d = desired[i] - positions[i];
+		if((d >= 1. && positions[i + 1] - positions[i] > 1.) || (d <= -1. && positions[i - 1] - positions[i] < -1.))
+		{
+			double sign = d > 0. ? 1. : -1.;
+			double height = parabolic (i, sign);
+			if(heights[i - 1] < height && height < heights[i + 1])
+				heights[i] = height;
+			else
+				heights[i] = linear (i, sign);
+			positions[i] += sign;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::P2Estimator::parabolic (int i, double d) const
+{
+	return heights[i] + d / (positions[i + 1] - positions[i - 1]) *
+		((positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i]) +
+		 (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::P2Estimator::linear (int i, double d) const
+{
+	int j = i + int (d);
+	return heights[i] + d * (heights[j] - heights[i]) / (positions[j] - positions[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::P2Estimator::getValue () const
+{
+	if(count >= 5)
+		return heights[2];
+	if(count == 0)
+		return 0.;
+
+	// exact for the first samples
+	double sorted[5];
+	std::copy (heights, heights + count, sorted);
+	std::sort (sorted, sorted + count);
+	return sorted[int (p * (count - 1) + .5)];
+}
+
+//************************************************************************************************
+// FrameStatistics
+//************************************************************************************************
+
+DEFINE_CLASS_ABSTRACT_HIDDEN (FrameStatistics, Component)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrameStatistics::FrameStatistics ()
+: Component (CCLSTR ("FrameStatistics")),
+  windowStart (0),
+  windowCount (0),
+  windowSum (0.),
+  quantiles {P2Estimator (.5), P2Estimator (.95), P2Estimator (.99)},
+  frameCount (0),
+  lastUpdateTime (0.),
+  pendingParts (-1.)
+{
+	frameTime = paramList.addString ("frameTime");
+	framePercentiles = paramList.addString ("framePercentiles");
+	frameHistogram = paramList.addString ("frameHistogram");
+	resetFrames = paramList.addParam ("resetFrames");
+
+	reset ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getBucketLimit (int bucket)
+{
+	static const double kLimits[kNumBuckets] = {2., 4., 8., 16.7, 33.3, 50., 100., DBL_MAX};
+	return kLimits[ccl_bound (bucket, 0, kNumBuckets - 1)];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::reset ()
+{
+	windowStart = 0;
+	windowCount = 0;
+	windowSum = 0.;
+	for(P2Estimator& estimator : quantiles)
+		estimator.reset ();
+	for(int64& bucket : buckets)
+		bucket = 0;
+	frameCount = 0;
+	lastUpdateTime = 0.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::addFrame (double ms)
+{
+	if(windowCount == kWindowSize)
+	{
+		windowSum -= window[windowStart];
+		window[windowStart] = ms;
+		windowStart = (windowStart + 1) % kWindowSize;
+	}
+	else
+		window[(windowStart + windowCount++) % kWindowSize] = ms;
+	windowSum += ms;
+
+	for(P2Estimator& estimator : quantiles)
+		estimator.add (ms);
+
+	int bucket = 0;
+	while(ms > getBucketLimit (bucket))
+		bucket++;
+	buckets[bucket]++;
+	frameCount++;
+
+	double now = System::GetProfileTime ();
+	if(now - lastUpdateTime >= kUpdateInterval)
+	{
+		lastUpdateTime = now;
+		updateParameters ();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::addPart (double ms)
+{
+	// the posted message is delivered after the paint of the current update has returned
+	if(pendingParts < 0.)
+	{
+		pendingParts = 0.;
+		(NEW Message ("commitParts"))->post (this);
+	}
+	pendingParts += ms;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getMinimum () const
+{
+	double result = windowCount > 0 ? DBL_MAX : 0.;
+	for(int i = 0; i < windowCount; i++)
+		result = ccl_min (result, window[i]);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getMaximum () const
+{
+	double result = 0.;
+	for(int i = 0; i < windowCount; i++)
+		result = ccl_max (result, window[i]);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getAverage () const
+{
+	return windowCount > 0 ? windowSum / windowCount : 0.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getLastFrame () const
+{
+	return windowCount > 0 ? window[(windowStart + windowCount - 1) % kWindowSize] : 0.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+double FrameStatistics::getQuantile (Quantile quantile) const
+{
+	return quantiles[quantile].getValue ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FrameStatistics::getSummaryString () const
+{
+	String s;
+	s << "min ";
+	s.appendFloatValue (getMinimum (), 2);
+	s << " / avg ";
+	s.appendFloatValue (getAverage (), 2);
+	s << " / max ";
+	s.appendFloatValue (getMaximum (), 2);
+	s << "ms | p50 ";
+	s.appendFloatValue (getQuantile (kP50), 2);
+	s << " / p95 ";
+	s.appendFloatValue (getQuantile (kP95), 2);
+	s << " / p99 ";
+	s.appendFloatValue (getQuantile (kP99), 2);
+	s << "ms (" << frameCount << " frames)";
+	return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FrameStatistics::getHistogramString () const
+{
+	String s;
+	for(int i = 0; i < kNumBuckets; i++)
+	{
+		if(i == kNumBuckets - 1)
+		{
+			s << ">";
+			s.appendFloatValue (getBucketLimit (i - 1), 0);
+		}
+		else
+		{
+			s << "<";
+			s.appendFloatValue (getBucketLimit (i), getBucketLimit (i) < 10. ? 0 : 1);
+		}
+		s << "ms: ";
+		s.appendFloatValue (frameCount > 0 ? 100. * buckets[i] / frameCount : 0., 0);
+		s << "%  ";
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrameStatistics::updateParameters ()
+{
+	String s;
+	s << "Draw took ";
+	s.appendFloatValue (getLastFrame (), 2);
+	s << "ms";
+	frameTime->fromString (s);
+
+	framePercentiles->fromString (getSummaryString ());
+	frameHistogram->fromString (getHistogramString ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tbool CCL_API FrameStatistics::paramChanged (IParameter* param)
+{
+	if(param == resetFrames)
+	{
+		reset ();
+		updateParameters ();
+		return true;
+	}
+	return Component::paramChanged (param);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API FrameStatistics::notify (ISubject* subject, MessageRef msg)
+{
+	if(msg == "commitParts")
+	{
+		if(pendingParts >= 0.)
+			addFrame (pendingParts);
+		pendingParts = -1.;
+	}
+	Component::notify (subject, msg);
+}
+
+//************************************************************************************************
+// FrameStatistics::Scope
+//************************************************************************************************
+
+FrameStatistics::Scope::Scope (FrameStatistics* statistics, bool part)
+: statistics (statistics),
+  part (part),
+  startTime (statistics ? System::GetProfileTime () : 0.)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrameStatistics::Scope::~Scope ()
+{
+	if(!statistics)
+		return;
+
+	double ms = (System::GetProfileTime () - startTime) * 1000.;
+	if(part)
+		statistics->addPart (ms);
+	else
+		statistics->addFrame (ms);
+}
@@ -0,0 +1,129 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : framestatistics.h
+// Description : Frame Statistics HUD
+//
+//************************************************************************************************
+
+#ifndef _framestatistics_h
+#define _framestatistics_h
+
+#include "ccl/app/component.h"
+
+namespace CCL {
+
+interface IParameter;
+
+//************************************************************************************************
+// FrameStatistics
+/** Frame time instrumentation for views: a ring buffer of the recent frames (min/max/avg),
+	streaming p50/p95/p99 estimates (P² algorithm, constant memory), and a histogram since the
+	last reset. The parameters shown by the "FrameStatisticsHUD" skin form are updated at most
+	every kUpdateInterval seconds, so reporting doesn't cause a redraw per frame.
+
+	A demo component adds it as child component, views measure their draw () with a Scope.
+	Pages with several measured views use part scopes: the parts drawn in one window update
+	are summed and counted as one frame once the update is done. Frames are expected on the
+	UI thread. */
+//************************************************************************************************
+
+class FrameStatistics: public Component
+{
+public:
+	DECLARE_CLASS_ABSTRACT (FrameStatistics, Component)
+
+	FrameStatistics ();
+
+	static constexpr int kWindowSize = 128;
+	static constexpr int kNumBuckets = 8;
+	static constexpr double kUpdateInterval = .25;
+
+	enum Quantile { kP50, kP95, kP99, kNumQuantiles };
+
+	void addFrame (double ms);
+	void addPart (double ms);	///< added to the frame of the current window update
+	void reset ();
+
+	int64 getFrameCount () const { return frameCount; }
+	double getMinimum () const;		///< of the last kWindowSize frames
+	double getMaximum () const;		///< of the last kWindowSize frames
+	double getAverage () const;		///< of the last kWindowSize frames
+	double getLastFrame () const;
+	double getQuantile (Quantile quantile) const; ///< since the last reset
+	int64 getBucketCount (int bucket) const { return buckets[bucket]; }
+	static double getBucketLimit (int bucket);	///< upper frame time of a histogram bucket in ms
+
+	String getSummaryString () const;
+	String getHistogramString () const;
+
+	/** Measures the lifetime of the scope as one frame or as part of one, statistics can be null. */
+	struct Scope
+	{
+		Scope (FrameStatistics* statistics, bool part = false);
+		~Scope ();
+
+		FrameStatistics* statistics;
+		bool part;
+		double startTime;
+	};
+
+	// Component
+	tbool CCL_API paramChanged (IParameter* param) override;
+	void CCL_API notify (ISubject* subject, MessageRef msg) override;
+
+protected:
+	class P2Estimator
+	{
+	public:
+		P2Estimator (double p = .5);
+
+		void reset ();
+		void add (double x);
+		double getValue () const;
+
+	protected:
+		double p;
+		int count;
+		double heights[5];
+		double positions[5];
+		double desired[5];
+		double increments[5];
+
+		double parabolic (int i, double d) const;
+		double linear (int i, double d) const;
+	};
+
+	double window[kWindowSize];
+	int windowStart;
+	int windowCount;
+	double windowSum;
+	P2Estimator quantiles[kNumQuantiles];
+	int64 buckets[kNumBuckets];
+	int64 frameCount;
+	double lastUpdateTime;
+	double pendingParts;	///< ms, -1 if no frame is pending
+
+	IParameter* frameTime;
+	IParameter* framePercentiles;
+	IParameter* frameHistogram;
+	IParameter* resetFrames;
+
+	void updateParameters ();
+};
+
+} // namespace CCL
+
+#endif // _framestatistics_h
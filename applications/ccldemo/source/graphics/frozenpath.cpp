@@ -0,0 +1,696 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : frozenpath.cpp
+// Description : Immutable Path with Cached Flattening
+//
+//************************************************************************************************
+
+#include "frozenpath.h"
+
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+using namespace CCL;
+
+//************************************************************************************************
+// FrozenPathGeometry
+//************************************************************************************************
+
+namespace FrozenPathGeometry
+{
+	static constexpr float kTolerance = .25f;	///< maximum distance of a flattened curve in device pixels
+	static constexpr float kMiterLimit = 10.f;	///< ratio of miter length to half the line width
+	static constexpr float kPi = 3.14159265358979f;
+
+	struct Figure
+	{
+		std::vector<PointF> points;
+		bool closed = false;
+	};
+
+	static int getArcSegments (CoordF radius, float sweepDegrees, float scale)
+	{
+		float deviceRadius = radius * scale;
+		if(deviceRadius <= kTolerance)
+			return 1;
+
+		float maxStep = 2.f * std::acos (1.f - kTolerance / deviceRadius);
+		int segments = int (std::ceil (std::fabs (sweepDegrees) * kPi / 180.f / maxStep));
+		return ccl_bound (segments, 1, 1024);
+	}
+
+	static void addPolygon (IGraphicsPath& path, const PointF points[], int count)
+	{
+		if(count < 3)
+			return;
+
+		// all polygons get the same orientation, so the nonzero fill is their union
+		float area = 0.f;
+		for(int i = 0; i < count; i++)
+		{
+			PointFRef p0 = points[i];
+			PointFRef p1 = points[(i + 1) % count];
+			area += p0.x * p1.y - p1.x * p0.y;
+		}
+
+		if(area >= 0.f)
+		{
+			path.startFigure (points[0]);
+			for(int i = 1; i < count; i++)
+				path.lineTo (points[i]);
+		}
+		else
+		{
+			path.startFigure (points[count - 1]);
+			for(int i = count - 2; i >= 0; i--)
+				path.lineTo (points[i]);
+		}
+		path.closeFigure ();
+	}
+
+	static void addCircle (IGraphicsPath& path, PointFRef center, CoordF radius, float scale)
+	{
+		int segments = ccl_max (getArcSegments (radius, 360.f, scale), 8);
+		std::vector<PointF> points (segments);
+		for(int i = 0; i < segments; i++)
+		{
+			float angle = 2.f * kPi * i / segments;
+			points[i] = PointF (center.x + radius * std::cos (angle), center.y + radius * std::sin (angle));
+		}
+		addPolygon (path, points.data (), segments);
+	}
+
+	inline PointF normalized (PointFRef v)
+	{
+		float length = std::sqrt (v.x * v.x + v.y * v.y);
+		return length > 0.f ? PointF (v.x / length, v.y / length) : PointF ();
+	}
+
+	static void addJoin (IGraphicsPath& path, PointFRef v, PointFRef d0, PointFRef d1, CoordF halfWidth, int join, float scale)
+	{
+		float cross = d0.x * d1.y - d0.y * d1.x;
+		float dot = d0.x * d1.x + d0.y * d1.y;
+		if(std::fabs (cross) < 1e-6f && dot > 0.f) // straight continuation
+			return;
+
+		if(join == Pen::kLineJoinRound)
+		{
+			addCircle (path, v, halfWidth, scale);
+			return;
+		}
+
+		// the outer corner is on the side opposite to the turn direction
+		float side = cross > 0.f ? -1.f : 1.f;
+		PointF n0 (-d0.y * halfWidth * side, d0.x * halfWidth * side);
+		PointF n1 (-d1.y * halfWidth * side, d1.x * halfWidth * side);
+		PointF a (v.x + n0.x, v.y + n0.y);
+		PointF b (v.x + n1.x, v.y + n1.y);
+
+		if(join == Pen::kLineJoinMiter)
+		{
+			PointF bisector = normalized (PointF (n0.x + n1.x, n0.y + n1.y));
+			float cosHalf = (bisector.x * n0.x + bisector.y * n0.y) / halfWidth;
+			if(cosHalf > 1.f / kMiterLimit)
+			{
+				float miterLength = halfWidth / cosHalf;
+				PointF m (v.x + bisector.x * miterLength, v.y + bisector.y * miterLength);
+				const PointF quad[] = {v, a, m, b};
+				addPolygon (path, quad, 4);
+				return;
+			}
+		}
+
+		const PointF triangle[] = {v, a, b};
+		addPolygon (path, triangle, 3);
+	}
+
+	static void addStroke (IGraphicsPath& path, const Figure& figure, CoordF halfWidth, int cap, int join, float scale)
+	{
+		// remove duplicate points, they have no direction
+		std::vector<PointF> points;
+		for(PointFRef p : figure.points)
+			if(points.empty () || p != points.back ())
+				points.push_back (p);
+		if(figure.closed && points.size () > 1 && points.front () == points.back ())
+			points.pop_back ();
+
+		int count = int (points.size ());
+		if(count < 2)
+			return;
+
+		bool closed = figure.closed && count > 2;
+		int segmentCount = closed ? count : count - 1;
+		std::vector<PointF> directions (segmentCount);
+		for(int i = 0; i < segmentCount; i++)
+		{
+			PointFRef p0 = points[i];
+			PointFRef p1 = points[(i + 1) % count];
+			directions[i] = normalized (PointF (p1.x - p0.x, p1.y - p0.y));
+		}
+
+		for(int i = 0; i < segmentCount; i++)
+		{
+			PointF p0 = points[i];
+			PointF p1 = points[(i + 1) % count];
+			PointFRef d = directions[i];
+
+			if(!closed && cap == Pen::kLineCapSquare)
+			{
+				if(i == 0)
+					p0 = PointF (p0.x - d.x * halfWidth, p0.y - d.y * halfWidth);
+				if(i == segmentCount - 1)
+					p1 = PointF (p1.x + d.x * halfWidth, p1.y + d.y * halfWidth);
+			}
+
+			PointF n (-d.y * halfWidth, d.x * halfWidth);
+			const PointF quad[] =
+			{
+				PointF (p0.x + n.x, p0.y + n.y),
+				PointF (p1.x + n.x, p1.y + n.y),
+				PointF (p1.x - n.x, p1.y - n.y),
+				PointF (p0.x - n.x, p0.y - n.y)
+			};
+			addPolygon (path, quad, 4);
+		}
+
+		for(int i = closed ? 0 : 1; i < (closed ? count : count - 1); i++)
+		{
+			int incoming = (i - 1 + segmentCount) % segmentCount;
+			addJoin (path, points[i], directions[incoming], directions[i], halfWidth, join, scale);
+		}
+
+		if(!closed && cap == Pen::kLineCapRound)
+		{
+			addCircle (path, points.front (), halfWidth, scale);
+			addCircle (path, points.back (), halfWidth, scale);
+		}
+	}
+}
+
+using namespace FrozenPathGeometry;
+
+//************************************************************************************************
+// PathTransform
+//************************************************************************************************
+
+PathTransform& PathTransform::translate (float x, float y)
+{
+	steps.add ({Step::kTranslate, x, y});
+	tx += a * x + c * y;
+	ty += b * x + d * y;
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PathTransform& PathTransform::rotate (float radians)
+{
+	steps.add ({Step::kRotate, radians, 0.f});
+	float cosine = std::cos (radians);
+	float sine = std::sin (radians);
+	float a0 = a, b0 = b;
+	a = a0 * cosine + c * sine;
+	b = b0 * cosine + d * sine;
+	c = c * cosine - a0 * sine;
+	d = d * cosine - b0 * sine;
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PathTransform& PathTransform::scale (float sx, float sy)
+{
+	steps.add ({Step::kScale, sx, sy});
+	a *= sx;
+	b *= sx;
+	c *= sy;
+	d *= sy;
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PathTransform& PathTransform::append (const PathTransform& other)
+{
+	for(const Step& step : other.steps)
+	{
+		switch(step.type)
+		{
+		case Step::kTranslate : translate (step.x, step.y); break;
+		case Step::kRotate : rotate (step.x); break;
+		case Step::kScale : scale (step.x, step.y); break;
+		}
+	}
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PointF PathTransform::map (PointFRef p) const
+{
+	return PointF (a * p.x + c * p.y + tx, b * p.x + d * p.y + ty);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+RectF PathTransform::mapBounds (RectFRef rect) const
+{
+	const PointF corners[] = {map (rect.getLeftTop ()), map (rect.getRightTop ()), map (rect.getRightBottom ()), map (rect.getLeftBottom ())};
+	RectF bounds (corners[0].x, corners[0].y, corners[0].x, corners[0].y);
+	for(PointFRef p : corners)
+	{
+		bounds.left = ccl_min (bounds.left, p.x);
+		bounds.top = ccl_min (bounds.top, p.y);
+		bounds.right = ccl_max (bounds.right, p.x);
+		bounds.bottom = ccl_max (bounds.bottom, p.y);
+	}
+	return bounds;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+float PathTransform::getScale () const
+{
+	// largest singular value of the linear part
+	float sum = a * a + b * b + c * c + d * d;
+	float det = a * d - b * c;
+	return std::sqrt (.5f * (sum + std::sqrt (ccl_max (sum * sum - 4.f * det * det, 0.f))));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Transform PathTransform::toTransform () const
+{
+	Transform transform;
+	for(const Step& step : steps)
+	{
+		switch(step.type)
+		{
+		case Step::kTranslate : transform.translate (step.x, step.y); break;
+		case Step::kRotate : transform.rotate (step.x); break;
+		case Step::kScale : transform.scale (step.x, step.y); break;
+		}
+	}
+	return transform;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PathTransform::operator == (const PathTransform& other) const
+{
+	return a == other.a && b == other.b && c == other.c && d == other.d && tx == other.tx && ty == other.ty;
+}
+
+//************************************************************************************************
+// FrozenPath::Implementation
+//************************************************************************************************
+
+struct FrozenPath::Implementation
+{
+	static constexpr int kMaxEntries = 8; ///< per path and kind, more scales or pens are not cached
+
+	struct FlattenedEntry
+	{
+		float scale;
+		IGraphicsPath* path;
+	};
+
+	struct OutlineEntry
+	{
+		float scale;
+		CoordF width;
+		int cap;
+		int join;
+		IGraphicsPath* path;	///< solid pens only
+	};
+
+	std::mutex lock;
+	std::vector<FlattenedEntry> flattened;
+	std::vector<OutlineEntry> outlines;
+
+	static std::atomic<int64> flattenHits;
+	static std::atomic<int64> flattenMisses;
+	static std::atomic<int64> strokeHits;
+	static std::atomic<int64> strokeMisses;
+
+	~Implementation ()
+	{
+		for(auto& entry : flattened)
+			entry.path->release ();
+		for(auto& entry : outlines)
+			entry.path->release ();
+	}
+
+	static void flatten (std::vector<Figure>& figures, const Vector<Command>& commands, float scale)
+	{
+		Figure* current = nullptr;
+		auto startFigure = [&] (PointFRef p)
+		{
+			figures.emplace_back ();
+			current = &figures.back ();
+			current->points.push_back (p);
+		};
+
+		for(const Command& command : commands)
+		{
+			switch(command.type)
+			{
+			case Command::kStart :
+				startFigure (command.rect.getLeftTop ());
+				break;
+
+			case Command::kLine :
+				if(current)
+					current->points.push_back (command.rect.getLeftTop ());
+				else
+					startFigure (command.rect.getLeftTop ());
+				break;
+
+			case Command::kArc :
+				{
+					PointF center = command.rect.getCenter ();
+					CoordF rx = command.rect.getWidth () * .5f;
+					CoordF ry = command.rect.getHeight () * .5f;
+					int segments = getArcSegments (ccl_max (rx, ry), command.sweepAngle, scale);
+					for(int i = 0; i <= segments; i++)
+					{
+						float angle = (command.startAngle + command.sweepAngle * i / segments) * kPi / 180.f;
+						PointF p (center.x + rx * std::cos (angle), center.y + ry * std::sin (angle));
+						if(i == 0 && !current)
+							startFigure (p);
+						else
+							current->points.push_back (p); // an open figure is connected with a line
+					}
+				}
+				break;
+
+			case Command::kClose :
+				if(current)
+					current->closed = true;
+				current = nullptr;
+				break;
+			}
+		}
+	}
+};
+
+std::atomic<int64> FrozenPath::Implementation::flattenHits {0};
+std::atomic<int64> FrozenPath::Implementation::flattenMisses {0};
+std::atomic<int64> FrozenPath::Implementation::strokeHits {0};
+std::atomic<int64> FrozenPath::Implementation::strokeMisses {0};
+
+//************************************************************************************************
+// FrozenPath
+//************************************************************************************************
+
+static std::atomic<uint32> nextId {0};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath::Statistics FrozenPath::getStatistics ()
+{
+	Statistics statistics;
+	statistics.flattenHits = Implementation::flattenHits;
+	statistics.flattenMisses = Implementation::flattenMisses;
+	statistics.strokeHits = Implementation::strokeHits;
+	statistics.strokeMisses = Implementation::strokeMisses;
+	return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FrozenPath::getStatisticsString ()
+{
+	Statistics statistics = getStatistics ();
+	auto appendRate = [] (String& s, int64 hits, int64 misses)
+	{
+		s << hits << " hits / " << misses << " misses (";
+		s.appendFloatValue (hits + misses > 0 ? 100. * hits / (hits + misses) : 0., 1);
+		s << "%)";
+	};
+
+	String s;
+	s << "flatten: ";
+	appendRate (s, statistics.flattenHits, statistics.flattenMisses);
+	s << ", stroke: ";
+	appendRate (s, statistics.strokeHits, statistics.strokeMisses);
+	return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath::FrozenPath (bool paintPath)
+: id (++nextId),
+  paintPath (paintPath),
+  evenOdd (false),
+  frozen (false),
+  implementation (NEW Implementation)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath::~FrozenPath ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::setEvenOdd (bool state)
+{
+	ASSERT (!frozen)
+	if(!frozen)
+		evenOdd = state;
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::startFigure (PointFRef p)
+{
+	ASSERT (!frozen)
+	if(!frozen)
+		commands.add ({Command::kStart, RectF (p.x, p.y, p.x, p.y), 0.f, 0.f});
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::lineTo (PointFRef p)
+{
+	ASSERT (!frozen)
+	if(!frozen)
+		commands.add ({Command::kLine, RectF (p.x, p.y, p.x, p.y), 0.f, 0.f});
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::addRect (RectFRef rect)
+{
+	startFigure (rect.getLeftTop ());
+	lineTo (rect.getRightTop ());
+	lineTo (rect.getRightBottom ());
+	lineTo (rect.getLeftBottom ());
+	return closeFigure ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::addArc (RectFRef rect, float startAngle, float sweepAngle)
+{
+	ASSERT (!frozen)
+	if(!frozen)
+		commands.add ({Command::kArc, rect, startAngle, sweepAngle});
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::closeFigure ()
+{
+	ASSERT (!frozen)
+	if(!frozen)
+		commands.add ({Command::kClose, RectF (), 0.f, 0.f});
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+FrozenPath& FrozenPath::freeze ()
+{
+	frozen = true;
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::getPolygons (Vector<PointF>& points, Vector<int>& counts, float scale) const
+{
+	std::vector<Figure> figures;
+	Implementation::flatten (figures, commands, scale);
+	for(const Figure& figure : figures)
+	{
+		for(PointFRef p : figure.points)
+			points.add (p);
+		counts.add (int (figure.points.size ()));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IGraphicsPath* FrozenPath::createPath () const
+{
+	IGraphicsPath* path = paintPath ? GraphicsFactory::createPath (IGraphicsPath::kPaintPath) : GraphicsFactory::createPath ();
+	if(path && evenOdd)
+		path->setFillMode (IGraphicsPath::kFillEvenOdd);
+	return path;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IGraphicsPath* FrozenPath::retainFlattened (float scale)
+{
+	ASSERT (frozen)
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	for(auto& entry : implementation->flattened)
+		if(entry.scale == scale)
+		{
+			Implementation::flattenHits++;
+			entry.path->retain ();
+			return entry.path;
+		}
+
+	Implementation::flattenMisses++;
+	IGraphicsPath* path = createPath ();
+	if(!path)
+		return nullptr;
+
+	std::vector<Figure> figures;
+	Implementation::flatten (figures, commands, scale);
+	for(const Figure& figure : figures)
+	{
+		path->startFigure (figure.points.front ());
+		for(size_t i = 1; i < figure.points.size (); i++)
+			path->lineTo (figure.points[i]);
+		if(figure.closed)
+			path->closeFigure ();
+	}
+
+	if(int (implementation->flattened.size ()) < Implementation::kMaxEntries)
+	{
+		path->retain ();
+		implementation->flattened.push_back ({scale, path});
+	}
+	return path;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IGraphicsPath* FrozenPath::retainStrokeOutline (PenRef pen, float scale)
+{
+	ASSERT (frozen && pen.getPenType () == Pen::kSolid)
+	CoordF width = pen.getWidth ();
+	int cap = pen.getLineCap ();
+	int join = pen.getLineJoin ();
+
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	for(auto& entry : implementation->outlines)
+		if(entry.scale == scale && entry.width == width && entry.cap == cap && entry.join == join)
+		{
+			Implementation::strokeHits++;
+			entry.path->retain ();
+			return entry.path;
+		}
+
+	Implementation::strokeMisses++;
+	IGraphicsPath* path = GraphicsFactory::createPath ();
+	if(!path)
+		return nullptr;
+
+	std::vector<Figure> figures;
+	Implementation::flatten (figures, commands, scale);
+	for(const Figure& figure : figures)
+		addStroke (*path, figure, width * .5f, cap, join, scale);
+
+	if(int (implementation->outlines.size ()) < Implementation::kMaxEntries)
+	{
+		path->retain ();
+		implementation->outlines.push_back ({scale, width, cap, join, path});
+	}
+	return path;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::fill (IGraphics& graphics, BrushRef brush, float scale)
+{
+	AutoPtr<IGraphicsPath> path = retainFlattened (scale);
+	if(path)
+		graphics.fillPath (path, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::stroke (IGraphics& graphics, PenRef pen, float scale)
+{
+	// thin lines look different as filled outlines, the backend draws them better,
+	// the outlines have no dashes
+	if(pen.getWidth () * scale < 1.5f || pen.getPenType () != Pen::kSolid)
+	{
+		AutoPtr<IGraphicsPath> path = retainFlattened (scale);
+		if(path)
+			graphics.drawPath (path, pen);
+		return;
+	}
+
+	AutoPtr<IGraphicsPath> outline = retainStrokeOutline (pen, scale);
+	if(outline)
+		graphics.fillPath (outline, SolidBrush (pen.getColor ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::clip (IGraphics& graphics, float scale)
+{
+	AutoPtr<IGraphicsPath> path = retainFlattened (scale);
+	if(path)
+		graphics.addClip (path);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::fill (IGraphics& graphics, BrushRef brush, const PathTransform& transform, float scale)
+{
+	graphics.saveState ();
+	graphics.addTransform (transform.toTransform ());
+	fill (graphics, brush, scale * transform.getScale ());
+	graphics.restoreState ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FrozenPath::stroke (IGraphics& graphics, PenRef pen, const PathTransform& transform, float scale)
+{
+	graphics.saveState ();
+	graphics.addTransform (transform.toTransform ());
+	stroke (graphics, pen, scale * transform.getScale ());
+	graphics.restoreState ();
+}
@@ -0,0 +1,161 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : frozenpath.h
+// Description : Immutable Path with Cached Flattening
+//
+//************************************************************************************************
+
+#ifndef _frozenpath_h
+#define _frozenpath_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// PathTransform
+/** Affine transform built from the same elementary steps as Transform, each step applies in the
+	coordinates of the previous ones. IGraphics doesn't expose its current matrix, so code that
+	needs the device scale of a transform or maps points itself keeps the transform here and
+	adds it to the graphics with toTransform (). */
+//************************************************************************************************
+
+class PathTransform
+{
+public:
+	PathTransform& translate (float x, float y);
+	PathTransform& rotate (float radians);
+	PathTransform& scale (float sx, float sy);
+	PathTransform& append (const PathTransform& other);	///< other's steps after these
+
+	PointF map (PointFRef p) const;
+	RectF mapBounds (RectFRef rect) const;	///< bounding box of the mapped corners
+
+	/** Largest factor a length is stretched by. */
+	float getScale () const;
+
+	bool isIdentity () const { return steps.isEmpty (); }
+
+	/** Same steps applied to a Transform. */
+	Transform toTransform () const;
+
+	/** Same mapping, regardless of the steps. */
+	bool operator == (const PathTransform& other) const;
+
+protected:
+	struct Step
+	{
+		enum Type { kTranslate, kRotate, kScale };
+		Type type;
+		float x;
+		float y;
+	};
+
+	Vector<Step> steps;
+	float a = 1.f;	///< x' = a * x + c * y + tx, y' = b * x + d * y + ty
+	float b = 0.f;
+	float c = 0.f;
+	float d = 1.f;
+	float tx = 0.f;
+	float ty = 0.f;
+};
+
+//************************************************************************************************
+// FrozenPath
+/** Path that can't be modified after freeze (). Curves are flattened to polylines with a
+	tolerance of a quarter device pixel, and strokes are converted to fill outlines (nonzero
+	union of segment, join and cap polygons). Both results are cached per device scale (and stroke
+	parameters), so repeated draws of the same path only submit a cached polygon path.
+	Dashed pens are stroked by the backend from the flattened path.
+
+	Drawing is thread-safe, e.g. for tiles rendered on the worker pool. */
+//************************************************************************************************
+
+class FrozenPath: public Object
+{
+public:
+	FrozenPath (bool paintPath = false);	///< paintPath: created as IGraphicsPath::kPaintPath
+	~FrozenPath ();
+
+	// building (before freeze)
+	FrozenPath& setEvenOdd (bool state);
+	FrozenPath& startFigure (PointFRef p);
+	FrozenPath& lineTo (PointFRef p);
+	FrozenPath& addRect (RectFRef rect);
+	FrozenPath& addArc (RectFRef rect, float startAngle, float sweepAngle); ///< angles in degrees, connects to an open figure like IGraphicsPath
+	FrozenPath& closeFigure ();
+	FrozenPath& freeze ();
+	bool isFrozen () const { return frozen; }
+	bool isEvenOdd () const { return evenOdd; }
+
+	/** Unique for the lifetime of the process, unlike the address. */
+	uint32 getId () const { return id; }
+
+	/** Flattened figures for filling (all closed) in path coordinates: counts[i] points per figure. */
+	void getPolygons (Vector<PointF>& points, Vector<int>& counts, float scale) const;
+
+	// drawing (after freeze), scale is the device pixels per coordinate of the graphics
+	void fill (IGraphics& graphics, BrushRef brush, float scale = 1.f);
+	void stroke (IGraphics& graphics, PenRef pen, float scale = 1.f);
+	void clip (IGraphics& graphics, float scale = 1.f);
+
+	// drawing with a transform that is added to the graphics, curves are flattened for the
+	// scale after the transform
+	void fill (IGraphics& graphics, BrushRef brush, const PathTransform& transform, float scale = 1.f);
+	void stroke (IGraphics& graphics, PenRef pen, const PathTransform& transform, float scale = 1.f);
+
+	struct Statistics
+	{
+		int64 flattenHits = 0;
+		int64 flattenMisses = 0;
+		int64 strokeHits = 0;
+		int64 strokeMisses = 0;
+	};
+
+	/** Counters of all frozen paths. */
+	static Statistics getStatistics ();
+	static String getStatisticsString ();
+
+protected:
+	struct Command
+	{
+		enum Type { kStart, kLine, kArc, kClose };
+		Type type;
+		RectF rect;				///< kArc: bounds, kStart/kLine: rect.left/top is the point
+		float startAngle;
+		float sweepAngle;
+	};
+
+	uint32 id;
+	bool paintPath;
+	bool evenOdd;
+	Vector<Command> commands;
+	bool frozen;
+
+	struct Implementation;
+	Implementation* implementation;
+
+	IGraphicsPath* createPath () const;
+	IGraphicsPath* retainFlattened (float scale);				///< caller releases
+	IGraphicsPath* retainStrokeOutline (PenRef pen, float scale);	///< caller releases
+};
+
+} // namespace CCL
+
+#endif // _frozenpath_h
@@ -0,0 +1,281 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : geometrycache.cpp
+// Description : Geometry Cache
+//
+//************************************************************************************************
+
+#include "geometrycache.h"
+
+#include "ccl/public/gui/graphics/3d/modelfactory3d.h"
+#include "ccl/public/plugservices.h"
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+using namespace CCL;
+
+//************************************************************************************************
+// GeometryCache::Implementation
+//************************************************************************************************
+
+struct GeometryCache::Implementation
+{
+	enum Type { kCubeTessellator, kCube, kSphere, kGrid };
+
+	struct Key
+	{
+		int type = 0;
+		int flags[2] = {};
+		float params[4] = {};
+		IMaterial3D* material = nullptr;
+
+		bool operator == (const Key& other) const
+		{
+			return type == other.type && material == other.material
+				&& ::memcmp (flags, other.flags, sizeof(flags)) == 0
+				&& ::memcmp (params, other.params, sizeof(params)) == 0;
+		}
+	};
+
+	struct KeyHash
+	{
+		size_t operator () (const Key& key) const
+		{
+			size_t hash = std::hash<int> () (key.type);
+			auto combine = [&] (size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+			for(int flag : key.flags)
+				combine (std::hash<int> () (flag));
+			for(float param : key.params)
+				combine (std::hash<float> () (param));
+			combine (std::hash<IMaterial3D*> () (key.material));
+			return hash;
+		}
+	};
+
+	std::unordered_map<Key, IUnknown*, KeyHash> entries;	///< holds a reference on each object
+
+	~Implementation ()
+	{
+		removeAll ();
+	}
+
+	IUnknown* find (const Key& key) const
+	{
+		auto it = entries.find (key);
+		return it != entries.end () ? it->second : nullptr;
+	}
+
+	void add (const Key& key, IUnknown* object)
+	{
+		// the key holds the material pointer, keep it alive as long as the entry
+		if(key.material)
+			key.material->retain ();
+		entries[key] = object;
+	}
+
+	static void release (const Key& key, IUnknown* object)
+	{
+		object->release ();
+		if(key.material)
+			key.material->release ();
+	}
+
+	/** Models go first, they hold no references on the tessellators, which are copied from. */
+	int purge ()
+	{
+		int removed = 0;
+		for(bool tessellators : {false, true})
+			for(auto it = entries.begin (); it != entries.end ();)
+			{
+				IUnknown* object = it->second;
+				bool isTessellator = it->first.type == kCubeTessellator;
+				object->retain ();
+				bool shared = object->release () > 1;
+				if(isTessellator != tessellators || shared)
+				{
+					++it;
+					continue;
+				}
+
+				release (it->first, object);
+				it = entries.erase (it);
+				removed++;
+			}
+		return removed;
+	}
+
+	void removeAll ()
+	{
+		for(auto& entry : entries)
+			release (entry.first, entry.second);
+		entries.clear ();
+	}
+};
+
+//************************************************************************************************
+// GeometryCache
+//************************************************************************************************
+
+GeometryCache::GeometryCache ()
+: implementation (NEW Implementation),
+  hits (0),
+  misses (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GeometryCache::~GeometryCache ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ITessellator3D* GeometryCache::getCubeTessellator (int generateFlags)
+{
+	Implementation::Key key;
+	key.type = Implementation::kCubeTessellator;
+	key.flags[0] = generateFlags;
+	if(IUnknown* object = implementation->find (key))
+	{
+		hits++;
+		return UnknownPtr<ITessellator3D> (object);
+	}
+
+	ICubeTessellator3D* tessellator = ccl_new<ICubeTessellator3D> (ClassID::CubeTessellator3D);
+	if(!tessellator)
+		return nullptr;
+
+	misses++;
+	tessellator->generate (generateFlags);
+	implementation->add (key, tessellator);
+	return tessellator;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* GeometryCache::getCube (IMaterial3D* material, int generateFlags, int innerFlags)
+{
+	Implementation::Key key;
+	key.type = Implementation::kCube;
+	key.flags[0] = generateFlags;
+	key.flags[1] = innerFlags;
+	key.material = material;
+	if(IUnknown* object = implementation->find (key))
+	{
+		hits++;
+		return UnknownPtr<IModel3D> (object);
+	}
+
+	IModel3D* model = ccl_new<IModel3D> (ClassID::Model3D);
+	if(!model)
+		return nullptr;
+
+	misses++;
+	auto addGeometry = [&] (int flags)
+	{
+		if(ITessellator3D* tessellator = getCubeTessellator (flags))
+		{
+			IGeometry3D* geometry = model->createGeometry ();
+			geometry->copyFrom (*tessellator);
+			model->addGeometry (geometry);
+		}
+	};
+
+	addGeometry (generateFlags);
+	if(innerFlags != 0)
+		addGeometry (innerFlags);
+	if(material)
+		model->setMaterialForGeometries (material);
+
+	implementation->add (key, model);
+	return model;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* GeometryCache::getSphere (IMaterial3D* material, float radius, int latitudes, int longitudes)
+{
+	Implementation::Key key;
+	key.type = Implementation::kSphere;
+	key.flags[0] = latitudes;
+	key.flags[1] = longitudes;
+	key.params[0] = radius;
+	key.material = material;
+	if(IUnknown* object = implementation->find (key))
+	{
+		hits++;
+		return UnknownPtr<IModel3D> (object);
+	}
+
+	IModel3D* model = ModelFactory3D::createSphere (radius, latitudes, longitudes, material);
+	if(!model)
+		return nullptr;
+
+	misses++;
+	implementation->add (key, model);
+	return model;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* GeometryCache::getGrid (IMaterial3D* material, int columns, int rows, float cellWidth, float cellHeight)
+{
+	Implementation::Key key;
+	key.type = Implementation::kGrid;
+	key.flags[0] = columns;
+	key.flags[1] = rows;
+	key.params[0] = cellWidth;
+	key.params[1] = cellHeight;
+	key.material = material;
+	if(IUnknown* object = implementation->find (key))
+	{
+		hits++;
+		return UnknownPtr<IModel3D> (object);
+	}
+
+	IModel3D* model = ModelFactory3D::createGrid (columns, rows, cellWidth, cellHeight, material);
+	if(!model)
+		return nullptr;
+
+	misses++;
+	implementation->add (key, model);
+	return model;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int GeometryCache::purge ()
+{
+	return implementation->purge ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int GeometryCache::count () const
+{
+	return int (implementation->entries.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GeometryCache::removeAll ()
+{
+	implementation->removeAll ();
+	hits = misses = 0;
+}
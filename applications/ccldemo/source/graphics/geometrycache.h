@@ -0,0 +1,74 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : geometrycache.h
+// Description : Geometry Cache
+//
+//************************************************************************************************
+
+#ifndef _geometrycache_h
+#define _geometrycache_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/3d/iscene3d.h"
+#include "ccl/public/gui/graphics/3d/itessellator3d.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// GeometryCache
+/** Shares procedurally tessellated models between requests. Entries are keyed by the primitive
+	type, its parameters and generate flags plus the material, so identical requests return the
+	same model and its geometry buffers are created once. Returned objects are owned by the cache,
+	nodes using them hold their own references. purge () drops the entries nobody else holds.
+
+	Shared models must not be modified by the caller, use a different material for a different
+	look instead. */
+//************************************************************************************************
+
+class GeometryCache: public Object
+{
+public:
+	GeometryCache ();
+	~GeometryCache ();
+
+	/** Cube tessellator generated once per flag combination. */
+	ITessellator3D* getCubeTessellator (int generateFlags);
+
+	/** Cube model with one geometry, or two if innerFlags is not 0 (e.g. for inverse normals). */
+	IModel3D* getCube (IMaterial3D* material, int generateFlags, int innerFlags = 0);
+
+	IModel3D* getSphere (IMaterial3D* material, float radius, int latitudes, int longitudes);
+	IModel3D* getGrid (IMaterial3D* material, int columns, int rows, float cellWidth, float cellHeight);
+
+	/** Release the objects only the cache still references, returns the number of dropped entries. */
+	int purge ();
+
+	int count () const;
+	int getHits () const { return hits; }
+	int getMisses () const { return misses; }
+	void removeAll ();
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+	int hits;
+	int misses;
+};
+
+} // namespace CCL
+
+#endif // _geometrycache_h
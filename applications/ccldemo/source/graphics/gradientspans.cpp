@@ -0,0 +1,558 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : gradientspans.cpp
+// Description : Gradient Span Filler
+//
+//************************************************************************************************
+
+#include "gradientspans.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+
+#include <math.h>
+#include <string.h>
+
+// radial kernels must evaluate dx * dx + dy * dy exactly like the scalar code
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+	#define GRADIENT_SPANS_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define TARGET_SSE4
+		#define TARGET_AVX2
+	#else
+		#define TARGET_SSE4 __attribute__((target ("sse4.1")))
+		#define TARGET_AVX2 __attribute__((target ("avx2")))
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) // vsqrtq_f32 is not available on 32-bit ARM
+	#define GRADIENT_SPANS_NEON 1
+	#include <arm_neon.h>
+#endif
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace GradientSpans
+{
+	static constexpr int32 kFixedMax = 0xFFFF; ///< parameter 1.0 in 16.16 fixed point, minus one
+
+	inline uint32 toTableIndex (int32 t)
+	{
+		return uint32 (ccl_bound<int32> (t, 0, kFixedMax)) >> 8;
+	}
+
+	inline int32 radialParameter (float dx, float dy, float inverseRadius)
+	{
+		float t = sqrtf (dx * dx + dy * dy) * inverseRadius * 65536.f;
+		return (int32)ccl_min (t, (float)kFixedMax);
+	}
+
+	inline uint32 packPixel (float r, float g, float b, float a)
+	{
+		// premultiplied, byte order r, g, b, a
+		uint8 bytes[4] =
+		{
+			uint8 (r * a * 255.f + .5f),
+			uint8 (g * a * 255.f + .5f),
+			uint8 (b * a * 255.f + .5f),
+			uint8 (a * 255.f + .5f)
+		};
+		uint32 pixel;
+		::memcpy (&pixel, bytes, sizeof(pixel));
+		return pixel;
+	}
+
+	#if GRADIENT_SPANS_X86
+	static bool detectSSE4 ()
+	{
+		#if defined(_MSC_VER)
+		int info[4] = {0};
+		__cpuid (info, 1);
+		return (info[2] & (1 << 19)) != 0;
+		#else
+		return __builtin_cpu_supports ("sse4.1");
+		#endif
+	}
+
+	static bool detectAVX2 ()
+	{
+		#if defined(_MSC_VER)
+		int info[4] = {0};
+		__cpuid (info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv (0) & 0x6) == 0x6;
+		if(!osSavesYmm)
+			return false;
+		__cpuidex (info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+		#else
+		return __builtin_cpu_supports ("avx2");
+		#endif
+	}
+
+	TARGET_SSE4 static void fillLinearSSE4 (uint32* dest, const uint32* table, int32 t, int32 dt, int count)
+	{
+		__m128i tv = _mm_add_epi32 (_mm_set1_epi32 (t), _mm_mullo_epi32 (_mm_set_epi32 (3, 2, 1, 0), _mm_set1_epi32 (dt)));
+		const __m128i step = _mm_set1_epi32 (dt * 4);
+		const __m128i zero = _mm_setzero_si128 ();
+		const __m128i maxValue = _mm_set1_epi32 (kFixedMax);
+
+		int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128i index = _mm_srli_epi32 (_mm_min_epi32 (_mm_max_epi32 (tv, zero), maxValue), 8);
+			__m128i pixels = _mm_set_epi32 (table[_mm_extract_epi32 (index, 3)], table[_mm_extract_epi32 (index, 2)],
+											table[_mm_extract_epi32 (index, 1)], table[_mm_extract_epi32 (index, 0)]);
+			_mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), pixels);
+			tv = _mm_add_epi32 (tv, step);
+		}
+		for(t += i * dt; i < count; i++, t += dt)
+			dest[i] = table[toTableIndex (t)];
+	}
+
+	TARGET_AVX2 static void fillLinearAVX2 (uint32* dest, const uint32* table, int32 t, int32 dt, int count)
+	{
+		__m256i tv = _mm256_add_epi32 (_mm256_set1_epi32 (t), _mm256_mullo_epi32 (_mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0), _mm256_set1_epi32 (dt)));
+		const __m256i step = _mm256_set1_epi32 (dt * 8);
+		const __m256i zero = _mm256_setzero_si256 ();
+		const __m256i maxValue = _mm256_set1_epi32 (kFixedMax);
+
+		int i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i index = _mm256_srli_epi32 (_mm256_min_epi32 (_mm256_max_epi32 (tv, zero), maxValue), 8);
+			__m256i pixels = _mm256_i32gather_epi32 (reinterpret_cast<const int*> (table), index, 4);
+			_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest + i), pixels);
+			tv = _mm256_add_epi32 (tv, step);
+		}
+		for(t += i * dt; i < count; i++, t += dt)
+			dest[i] = table[toTableIndex (t)];
+	}
+
+	TARGET_SSE4 static void fillRadialSSE4 (uint32* dest, const uint32* table, float dx, float dy, float inverseRadius, int count)
+	{
+		// x offsets are converted per iteration (not accumulated) to match the scalar rounding
+		__m128i lanes = _mm_set_epi32 (3, 2, 1, 0);
+		const __m128 dxStart = _mm_set1_ps (dx);
+		const __m128 dy2 = _mm_mul_ps (_mm_set1_ps (dy), _mm_set1_ps (dy));
+		const __m128 scale = _mm_set1_ps (inverseRadius);
+		const __m128 fixedOne = _mm_set1_ps (65536.f);
+		const __m128 maxValue = _mm_set1_ps ((float)kFixedMax);
+		const __m128i step = _mm_set1_epi32 (4);
+
+		int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128 dxv = _mm_add_ps (dxStart, _mm_cvtepi32_ps (lanes));
+			__m128 distance = _mm_sqrt_ps (_mm_add_ps (_mm_mul_ps (dxv, dxv), dy2));
+			__m128 t = _mm_min_ps (_mm_mul_ps (_mm_mul_ps (distance, scale), fixedOne), maxValue);
+			__m128i index = _mm_srli_epi32 (_mm_cvttps_epi32 (t), 8);
+			__m128i pixels = _mm_set_epi32 (table[_mm_extract_epi32 (index, 3)], table[_mm_extract_epi32 (index, 2)],
+											table[_mm_extract_epi32 (index, 1)], table[_mm_extract_epi32 (index, 0)]);
+			_mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), pixels);
+			lanes = _mm_add_epi32 (lanes, step);
+		}
+		for(; i < count; i++)
+			dest[i] = table[toTableIndex (radialParameter (dx + (float)i, dy, inverseRadius))];
+	}
+
+	TARGET_AVX2 static void fillRadialAVX2 (uint32* dest, const uint32* table, float dx, float dy, float inverseRadius, int count)
+	{
+		__m256i lanes = _mm256_set_epi32 (7, 6, 5, 4, 3, 2, 1, 0);
+		const __m256 dxStart = _mm256_set1_ps (dx);
+		const __m256 dy2 = _mm256_mul_ps (_mm256_set1_ps (dy), _mm256_set1_ps (dy));
+		const __m256 scale = _mm256_set1_ps (inverseRadius);
+		const __m256 fixedOne = _mm256_set1_ps (65536.f);
+		const __m256 maxValue = _mm256_set1_ps ((float)kFixedMax);
+		const __m256i step = _mm256_set1_epi32 (8);
+
+		int i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 dxv = _mm256_add_ps (dxStart, _mm256_cvtepi32_ps (lanes));
+			__m256 distance = _mm256_sqrt_ps (_mm256_add_ps (_mm256_mul_ps (dxv, dxv), dy2));
+			__m256 t = _mm256_min_ps (_mm256_mul_ps (_mm256_mul_ps (distance, scale), fixedOne), maxValue);
+			__m256i index = _mm256_srli_epi32 (_mm256_cvttps_epi32 (t), 8);
+			__m256i pixels = _mm256_i32gather_epi32 (reinterpret_cast<const int*> (table), index, 4);
+			_mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest + i), pixels);
+			lanes = _mm256_add_epi32 (lanes, step);
+		}
+		for(; i < count; i++)
+			dest[i] = table[toTableIndex (radialParameter (dx + (float)i, dy, inverseRadius))];
+	}
+	#endif // GRADIENT_SPANS_X86
+
+	#if GRADIENT_SPANS_NEON
+	static void fillLinearNEON (uint32* dest, const uint32* table, int32 t, int32 dt, int count)
+	{
+		static const int32 kLanes[4] = {0, 1, 2, 3};
+		int32x4_t tv = vmlaq_n_s32 (vdupq_n_s32 (t), vld1q_s32 (kLanes), dt);
+		const int32x4_t step = vdupq_n_s32 (dt * 4);
+		const int32x4_t zero = vdupq_n_s32 (0);
+		const int32x4_t maxValue = vdupq_n_s32 (kFixedMax);
+
+		int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			uint32x4_t index = vshrq_n_u32 (vreinterpretq_u32_s32 (vminq_s32 (vmaxq_s32 (tv, zero), maxValue)), 8);
+			dest[i + 0] = table[vgetq_lane_u32 (index, 0)];
+			dest[i + 1] = table[vgetq_lane_u32 (index, 1)];
+			dest[i + 2] = table[vgetq_lane_u32 (index, 2)];
+			dest[i + 3] = table[vgetq_lane_u32 (index, 3)];
+			tv = vaddq_s32 (tv, step);
+		}
+		for(t += i * dt; i < count; i++, t += dt)
+			dest[i] = table[toTableIndex (t)];
+	}
+
+	static void fillRadialNEON (uint32* dest, const uint32* table, float dx, float dy, float inverseRadius, int count)
+	{
+		static const int32 kLanes[4] = {0, 1, 2, 3};
+		int32x4_t lanes = vld1q_s32 (kLanes);
+		const float32x4_t dxStart = vdupq_n_f32 (dx);
+		const float32x4_t dy2 = vmulq_f32 (vdupq_n_f32 (dy), vdupq_n_f32 (dy));
+		const float32x4_t maxValue = vdupq_n_f32 ((float)kFixedMax);
+		const int32x4_t step = vdupq_n_s32 (4);
+
+		int i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			float32x4_t dxv = vaddq_f32 (dxStart, vcvtq_f32_s32 (lanes));
+			float32x4_t distance = vsqrtq_f32 (vaddq_f32 (vmulq_f32 (dxv, dxv), dy2));
+			float32x4_t t = vminq_f32 (vmulq_n_f32 (vmulq_n_f32 (distance, inverseRadius), 65536.f), maxValue);
+			uint32x4_t index = vshrq_n_u32 (vcvtq_u32_f32 (t), 8);
+			dest[i + 0] = table[vgetq_lane_u32 (index, 0)];
+			dest[i + 1] = table[vgetq_lane_u32 (index, 1)];
+			dest[i + 2] = table[vgetq_lane_u32 (index, 2)];
+			dest[i + 3] = table[vgetq_lane_u32 (index, 3)];
+			lanes = vaddq_s32 (lanes, step);
+		}
+		for(; i < count; i++)
+			dest[i] = table[toTableIndex (radialParameter (dx + (float)i, dy, inverseRadius))];
+	}
+	#endif // GRADIENT_SPANS_NEON
+}
+
+using namespace GradientSpans;
+
+//************************************************************************************************
+// GradientSpanFiller
+//************************************************************************************************
+
+CStringPtr GradientSpanFiller::getKernelName (Kernel kernel)
+{
+	static const CStringPtr kNames[kNumKernels] = {"Scalar", "SSE4", "AVX2", "NEON"};
+	return kernel >= 0 && kernel < kNumKernels ? kNames[kernel] : "";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GradientSpanFiller::isKernelSupported (Kernel kernel)
+{
+	#if GRADIENT_SPANS_X86
+	static const bool hasSSE4 = detectSSE4 ();
+	static const bool hasAVX2 = detectAVX2 ();
+	#endif
+
+	switch(kernel)
+	{
+	case kScalar : return true;
+	#if GRADIENT_SPANS_X86
+	case kSSE4 : return hasSSE4;
+	case kAVX2 : return hasAVX2;
+	#endif
+	#if GRADIENT_SPANS_NEON
+	case kNEON : return true;
+	#endif
+	default : return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GradientSpanFiller::Kernel GradientSpanFiller::getBestKernel ()
+{
+	static const Kernel bestKernel = [] ()
+	{
+		for(int k = kNumKernels - 1; k > kScalar; k--)
+			if(isKernelSupported (Kernel (k)))
+				return Kernel (k);
+		return kScalar;
+	} ();
+	return bestKernel;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GradientSpanFiller::GradientSpanFiller ()
+: kernel (getBestKernel ()),
+  type (kLinear),
+  radius (0.f),
+  linearDx (0),
+  linearDy (0),
+  linearOrigin (0),
+  inverseRadius (0.f)
+{
+	updateTable ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GradientSpanFiller& GradientSpanFiller::setLinear (PointFRef _start, PointFRef _end)
+{
+	type = kLinear;
+	start = _start;
+	end = _end;
+	updateGeometry ();
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GradientSpanFiller& GradientSpanFiller::setRadial (PointFRef center, float _radius)
+{
+	type = kRadial;
+	start = center;
+	radius = _radius;
+	updateGeometry ();
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GradientSpanFiller& GradientSpanFiller::addStop (float position, ColorRef color)
+{
+	// keep stops sorted by position
+	int index = 0;
+	while(index < stops.count () && stops[index].position <= position)
+		index++;
+	stops.insertAt (index, {ccl_bound (position, 0.f, 1.f), color});
+	updateTable ();
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GradientSpanFiller::updateGeometry ()
+{
+	if(type == kLinear)
+	{
+		// t (p) = (p - start) * d / |d|^2, evaluated incrementally in 16.16 fixed point
+		double dx = end.x - start.x;
+		double dy = end.y - start.y;
+		double lengthSquared = dx * dx + dy * dy;
+		double ux = lengthSquared > 0. ? dx / lengthSquared : 0.;
+		double uy = lengthSquared > 0. ? dy / lengthSquared : 0.;
+		double origin = (.5 - start.x) * ux + (.5 - start.y) * uy;
+
+		// bound the steps so that the kernels can advance several pixels at once without overflow,
+		// a gradient shorter than 1/256 pixel is a hard edge either way
+		const double kOne = double (1 << kFixedShift);
+		const double kMaxStep = double (kMaxLinearStep);
+		linearDx = int32 (ccl_bound (floor (ux * kOne + .5), -kMaxStep, kMaxStep));
+		linearDy = int32 (ccl_bound (floor (uy * kOne + .5), -kMaxStep, kMaxStep));
+		linearOrigin = int64 (ccl_bound (floor (origin * kOne + .5), -1e15, 1e15));
+	}
+	else
+		inverseRadius = radius > 0.f ? 1.f / radius : 0.f;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GradientSpanFiller::updateTable ()
+{
+	auto colorAt = [&] (float position, float rgba[4])
+	{
+		Color color;
+		if(stops.isEmpty ())
+			color = Colors::kTransparentBlack;
+		else if(position <= stops.first ().position)
+			color = stops.first ().color;
+		else if(position >= stops.last ().position)
+			color = stops.last ().color;
+		else
+		{
+			for(int i = 1; i < stops.count (); i++)
+			{
+				const Stop& s0 = stops[i - 1];
+				const Stop& s1 = stops[i];
+				if(position > s1.position)
+					continue;
+
+				float range = s1.position - s0.position;
+				float f = range > 0.f ? (position - s0.position) / range : 1.f;
+				rgba[0] = (s0.color.red + (s1.color.red - s0.color.red) * f) / 255.f;
+				rgba[1] = (s0.color.green + (s1.color.green - s0.color.green) * f) / 255.f;
+				rgba[2] = (s0.color.blue + (s1.color.blue - s0.color.blue) * f) / 255.f;
+				rgba[3] = (s0.color.alpha + (s1.color.alpha - s0.color.alpha) * f) / 255.f;
+				return;
+			}
+		}
+		rgba[0] = color.red / 255.f;
+		rgba[1] = color.green / 255.f;
+		rgba[2] = color.blue / 255.f;
+		rgba[3] = color.alpha / 255.f;
+	};
+
+	for(int i = 0; i < kTableSize; i++)
+	{
+		float rgba[4];
+		colorAt (float (i) / float (kTableSize - 1), rgba);
+		table[i] = packPixel (rgba[0], rgba[1], rgba[2], rgba[3]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GradientSpanFiller::fillSpan (uint32* dest, int x, int y, int count) const
+{
+	if(count <= 0)
+		return;
+
+	if(type == kLinear)
+	{
+		// pixels whose parameter is outside [0, kFixedMax] get the end colors, the kernels only
+		// step through the inner range so the 32 bit parameter can't overflow on long spans
+		int64 t0 = linearOrigin + int64 (x) * linearDx + int64 (y) * linearDy;
+		int64 dt = linearDx;
+		int first = 0;
+		int last = count;
+		uint32 leading = table[toTableIndex (int32 (ccl_bound<int64> (t0, -1, kFixedMax + 1)))];
+		uint32 trailing = leading;
+		if(dt > 0)
+		{
+			if(t0 < 0)
+				first = int (ccl_min<int64> (count, (-t0 + dt - 1) / dt));
+			last = t0 > kFixedMax ? 0 : int (ccl_min<int64> (count, (kFixedMax - t0) / dt + 1));
+			trailing = table[kTableSize - 1];
+		}
+		else if(dt == 0)
+			t0 = ccl_bound<int64> (t0, -1, kFixedMax + 1);
+		else
+		{
+			if(t0 > kFixedMax)
+				first = int (ccl_min<int64> (count, (t0 - kFixedMax - dt - 1) / -dt));
+			last = t0 < 0 ? 0 : int (ccl_min<int64> (count, t0 / -dt + 1));
+			trailing = table[0];
+		}
+		last = ccl_max (first, last);
+
+		for(int i = 0; i < first; i++)
+			dest[i] = leading;
+		for(int i = last; i < count; i++)
+			dest[i] = trailing;
+		if(first == last)
+			return;
+
+		int32 t = int32 (t0 + first * dt);
+		uint32* span = dest + first;
+		int spanCount = last - first;
+		switch(kernel)
+		{
+		#if GRADIENT_SPANS_X86
+		case kAVX2 : fillLinearAVX2 (span, table, t, linearDx, spanCount); return;
+		case kSSE4 : fillLinearSSE4 (span, table, t, linearDx, spanCount); return;
+		#endif
+		#if GRADIENT_SPANS_NEON
+		case kNEON : fillLinearNEON (span, table, t, linearDx, spanCount); return;
+		#endif
+		default :
+			for(int i = 0; i < spanCount; i++, t += linearDx)
+				span[i] = table[toTableIndex (t)];
+		}
+	}
+	else
+	{
+		float dx = (float)x + .5f - start.x;
+		float dy = (float)y + .5f - start.y;
+		switch(kernel)
+		{
+		#if GRADIENT_SPANS_X86
+		case kAVX2 : fillRadialAVX2 (dest, table, dx, dy, inverseRadius, count); return;
+		case kSSE4 : fillRadialSSE4 (dest, table, dx, dy, inverseRadius, count); return;
+		#endif
+		#if GRADIENT_SPANS_NEON
+		case kNEON : fillRadialNEON (dest, table, dx, dy, inverseRadius, count); return;
+		#endif
+		default :
+			for(int i = 0; i < count; i++)
+				dest[i] = table[toTableIndex (radialParameter (dx + (float)i, dy, inverseRadius))];
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GradientSpanFiller::fillBitmap (IBitmap& bitmap, RectRef rect) const
+{
+	BitmapDataLocker locker (&bitmap, IBitmap::kRGBAlpha, IBitmap::kLockWrite);
+	if(locker.result != kResultOk)
+		return false;
+
+	Rect area (rect);
+	area.bound (Rect (0, 0, locker.data.width, locker.data.height));
+	for(int y = area.top; y < area.bottom; y++)
+	{
+		uint32* scanline = reinterpret_cast<uint32*> (static_cast<uint8*> (locker.data.scan0) + y * locker.data.rowBytes);
+		fillSpan (scanline + area.left, area.left, y, area.getWidth ());
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int GradientSpanFiller::verifyKernels (int width, int height) const
+{
+	Vector<uint32> reference;
+	Vector<uint32> result;
+	reference.resize (width);
+	reference.setCount (width);
+	result.resize (width);
+	result.setCount (width);
+
+	GradientSpanFiller scalar (*this);
+	scalar.setKernel (kScalar);
+
+	int mismatches = 0;
+	for(int k = kScalar + 1; k < kNumKernels; k++)
+	{
+		if(!isKernelSupported (Kernel (k)))
+			continue;
+
+		GradientSpanFiller other (*this);
+		other.setKernel (Kernel (k));
+
+		// odd width and x offset exercise the scalar tails of the vector loops
+		for(int y = -2; y < height; y++)
+		{
+			int x = y - 3;
+			scalar.fillSpan (reference.getItems (), x, y, width);
+			other.fillSpan (result.getItems (), x, y, width);
+			for(int i = 0; i < width; i++)
+				if(reference[i] != result[i])
+					mismatches++;
+		}
+	}
+	return mismatches;
+}
@@ -0,0 +1,110 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : gradientspans.h
+// Description : Gradient Span Filler
+//
+//************************************************************************************************
+
+#ifndef _gradientspans_h
+#define _gradientspans_h
+
+#include "ccl/public/gui/graphics/color.h"
+#include "ccl/public/gui/graphics/point.h"
+#include "ccl/public/gui/graphics/rect.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+interface IBitmap;
+
+//************************************************************************************************
+// GradientSpanFiller
+/** Fills pixel spans with a linear or radial gradient with any number of stops.
+	Colors are interpolated into a premultiplied lookup table, pixels are written in the
+	byte order of IBitmap::kRGBAlpha. The gradient parameter is computed in fixed point (linear)
+	or IEEE single precision without contraction (radial), so all kernels produce identical
+	pixels and can be verified against the scalar one. */
+//************************************************************************************************
+
+class GradientSpanFiller
+{
+public:
+	GradientSpanFiller ();
+
+	enum Kernel
+	{
+		kScalar,
+		kSSE4,
+		kAVX2,
+		kNEON,
+
+		kNumKernels
+	};
+
+	static CStringPtr getKernelName (Kernel kernel);
+
+	/** Check if the CPU we are running on supports a kernel. */
+	static bool isKernelSupported (Kernel kernel);
+
+	/** Fastest kernel supported by the CPU (detected once at runtime). */
+	static Kernel getBestKernel ();
+
+	GradientSpanFiller& setLinear (PointFRef start, PointFRef end);
+	GradientSpanFiller& setRadial (PointFRef center, float radius);
+	GradientSpanFiller& addStop (float position, ColorRef color);
+
+	PROPERTY_VARIABLE (Kernel, kernel, Kernel)
+
+	/** Fill count pixels of scanline y starting at x (pixel centers are at +0.5). */
+	void fillSpan (uint32* dest, int x, int y, int count) const;
+
+	/** Fill rect of a bitmap (in pixels). */
+	bool fillBitmap (IBitmap& bitmap, RectRef rect) const;
+
+	/** Compare all supported kernels against the scalar one on a sample area, returns number of differing pixels. */
+	int verifyKernels (int width = 257, int height = 64) const;
+
+protected:
+	static constexpr int kTableSize = 256;
+	static constexpr int kFixedShift = 16;
+	static constexpr int32 kMaxLinearStep = 1 << 24;	///< bound of the fixed point step per pixel
+
+	struct Stop
+	{
+		float position;
+		Color color;
+	};
+
+	enum Type { kLinear, kRadial };
+
+	Type type;
+	PointF start;
+	PointF end;
+	float radius;
+	Vector<Stop> stops;
+	uint32 table[kTableSize];	///< premultiplied colors, rebuilt when stops change
+	int32 linearDx;				///< linear: fixed point parameter step per pixel in x
+	int32 linearDy;				///< linear: fixed point parameter step per pixel in y
+	int64 linearOrigin;			///< linear: fixed point parameter at pixel (0, 0)
+	float inverseRadius;
+
+	void updateTable ();
+	void updateGeometry ();
+};
+
+} // namespace CCL
+
+#endif // _gradientspans_h
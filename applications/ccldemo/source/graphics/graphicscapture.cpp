@@ -0,0 +1,1263 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : graphicscapture.cpp
+// Description : Graphics Call Capture and Replay
+//
+//************************************************************************************************
+
+#include "graphicscapture.h"
+
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/text/cstring.h"
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/systemservices.h"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace CaptureFormat
+{
+	static const char kMagic[4] = {'G', 'C', 'A', 'P'};
+	static constexpr int32 kVersion = 3;
+	static constexpr int32 kMaxStringLength = 1 << 20;
+	static constexpr int32 kMaxImageSize = 1 << 14;
+
+	/** Sequential reader of the command bytes, reports truncated data instead of reading past the end. */
+	struct Reader
+	{
+		const uint8* data;
+		int size;
+		int position = 0;
+		bool failed = false;
+
+		Reader (const uint8* data, int size)
+		: data (data), size (size)
+		{}
+
+		bool atEnd () const { return position >= size || failed; }
+
+		void read (void* result, int count)
+		{
+			if(position + count > size)
+			{
+				failed = true;
+				::memset (result, 0, count);
+				return;
+			}
+			::memcpy (result, data + position, count);
+			position += count;
+		}
+
+		uint8 readByte () { uint8 v; read (&v, 1); return v; }
+		int32 readInt () { int32 v; read (&v, 4); return v; }
+		float readFloat () { float v; read (&v, 4); return v; }
+		Color readColor () { uint8 c[4]; read (c, 4); return Color (c[0], c[1], c[2], c[3]); }
+		PointF readPoint () { float x = readFloat (); float y = readFloat (); return PointF (x, y); }
+
+		RectF readRect ()
+		{
+			float l = readFloat (); float t = readFloat (); float r = readFloat (); float b = readFloat ();
+			return RectF (l, t, r, b);
+		}
+
+		Pen readPen ()
+		{
+			Color color = readColor ();
+			Pen pen (color, readFloat ());
+			pen.setPenType (Pen::PenType (readInt ()));
+			pen.setLineCap (Pen::LineCap (readInt ()));
+			pen.setLineJoin (Pen::LineJoin (readInt ()));
+			return pen;
+		}
+	};
+
+	static bool writeStream (IStream& stream, const void* data, int size)
+	{
+		return size == 0 || stream.write (data, size) == size;
+	}
+
+	static bool readStream (IStream& stream, void* data, int size)
+	{
+		return size == 0 || stream.read (data, size) == size;
+	}
+
+	static RectF toRectF (RectRef rect)
+	{
+		return RectF (CoordF (rect.left), CoordF (rect.top), CoordF (rect.right), CoordF (rect.bottom));
+	}
+
+	static PointF toPointF (PointRef point)
+	{
+		return PointF (CoordF (point.x), CoordF (point.y));
+	}
+}
+
+using namespace CaptureFormat;
+
+//************************************************************************************************
+// GraphicsCapture::Implementation
+//************************************************************************************************
+
+struct GraphicsCapture::Implementation
+{
+	std::unordered_map<std::string, int> stringIndex;	///< UTF-8 text to index in strings
+	std::vector<SharedPtr<IImage>> images;
+	std::unordered_map<IImage*, int> imageIndex;
+
+	void removeAll ()
+	{
+		stringIndex.clear ();
+		images.clear ();
+		imageIndex.clear ();
+	}
+
+	/** Pixels of any image kind, drawn into a bitmap with straight copies of the rows. */
+	static bool writeImage (IStream& stream, IImage* image)
+	{
+		int32 size[2] = {image->getWidth (), image->getHeight ()};
+		AutoPtr<IImage> bitmap = GraphicsFactory::createBitmap (size[0], size[1], IBitmap::kRGBAlpha);
+		if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (bitmap))
+			graphics->drawImage (image, Point ());
+		else
+			return false;
+
+		BitmapDataLocker locker (UnknownPtr<IBitmap> (bitmap), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+		if(locker.result != kResultOk || !writeStream (stream, size, sizeof(size)))
+			return false;
+		for(int y = 0; y < size[1]; y++)
+			if(!writeStream (stream, static_cast<const uint8*> (locker.data.scan0) + y * locker.data.rowBytes, size[0] * 4))
+				return false;
+		return true;
+	}
+
+	static IImage* readImage (IStream& stream)
+	{
+		int32 size[2] = {};
+		if(!readStream (stream, size, sizeof(size)) || size[0] <= 0 || size[1] <= 0 || size[0] > kMaxImageSize || size[1] > kMaxImageSize)
+			return nullptr;
+
+		AutoPtr<IImage> bitmap = GraphicsFactory::createBitmap (size[0], size[1], IBitmap::kRGBAlpha);
+		{
+			BitmapDataLocker locker (UnknownPtr<IBitmap> (bitmap), IBitmap::kRGBAlpha, IBitmap::kLockWrite);
+			if(locker.result != kResultOk)
+				return nullptr;
+			for(int y = 0; y < size[1]; y++)
+				if(!readStream (stream, static_cast<uint8*> (locker.data.scan0) + y * locker.data.rowBytes, size[0] * 4))
+					return nullptr;
+		}
+		return bitmap.detach ();
+	}
+};
+
+//************************************************************************************************
+// GraphicsCapture
+//************************************************************************************************
+
+CStringPtr GraphicsCapture::getOpcodeName (int opcode)
+{
+	static const CStringPtr kNames[kNumOpcodes] =
+	{
+		"saveState", "restoreState", "clipRect", "clipEllipse", "transform", "setMode", "clearRect",
+		"fillRect", "fillGradientRect", "fillEllipse", "fillPolygon", "drawRect", "drawLine", "drawEllipse",
+		"drawString", "drawStringAt", "drawImage", "drawImageAt"
+	};
+	return opcode >= 0 && opcode < kNumOpcodes ? kNames[opcode] : "unknown";
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GraphicsCapture::getCapturePath (Url& path, StringRef name)
+{
+	if(!System::GetSystem ().getLocation (path, System::kAppSettingsFolder))
+		return false;
+	path.descend ("Captures", Url::kFolder);
+	if(!System::GetFileSystem ().createFolder (path) && !System::GetFileSystem ().fileExists (path))
+		return false;
+	path.descend (String (name) << ".gcap");
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GraphicsCapture::GraphicsCapture ()
+: implementation (NEW Implementation),
+  pending (false),
+  width (0),
+  height (0),
+  commandCount (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+GraphicsCapture::~GraphicsCapture ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::removeAll ()
+{
+	implementation->removeAll ();
+	strings.removeAll ();
+	commands.removeAll ();
+	unrecordedCalls.removeAll ();
+	commandCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int GraphicsCapture::getByteSize () const
+{
+	return commands.count ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::write (const void* data, int size)
+{
+	int offset = commands.count ();
+	commands.setCount (offset + size);
+	::memcpy (commands.getItems () + offset, data, size);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeOpcode (Opcode opcode)
+{
+	uint8 value = uint8 (opcode);
+	write (&value, 1);
+	commandCount++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeInt (int32 value)
+{
+	write (&value, 4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeFloat (float value)
+{
+	write (&value, 4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeColor (ColorRef color)
+{
+	uint8 c[4] = {color.red, color.green, color.blue, color.alpha};
+	write (c, 4);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeRect (RectFRef rect)
+{
+	float values[4] = {rect.left, rect.top, rect.right, rect.bottom};
+	write (values, sizeof(values));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writePoint (PointFRef point)
+{
+	float values[2] = {point.x, point.y};
+	write (values, sizeof(values));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeString (StringRef string)
+{
+	MutableCString utf8 (string, Text::kUTF8);
+	auto result = implementation->stringIndex.emplace (std::string (utf8.str (), utf8.length ()), strings.count ());
+	if(result.second)
+		strings.add (string);
+	writeInt (result.first->second);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeFont (FontRef font)
+{
+	writeString (font.getFace ());
+	writeFloat (font.getSize ());
+	writeInt (font.getStyle ());
+	writeInt (font.getMode ());
+	writeFloat (font.getSpacing ());
+	writeFloat (font.getLineSpacing ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writePen (PenRef pen)
+{
+	writeColor (pen.getColor ());
+	writeFloat (pen.getWidth ());
+	writeInt (pen.getPenType ());
+	writeInt (pen.getLineCap ());
+	writeInt (pen.getLineJoin ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::writeImage (IImage* image)
+{
+	auto result = implementation->imageIndex.emplace (image, int (implementation->images.size ()));
+	if(result.second)
+		implementation->images.emplace_back (image);
+	writeInt (result.first->second);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsCapture::addUnrecorded (CStringPtr call)
+{
+	String name (call);
+	for(StringRef existing : unrecordedCalls)
+		if(existing == name)
+			return;
+	unrecordedCalls.add (name);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String GraphicsCapture::getUnrecordedCalls () const
+{
+	String result;
+	for(StringRef call : unrecordedCalls)
+	{
+		if(!result.isEmpty ())
+			result << ", ";
+		result << call;
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GraphicsCapture::save (UrlRef path) const
+{
+	if(!isComplete ())
+		return false;
+
+	AutoPtr<IStream> stream = System::GetFileSystem ().openStream (path, IStream::kCreateMode);
+	if(!stream)
+		return false;
+
+	int32 header[6] = {kVersion, width, height, strings.count (), int32 (implementation->images.size ()), commandCount};
+	if(!writeStream (*stream, kMagic, 4) || !writeStream (*stream, header, sizeof(header)))
+		return false;
+
+	for(StringRef string : strings)
+	{
+		MutableCString utf8 (string, Text::kUTF8);
+		int32 length = utf8.length ();
+		if(!writeStream (*stream, &length, 4) || !writeStream (*stream, utf8.str (), length))
+			return false;
+	}
+
+	for(IImage* image : implementation->images)
+		if(!Implementation::writeImage (*stream, image))
+			return false;
+
+	int32 byteCount = commands.count ();
+	return writeStream (*stream, &byteCount, 4) && writeStream (*stream, commands.getItems (), byteCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GraphicsCapture::load (UrlRef path)
+{
+	removeAll ();
+
+	AutoPtr<IStream> stream = System::GetFileSystem ().openStream (path, IStream::kOpenMode);
+	if(!stream)
+		return false;
+
+	char magic[4] = {};
+	int32 header[6] = {};
+	if(!readStream (*stream, magic, 4) || ::memcmp (magic, kMagic, 4) != 0 || !readStream (*stream, header, sizeof(header)))
+		return false;
+	if(header[0] != kVersion || header[1] < 0 || header[2] < 0 || header[3] < 0 || header[4] < 0 || header[5] < 0)
+		return false;
+
+	std::vector<char> buffer;
+	for(int i = 0; i < header[3]; i++)
+	{
+		int32 length = 0;
+		if(!readStream (*stream, &length, 4) || length < 0 || length > kMaxStringLength)
+			return false;
+		buffer.assign (length + 1, 0);
+		if(!readStream (*stream, buffer.data (), length))
+			return false;
+
+		String string;
+		string.appendCString (Text::kUTF8, buffer.data ());
+		strings.add (string);
+	}
+
+	for(int i = 0; i < header[4]; i++)
+	{
+		AutoPtr<IImage> image = Implementation::readImage (*stream);
+		if(!image)
+		{
+			removeAll ();
+			return false;
+		}
+		implementation->images.emplace_back (image);
+	}
+
+	int32 byteCount = 0;
+	if(!readStream (*stream, &byteCount, 4) || byteCount < 0)
+	{
+		removeAll ();
+		return false;
+	}
+	commands.setCount (byteCount);
+	if(!readStream (*stream, commands.getItems (), byteCount))
+	{
+		removeAll ();
+		return false;
+	}
+	width = header[1];
+	height = header[2];
+	commandCount = header[5];
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GraphicsCapture::replay (IGraphics& graphics, Timing* timings) const
+{
+	Reader reader (commands.getItems (), commands.count ());
+	std::vector<PointF> points;
+	int stateDepth = 0;
+
+	auto getString = [&] (int32 index) -> StringRef
+	{
+		static const String kEmpty;
+		if(index < 0 || index >= strings.count ())
+		{
+			reader.failed = true;
+			return kEmpty;
+		}
+		return strings[index];
+	};
+
+	auto getImage = [&] (int32 index) -> IImage*
+	{
+		if(index < 0 || index >= int (implementation->images.size ()))
+		{
+			reader.failed = true;
+			return nullptr;
+		}
+		return implementation->images[index];
+	};
+
+	auto readFont = [&] ()
+	{
+		StringRef face = getString (reader.readInt ());
+		float size = reader.readFloat ();
+		int style = reader.readInt ();
+		int mode = reader.readInt ();
+		Font font (face, size, style, mode);
+		font.setSpacing (reader.readFloat ());
+		font.setLineSpacing (reader.readFloat ());
+		return font;
+	};
+
+	while(!reader.atEnd ())
+	{
+		int opcode = reader.readByte ();
+		double startTime = timings ? System::GetProfileTime () : 0.;
+
+		switch(opcode)
+		{
+		case kSaveState :
+			graphics.saveState ();
+			stateDepth++;
+			break;
+
+		case kRestoreState :
+			if(stateDepth > 0)
+			{
+				graphics.restoreState ();
+				stateDepth--;
+			}
+			break;
+
+		case kClipRect :
+			graphics.addClip (reader.readRect ());
+			break;
+
+		case kClipEllipse :
+			GraphicsRecorder::addClipEllipse (graphics, reader.readRect ());
+			break;
+
+		case kTransform :
+			{
+				float m[6];
+				for(float& value : m)
+					value = reader.readFloat ();
+				graphics.addTransform (Transform (m[0], m[1], m[2], m[3], m[4], m[5]));
+			}
+			break;
+
+		case kSetMode :
+			graphics.setMode (reader.readInt ());
+			break;
+
+		case kClearRect :
+			graphics.clearRect (reader.readRect ());
+			break;
+
+		case kFillRect :
+			{
+				RectF rect = reader.readRect ();
+				graphics.fillRect (rect, SolidBrush (reader.readColor ()));
+			}
+			break;
+
+		case kFillGradientRect :
+			{
+				RectF rect = reader.readRect ();
+				PointF start = reader.readPoint ();
+				PointF end = reader.readPoint ();
+				Color color1 = reader.readColor ();
+				Color color2 = reader.readColor ();
+				GraphicsRecorder::fillGradientRect (graphics, rect, start, end, color1, color2);
+			}
+			break;
+
+		case kFillEllipse :
+			{
+				RectF rect = reader.readRect ();
+				graphics.fillEllipse (rect, SolidBrush (reader.readColor ()));
+			}
+			break;
+
+		case kFillPolygon :
+			{
+				int count = reader.readInt ();
+				if(count < 0 || count > reader.size / 8)
+				{
+					reader.failed = true;
+					break;
+				}
+				points.resize (count);
+				for(PointF& p : points)
+					p = reader.readPoint ();
+				Color color = reader.readColor ();
+				GraphicsRecorder::fillPolygon (graphics, points.data (), count, color);
+			}
+			break;
+
+		case kDrawRect :
+			{
+				RectF rect = reader.readRect ();
+				graphics.drawRect (rect, reader.readPen ());
+			}
+			break;
+
+		case kDrawLine :
+			{
+				PointF start = reader.readPoint ();
+				PointF end = reader.readPoint ();
+				graphics.drawLine (start, end, reader.readPen ());
+			}
+			break;
+
+		case kDrawEllipse :
+			{
+				RectF rect = reader.readRect ();
+				graphics.drawEllipse (rect, reader.readPen ());
+			}
+			break;
+
+		case kDrawString :
+			{
+				RectF rect = reader.readRect ();
+				StringRef text = getString (reader.readInt ());
+				Font font = readFont ();
+				Color color = reader.readColor ();
+				int alignment = reader.readInt ();
+				graphics.drawString (rect, text, font, SolidBrush (color), Alignment (alignment));
+			}
+			break;
+
+		case kDrawStringAt :
+			{
+				PointF position = reader.readPoint ();
+				StringRef text = getString (reader.readInt ());
+				Font font = readFont ();
+				Color color = reader.readColor ();
+				int options = reader.readInt ();
+				graphics.drawString (position, text, font, SolidBrush (color), options);
+			}
+			break;
+
+		case kDrawImage :
+			{
+				IImage* image = getImage (reader.readInt ());
+				RectF src = reader.readRect ();
+				RectF dst = reader.readRect ();
+				if(image)
+					graphics.drawImage (image, src, dst);
+			}
+			break;
+
+		case kDrawImageAt :
+			{
+				IImage* image = getImage (reader.readInt ());
+				PointF position = reader.readPoint ();
+				if(image)
+					graphics.drawImage (image, position);
+			}
+			break;
+
+		default :
+			reader.failed = true;
+			break;
+		}
+
+		if(timings && opcode < kNumOpcodes)
+		{
+			timings[opcode].count++;
+			timings[opcode].seconds += System::GetProfileTime () - startTime;
+		}
+	}
+
+	// unbalanced captures must not leak state into the target
+	while(stateDepth-- > 0)
+		graphics.restoreState ();
+
+	return !reader.failed;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String GraphicsCapture::profile (int iterations) const
+{
+	if(width <= 0 || height <= 0)
+		return String ("capture has no frame size");
+
+	AutoPtr<IImage> bitmap = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+	AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (bitmap);
+	if(!graphics)
+		return String ("can't create bitmap graphics");
+
+	Timing timings[kNumOpcodes];
+	double startTime = System::GetProfileTime ();
+	for(int i = 0; i < iterations; i++)
+	{
+		graphics->clearRect (Rect (0, 0, width, height));
+		if(!replay (*graphics, timings))
+			return String ("invalid capture data");
+	}
+	double totalMs = (System::GetProfileTime () - startTime) * 1000. / iterations;
+
+	String result;
+	result << commandCount << " calls, ";
+	result.appendFloatValue (totalMs, 2);
+	result << "ms per frame | ";
+	for(int i = 0; i < kNumOpcodes; i++)
+	{
+		if(timings[i].count == 0)
+			continue;
+		result << getOpcodeName (i) << " " << timings[i].count / iterations << "x ";
+		result.appendFloatValue (timings[i].seconds * 1000. / iterations, 2);
+		result << "ms  ";
+	}
+	return result;
+}
+
+//************************************************************************************************
+// GraphicsRecorder
+//************************************************************************************************
+
+GraphicsRecorder::GraphicsRecorder (IGraphics& target, GraphicsCapture* capture)
+: target (target),
+  capture (capture)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool GraphicsRecorder::isRecordable (CStringPtr call, BrushRef brush)
+{
+	if(brush.getType () != Brush::kSolid)
+	{
+		capture->addUnrecorded (call);
+		return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordRect (GraphicsCapture::Opcode opcode, RectFRef rect)
+{
+	if(capture)
+	{
+		capture->writeOpcode (opcode);
+		capture->writeRect (rect);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordFill (GraphicsCapture::Opcode opcode, CStringPtr call, RectFRef rect, BrushRef brush)
+{
+	if(capture && isRecordable (call, brush))
+	{
+		capture->writeOpcode (opcode);
+		capture->writeRect (rect);
+		capture->writeColor (brush.getColor ());
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordStroke (GraphicsCapture::Opcode opcode, RectFRef rect, PenRef pen)
+{
+	if(capture)
+	{
+		capture->writeOpcode (opcode);
+		capture->writeRect (rect);
+		capture->writePen (pen);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordLine (PointFRef start, PointFRef end, PenRef pen)
+{
+	if(capture)
+	{
+		capture->writeOpcode (GraphicsCapture::kDrawLine);
+		capture->writePoint (start);
+		capture->writePoint (end);
+		capture->writePen (pen);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordString (RectFRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment)
+{
+	if(capture && isRecordable ("drawString", brush))
+	{
+		capture->writeOpcode (GraphicsCapture::kDrawString);
+		capture->writeRect (rect);
+		capture->writeString (text);
+		capture->writeFont (font);
+		capture->writeColor (brush.getColor ());
+		capture->writeInt (alignment.align);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordStringAt (PointFRef point, StringRef text, FontRef font, BrushRef brush, int options)
+{
+	if(capture && isRecordable ("drawString", brush))
+	{
+		capture->writeOpcode (GraphicsCapture::kDrawStringAt);
+		capture->writePoint (point);
+		capture->writeString (text);
+		capture->writeFont (font);
+		capture->writeColor (brush.getColor ());
+		capture->writeInt (options);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordImage (IImage* image, RectFRef src, RectFRef dst)
+{
+	if(capture && image)
+	{
+		capture->writeOpcode (GraphicsCapture::kDrawImage);
+		capture->writeImage (image);
+		capture->writeRect (src);
+		capture->writeRect (dst);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::recordImageAt (IImage* image, PointFRef position)
+{
+	// the image mode is not recorded, replay draws with the default one
+	if(capture && image)
+	{
+		capture->writeOpcode (GraphicsCapture::kDrawImageAt);
+		capture->writeImage (image);
+		capture->writePoint (position);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::addClipEllipse (IGraphics& graphics, RectFRef rect)
+{
+	AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
+	path->addArc (rect, 0.f, 360.f);
+	graphics.addClip (path);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::fillGradientRect (IGraphics& graphics, RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2)
+{
+	graphics.fillRect (rect, LinearGradientBrush (start, end, color1, color2));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::fillPolygon (IGraphics& graphics, const PointF points[], int count, ColorRef color)
+{
+	if(count < 3)
+		return;
+
+	AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
+	path->startFigure (points[0]);
+	for(int i = 1; i < count; i++)
+		path->lineTo (points[i]);
+	path->closeFigure ();
+	graphics.fillPath (path, SolidBrush (color));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::addClipEllipse (RectFRef rect)
+{
+	addClipEllipse (target, rect);
+	recordRect (GraphicsCapture::kClipEllipse, rect);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::fillGradientRect (RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2)
+{
+	fillGradientRect (target, rect, start, end, color1, color2);
+	if(capture)
+	{
+		capture->writeOpcode (GraphicsCapture::kFillGradientRect);
+		capture->writeRect (rect);
+		capture->writePoint (start);
+		capture->writePoint (end);
+		capture->writeColor (color1);
+		capture->writeColor (color2);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void GraphicsRecorder::fillPolygon (const PointF points[], int count, ColorRef color)
+{
+	if(count < 3)
+		return;
+
+	fillPolygon (target, points, count, color);
+	if(capture)
+	{
+		capture->writeOpcode (GraphicsCapture::kFillPolygon);
+		capture->writeInt (count);
+		for(int i = 0; i < count; i++)
+			capture->writePoint (points[i]);
+		capture->writeColor (color);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::saveState ()
+{
+	if(capture)
+		capture->writeOpcode (GraphicsCapture::kSaveState);
+	return target.saveState ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::restoreState ()
+{
+	if(capture)
+		capture->writeOpcode (GraphicsCapture::kRestoreState);
+	return target.restoreState ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::addClip (RectRef rect)
+{
+	recordRect (GraphicsCapture::kClipRect, toRectF (rect));
+	return target.addClip (rect);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::addClip (RectFRef rect)
+{
+	recordRect (GraphicsCapture::kClipRect, rect);
+	return target.addClip (rect);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::addClip (IGraphicsPath* path)
+{
+	if(capture)
+		capture->addUnrecorded ("clipPath");
+	return target.addClip (path);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::addTransform (TransformRef matrix)
+{
+	if(capture)
+	{
+		capture->writeOpcode (GraphicsCapture::kTransform);
+		for(float value : {matrix.a0, matrix.a1, matrix.b0, matrix.b1, matrix.t0, matrix.t1})
+			capture->writeFloat (value);
+	}
+	return target.addTransform (matrix);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::setMode (int mode)
+{
+	if(capture)
+	{
+		capture->writeOpcode (GraphicsCapture::kSetMode);
+		capture->writeInt (mode);
+	}
+	return target.setMode (mode);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int CCL_API GraphicsRecorder::getMode ()
+{
+	return target.getMode ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::clearRect (RectRef rect)
+{
+	recordRect (GraphicsCapture::kClearRect, toRectF (rect));
+	return target.clearRect (rect);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::clearRect (RectFRef rect)
+{
+	recordRect (GraphicsCapture::kClearRect, rect);
+	return target.clearRect (rect);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::fillRect (RectRef rect, BrushRef brush)
+{
+	recordFill (GraphicsCapture::kFillRect, "fillRect", toRectF (rect), brush);
+	return target.fillRect (rect, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::fillRect (RectFRef rect, BrushRef brush)
+{
+	recordFill (GraphicsCapture::kFillRect, "fillRect", rect, brush);
+	return target.fillRect (rect, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawRect (RectRef rect, PenRef pen)
+{
+	recordStroke (GraphicsCapture::kDrawRect, toRectF (rect), pen);
+	return target.drawRect (rect, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawRect (RectFRef rect, PenRef pen)
+{
+	recordStroke (GraphicsCapture::kDrawRect, rect, pen);
+	return target.drawRect (rect, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawLine (PointRef start, PointRef end, PenRef pen)
+{
+	recordLine (toPointF (start), toPointF (end), pen);
+	return target.drawLine (start, end, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawLine (PointFRef start, PointFRef end, PenRef pen)
+{
+	recordLine (start, end, pen);
+	return target.drawLine (start, end, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::fillEllipse (RectRef rect, BrushRef brush)
+{
+	recordFill (GraphicsCapture::kFillEllipse, "fillEllipse", toRectF (rect), brush);
+	return target.fillEllipse (rect, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::fillEllipse (RectFRef rect, BrushRef brush)
+{
+	recordFill (GraphicsCapture::kFillEllipse, "fillEllipse", rect, brush);
+	return target.fillEllipse (rect, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawEllipse (RectRef rect, PenRef pen)
+{
+	recordStroke (GraphicsCapture::kDrawEllipse, toRectF (rect), pen);
+	return target.drawEllipse (rect, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawEllipse (RectFRef rect, PenRef pen)
+{
+	recordStroke (GraphicsCapture::kDrawEllipse, rect, pen);
+	return target.drawEllipse (rect, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::fillPath (IGraphicsPath* path, BrushRef brush)
+{
+	if(capture)
+		capture->addUnrecorded ("fillPath");
+	return target.fillPath (path, brush);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawPath (IGraphicsPath* path, PenRef pen)
+{
+	if(capture)
+		capture->addUnrecorded ("drawPath");
+	return target.drawPath (path, pen);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawString (RectRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment)
+{
+	recordString (toRectF (rect), text, font, brush, alignment);
+	return target.drawString (rect, text, font, brush, alignment);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawString (RectFRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment)
+{
+	recordString (rect, text, font, brush, alignment);
+	return target.drawString (rect, text, font, brush, alignment);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawString (PointRef point, StringRef text, FontRef font, BrushRef brush, int options)
+{
+	recordStringAt (toPointF (point), text, font, brush, options);
+	return target.drawString (point, text, font, brush, options);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawString (PointFRef point, StringRef text, FontRef font, BrushRef brush, int options)
+{
+	recordStringAt (point, text, font, brush, options);
+	return target.drawString (point, text, font, brush, options);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::measureString (Rect& size, StringRef text, FontRef font)
+{
+	return target.measureString (size, text, font);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::measureString (RectF& size, StringRef text, FontRef font)
+{
+	return target.measureString (size, text, font);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawText (RectRef rect, StringRef text, FontRef font, BrushRef brush, TextFormatRef format)
+{
+	if(capture)
+		capture->addUnrecorded ("drawText");
+	return target.drawText (rect, text, font, brush, format);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawText (RectFRef rect, StringRef text, FontRef font, BrushRef brush, TextFormatRef format)
+{
+	if(capture)
+		capture->addUnrecorded ("drawText");
+	return target.drawText (rect, text, font, brush, format);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::measureText (Rect& size, Coord lineWidth, StringRef text, FontRef font, TextFormatRef format)
+{
+	return target.measureText (size, lineWidth, text, font, format);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawTextLayout (PointRef position, ITextLayout* textLayout, BrushRef brush, int options)
+{
+	if(capture)
+		capture->addUnrecorded ("drawTextLayout");
+	return target.drawTextLayout (position, textLayout, brush, options);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawTextLayout (PointFRef position, ITextLayout* textLayout, BrushRef brush, int options)
+{
+	if(capture)
+		capture->addUnrecorded ("drawTextLayout");
+	return target.drawTextLayout (position, textLayout, brush, options);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawImage (IImage* image, PointRef position, const ImageMode* mode)
+{
+	recordImageAt (image, toPointF (position));
+	return target.drawImage (image, position, mode);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawImage (IImage* image, PointFRef position, const ImageMode* mode)
+{
+	recordImageAt (image, position);
+	return target.drawImage (image, position, mode);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawImage (IImage* image, RectRef src, RectRef dst, const ImageMode* mode)
+{
+	recordImage (image, toRectF (src), toRectF (dst));
+	return target.drawImage (image, src, dst, mode);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult CCL_API GraphicsRecorder::drawImage (IImage* image, RectFRef src, RectFRef dst, const ImageMode* mode)
+{
+	recordImage (image, src, dst);
+	return target.drawImage (image, src, dst, mode);
+}
+
+//************************************************************************************************
+// PageCapture
+//************************************************************************************************
+
+DEFINE_SINGLETON (PageCapture)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PageCapture::PageCapture ()
+: armed (false)
+{}
+
+//************************************************************************************************
+// CaptureView
+//************************************************************************************************
+
+CaptureView::CaptureView (RectRef size, StringRef pageName)
+: UserControl (size),
+  pageName (pageName)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CaptureView::draw (const DrawEvent& event)
+{
+	PageCapture& pageCapture = PageCapture::instance ();
+	if(!pageCapture.isArmed ())
+	{
+		UserControl::draw (event);
+		return;
+	}
+	pageCapture.setArmed (false);
+
+	// children draw into the event graphics, so they are recorded as well
+	Rect clientRect;
+	getClientRect (clientRect);
+	AutoPtr<GraphicsCapture> capture = NEW GraphicsCapture;
+	capture->setWidth (clientRect.getWidth ());
+	capture->setHeight (clientRect.getHeight ());
+	AutoPtr<GraphicsRecorder> recorder = NEW GraphicsRecorder (event.graphics, capture);
+	UserControl::draw (DrawEvent (*recorder, event.updateRgn));
+
+	String s;
+	s << pageName << ": ";
+	Url path;
+	if(!capture->isComplete ())
+		s << "capture failed, calls can't be recorded: " << capture->getUnrecordedCalls ();
+	else if(GraphicsCapture::getCapturePath (path, pageName) && capture->save (path))
+		s << capture->getCommandCount () << " calls, saved to " << UrlFullString (path);
+	else
+		s << capture->getCommandCount () << " calls, saving failed";
+	pageCapture.setLastResult (s);
+}
@@ -0,0 +1,260 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : graphicscapture.h
+// Description : Graphics Call Capture and Replay
+//
+//************************************************************************************************
+
+#ifndef _graphicscapture_h
+#define _graphicscapture_h
+
+#include "ccl/base/singleton.h"
+
+#include "ccl/app/controls/usercontrol.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// GraphicsCapture
+/** Recorded stream of graphics calls with their arguments. Texts and font faces are stored once
+	in a string table, images once in an image table, both referenced by index.
+
+	File layout (native little endian): "GCAP", version, frame width and height, string count,
+	image count, command count, strings (UTF-8 with length), images (width, height, premultiplied
+	RGBA rows), command byte count, commands (opcode byte followed by its arguments).
+
+	Calls that can't be recorded leave the capture incomplete, it is not saved then, because its
+	replay would profile a different frame. */
+//************************************************************************************************
+
+class GraphicsCapture: public Object
+{
+public:
+	GraphicsCapture ();
+	~GraphicsCapture ();
+
+	enum Opcode
+	{
+		kSaveState,
+		kRestoreState,
+		kClipRect,			///< rect
+		kClipEllipse,		///< rect
+		kTransform,			///< matrix
+		kSetMode,			///< mode
+		kClearRect,			///< rect
+		kFillRect,			///< rect, color
+		kFillGradientRect,	///< rect, start, end, color 1, color 2
+		kFillEllipse,		///< rect, color
+		kFillPolygon,		///< count, points, color
+		kDrawRect,			///< rect, pen
+		kDrawLine,			///< start, end, pen
+		kDrawEllipse,		///< rect, pen
+		kDrawString,		///< rect, text, font, color, alignment
+		kDrawStringAt,		///< position, text, font, color, options
+		kDrawImage,			///< image, src, dst
+		kDrawImageAt,		///< image, position
+
+		kNumOpcodes
+	};
+
+	static CStringPtr getOpcodeName (int opcode);
+
+	PROPERTY_BOOL (pending, Pending)	///< recording requested for the next frame
+	PROPERTY_VARIABLE (int, width, Width)	///< size of the captured frame, used for replay
+	PROPERTY_VARIABLE (int, height, Height)
+
+	void removeAll ();
+	bool isEmpty () const { return commandCount == 0; }
+	int getCommandCount () const { return commandCount; }
+	int getByteSize () const;
+
+	/** False if calls were drawn that can't be recorded. */
+	bool isComplete () const { return unrecordedCalls.isEmpty (); }
+	String getUnrecordedCalls () const;	///< names of those calls, comma separated
+
+	bool save (UrlRef path) const;	///< fails for incomplete captures
+	bool load (UrlRef path);
+
+	/** File in the Captures folder of the application settings. */
+	static bool getCapturePath (Url& path, StringRef name);
+
+	struct Timing
+	{
+		int count = 0;
+		double seconds = 0.;
+	};
+
+	/** Execute all commands, optionally with the time spent per opcode (timings[kNumOpcodes]). */
+	bool replay (IGraphics& graphics, Timing* timings = nullptr) const;
+
+	/** Replay iterations times into a bitmap of the frame size and report the time per call type. */
+	String profile (int iterations = 10) const;
+
+	// recording
+	void writeOpcode (Opcode opcode);
+	void writeInt (int32 value);
+	void writeFloat (float value);
+	void writeColor (ColorRef color);
+	void writeRect (RectFRef rect);
+	void writePoint (PointFRef point);
+	void writeString (StringRef string);
+	void writeFont (FontRef font);		///< face, size, style, mode, spacing and line spacing
+	void writePen (PenRef pen);			///< color, width, pen type, line cap and line join
+	void writeImage (IImage* image);	///< kept until saved or removed
+	void addUnrecorded (CStringPtr call);	///< call drawn to the target only, see isComplete ()
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+	Vector<String> strings;
+	Vector<uint8> commands;
+	Vector<String> unrecordedCalls;
+	int commandCount;
+
+	void write (const void* data, int size);
+};
+
+//************************************************************************************************
+// GraphicsRecorder
+/** IGraphics proxy that forwards every call to a target and records it into a capture while
+	one is set, so views and skin controls can draw into it like into any other graphics.
+
+	Integer overloads are forwarded unchanged, so the target snaps them like it always does.
+
+	Paths, text layouts, formatted text and gradient brushes are opaque to the recorder: they
+	are forwarded, but leave the capture incomplete. The additional calls below draw the shapes
+	of the stress test with plain arguments, so they can be recorded completely. */
+//************************************************************************************************
+
+class GraphicsRecorder: public Object,
+						public IGraphics
+{
+public:
+	GraphicsRecorder (IGraphics& target, GraphicsCapture* capture = nullptr);
+
+	IGraphics& getTarget () const { return target; }
+	bool isRecording () const { return capture != nullptr; }
+
+	// recordable replacements for path and gradient calls
+	void addClipEllipse (RectFRef rect);
+	void fillGradientRect (RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2);
+	void fillPolygon (const PointF points[], int count, ColorRef color);
+
+	// the same shapes drawn into any graphics, without recording
+	static void addClipEllipse (IGraphics& graphics, RectFRef rect);
+	static void fillGradientRect (IGraphics& graphics, RectFRef rect, PointFRef start, PointFRef end, ColorRef color1, ColorRef color2);
+	static void fillPolygon (IGraphics& graphics, const PointF points[], int count, ColorRef color);
+
+	// IGraphics
+	tresult CCL_API saveState () override;
+	tresult CCL_API restoreState () override;
+	tresult CCL_API addClip (RectRef rect) override;
+	tresult CCL_API addClip (RectFRef rect) override;
+	tresult CCL_API addClip (IGraphicsPath* path) override;
+	tresult CCL_API addTransform (TransformRef matrix) override;
+	tresult CCL_API setMode (int mode) override;
+	int CCL_API getMode () override;
+
+	tresult CCL_API clearRect (RectRef rect) override;
+	tresult CCL_API clearRect (RectFRef rect) override;
+	tresult CCL_API fillRect (RectRef rect, BrushRef brush) override;
+	tresult CCL_API fillRect (RectFRef rect, BrushRef brush) override;
+	tresult CCL_API drawRect (RectRef rect, PenRef pen) override;
+	tresult CCL_API drawRect (RectFRef rect, PenRef pen) override;
+	tresult CCL_API drawLine (PointRef start, PointRef end, PenRef pen) override;
+	tresult CCL_API drawLine (PointFRef start, PointFRef end, PenRef pen) override;
+	tresult CCL_API fillEllipse (RectRef rect, BrushRef brush) override;
+	tresult CCL_API fillEllipse (RectFRef rect, BrushRef brush) override;
+	tresult CCL_API drawEllipse (RectRef rect, PenRef pen) override;
+	tresult CCL_API drawEllipse (RectFRef rect, PenRef pen) override;
+	tresult CCL_API fillPath (IGraphicsPath* path, BrushRef brush) override;
+	tresult CCL_API drawPath (IGraphicsPath* path, PenRef pen) override;
+
+	tresult CCL_API drawString (RectRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment) override;
+	tresult CCL_API drawString (RectFRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment) override;
+	tresult CCL_API drawString (PointRef point, StringRef text, FontRef font, BrushRef brush, int options) override;
+	tresult CCL_API drawString (PointFRef point, StringRef text, FontRef font, BrushRef brush, int options) override;
+	tresult CCL_API measureString (Rect& size, StringRef text, FontRef font) override;
+	tresult CCL_API measureString (RectF& size, StringRef text, FontRef font) override;
+	tresult CCL_API drawText (RectRef rect, StringRef text, FontRef font, BrushRef brush, TextFormatRef format) override;
+	tresult CCL_API drawText (RectFRef rect, StringRef text, FontRef font, BrushRef brush, TextFormatRef format) override;
+	tresult CCL_API measureText (Rect& size, Coord lineWidth, StringRef text, FontRef font, TextFormatRef format) override;
+	tresult CCL_API drawTextLayout (PointRef position, ITextLayout* textLayout, BrushRef brush, int options) override;
+	tresult CCL_API drawTextLayout (PointFRef position, ITextLayout* textLayout, BrushRef brush, int options) override;
+
+	tresult CCL_API drawImage (IImage* image, PointRef position, const ImageMode* mode) override;
+	tresult CCL_API drawImage (IImage* image, PointFRef position, const ImageMode* mode) override;
+	tresult CCL_API drawImage (IImage* image, RectRef src, RectRef dst, const ImageMode* mode) override;
+	tresult CCL_API drawImage (IImage* image, RectFRef src, RectFRef dst, const ImageMode* mode) override;
+
+	CLASS_INTERFACE (IGraphics, Object)
+
+protected:
+	IGraphics& target;
+	GraphicsCapture* capture;
+
+	/** Solid brushes are recorded by their color, others leave the capture incomplete. */
+	bool isRecordable (CStringPtr call, BrushRef brush);
+
+	void recordRect (GraphicsCapture::Opcode opcode, RectFRef rect);
+	void recordFill (GraphicsCapture::Opcode opcode, CStringPtr call, RectFRef rect, BrushRef brush);
+	void recordStroke (GraphicsCapture::Opcode opcode, RectFRef rect, PenRef pen);
+	void recordLine (PointFRef start, PointFRef end, PenRef pen);
+	void recordString (RectFRef rect, StringRef text, FontRef font, BrushRef brush, AlignmentRef alignment);
+	void recordStringAt (PointFRef point, StringRef text, FontRef font, BrushRef brush, int options);
+	void recordImage (IImage* image, RectFRef src, RectFRef dst);
+	void recordImageAt (IImage* image, PointFRef position);
+};
+
+//************************************************************************************************
+// PageCapture
+/** Captures the first complete frame of the next demo page that is shown. While the capture
+	is armed, that page is hosted in a CaptureView, which draws itself and its children through
+	a GraphicsRecorder and saves the result as Captures/<page name>.gcap. */
+//************************************************************************************************
+
+class PageCapture: public Object,
+				   public Singleton<PageCapture>
+{
+public:
+	PageCapture ();
+
+	PROPERTY_BOOL (armed, Armed)
+	PROPERTY_STRING (lastResult, LastResult)	///< description of the last capture
+};
+
+//************************************************************************************************
+// CaptureView
+//************************************************************************************************
+
+class CaptureView: public UserControl
+{
+public:
+	CaptureView (RectRef size, StringRef pageName);
+
+	// UserControl
+	void draw (const DrawEvent& event) override;
+
+protected:
+	String pageName;
+};
+
+} // namespace CCL
+
+#endif // _graphicscapture_h
@@ -0,0 +1,242 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : instancedmodel.cpp
+// Description : Instanced Model
+//
+//************************************************************************************************
+
+#include "instancedmodel.h"
+#include "scenebvh.h"
+
+#include "../workerpool.h"
+
+#include <cmath>
+
+using namespace CCL;
+
+//************************************************************************************************
+// InstancedModel
+//************************************************************************************************
+
+InstancedModel::InstancedModel ()
+: threadCount (WorkerPool::getHardwareThreadCount ()),
+  source (nullptr)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void InstancedModel::setSource (const MeshData* _source)
+{
+	source = _source;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool InstancedModel::bake (MeshData& result)
+{
+	result.removeAll ();
+	changed.removeAll ();
+	bakedColors.removeAll ();
+	palette.removeAll ();
+	if(!source || source->isEmpty () || instances.isEmpty ())
+		return false;
+
+	int instanceCount = instances.count ();
+	int vertexCount = source->getVertexCount ();
+	if(int64 (vertexCount) * instanceCount > 0x7FFFFFFF || int64 (source->indices.count ()) * instanceCount > 0x7FFFFFFF)
+		return false;
+
+	// Instances with the same color share their groups, rank is the position within them
+	Vector<int> paletteFirst;
+	Vector<int> paletteCount;
+	Vector<int> instanceRank;
+	bakedColors.setCount (instanceCount);
+	instanceRank.setCount (instanceCount);
+	for(int i = 0; i < instanceCount; i++)
+	{
+		const float* color = instances[i].color;
+		int p = 0;
+		for(; p < paletteFirst.count (); p++)
+		{
+			const float* other = instances[paletteFirst[p]].color;
+			if(other[0] == color[0] && other[1] == color[1] && other[2] == color[2])
+				break;
+		}
+		if(p == paletteFirst.count ())
+		{
+			paletteFirst.add (i);
+			paletteCount.add (0);
+		}
+		bakedColors[i] = p;
+		instanceRank[i] = paletteCount[p]++;
+	}
+
+	Vector<MeshData::Group> sourceGroups;
+	if(source->groups.isEmpty ())
+	{
+		MeshData::Group group;
+		group.indexCount = source->indices.count ();
+		sourceGroups.add (group);
+	}
+	else
+		for(const MeshData::Group& group : source->groups)
+			sourceGroups.add (group);
+
+	// Materials per color: the source materials, plus a default one if a group has none
+	int sourceMaterialCount = source->materials.count ();
+	bool needsDefault = false;
+	for(const MeshData::Group& group : sourceGroups)
+		if(group.material < 0 || group.material >= sourceMaterialCount)
+			needsDefault = true;
+	int materialCount = sourceMaterialCount + (needsDefault ? 1 : 0);
+
+	for(int p = 0; p < paletteFirst.count (); p++)
+	{
+		const float* color = instances[paletteFirst[p]].color;
+		for(int m = 0; m < materialCount; m++)
+		{
+			MeshData::Material material = m < sourceMaterialCount ? source->materials[m] : MeshData::Material ();
+			for(int c = 0; c < 3; c++)
+				material.color[c] *= color[c];
+			result.materials.add (material);
+		}
+	}
+
+	int groupCount = sourceGroups.count ();
+	int32 firstIndex = 0;
+	for(int p = 0; p < paletteFirst.count (); p++)
+		for(const MeshData::Group& sourceGroup : sourceGroups)
+		{
+			int sourceMaterial = sourceGroup.material >= 0 && sourceGroup.material < sourceMaterialCount ? sourceGroup.material : sourceMaterialCount;
+
+			MeshData::Group group;
+			group.material = p * materialCount + sourceMaterial;
+			group.firstIndex = firstIndex;
+			group.indexCount = sourceGroup.indexCount * paletteCount[p];
+			result.groups.add (group);
+			firstIndex += group.indexCount;
+		}
+
+	for(int first : paletteFirst)
+		palette.add (PointF3D (instances[first].color[0], instances[first].color[1], instances[first].color[2]));
+
+	// Transform the vertices and copy the indices of each instance into its slot
+	result.positions.setCount (vertexCount * instanceCount);
+	result.normals.setCount (vertexCount * instanceCount);
+	result.textureCoordinates.setCount (vertexCount * instanceCount);
+	result.indices.setCount (firstIndex);
+
+	uint32* indices = result.indices.getItems ();
+	const MeshData::Group* groups = result.groups.getItems ();
+
+	WorkerPool::instance ().parallelFor (instanceCount, threadCount, [&] (int i)
+	{
+		transformInstance (result, i);
+
+		int32 base = i * vertexCount;
+		const MeshData::Group* colorGroups = groups + bakedColors[i] * groupCount;
+		for(int g = 0; g < groupCount; g++)
+		{
+			const MeshData::Group& sourceGroup = sourceGroups[g];
+			uint32* target = indices + colorGroups[g].firstIndex + instanceRank[i] * sourceGroup.indexCount;
+			const uint32* sourceIndices = source->indices.getItems () + sourceGroup.firstIndex;
+			for(int k = 0; k < sourceGroup.indexCount; k++)
+				target[k] = sourceIndices[k] + base;
+		}
+	});
+
+	result.computeBounds ();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void InstancedModel::transformInstance (MeshData& result, int index) const
+{
+	const Instance& instance = instances[index];
+	RotationMatrix3D rotation (instance.yaw, instance.pitch, instance.roll);
+	PointF3D inverseScale (1.f / instance.scale.x, 1.f / instance.scale.y, 1.f / instance.scale.z);
+
+	int vertexCount = source->getVertexCount ();
+	PointF3D* positions = result.positions.getItems () + index * vertexCount;
+	PointF3D* normals = result.normals.getItems () + index * vertexCount;
+	PointF* textureCoordinates = result.textureCoordinates.getItems () + index * vertexCount;
+	for(int v = 0; v < vertexCount; v++)
+	{
+		PointF3D p = source->positions[v];
+		p = rotation * PointF3D (p.x * instance.scale.x, p.y * instance.scale.y, p.z * instance.scale.z);
+		positions[v] = PointF3D (p.x + instance.position.x, p.y + instance.position.y, p.z + instance.position.z);
+
+		// normals transform with the inverse transpose, which for rotation and scale is rotation and inverse scale
+		PointF3D n = source->normals[v];
+		n = rotation * PointF3D (n.x * inverseScale.x, n.y * inverseScale.y, n.z * inverseScale.z);
+		float length = ::sqrtf (n.x * n.x + n.y * n.y + n.z * n.z);
+		normals[v] = length > 0.f ? PointF3D (n.x / length, n.y / length, n.z / length) : n;
+
+		textureCoordinates[v] = source->textureCoordinates[v];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void InstancedModel::invalidate (int index)
+{
+	for(int i : changed)
+		if(i == index)
+			return;
+	changed.add (index);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool InstancedModel::update (MeshData& result)
+{
+	// the slots of the instances in the result depend on their color group only
+	int instanceCount = instances.count ();
+	bool compatible = source && bakedColors.count () == instanceCount && result.positions.count () == source->getVertexCount () * instanceCount;
+	for(int i = 0; compatible && i < changed.count (); i++)
+	{
+		int index = changed[i];
+		if(index < 0 || index >= instanceCount)
+			return bake (result);
+		const float* color = instances[index].color;
+		const PointF3D& bakedColor = palette[bakedColors[index]];
+		compatible = color[0] == bakedColor.x && color[1] == bakedColor.y && color[2] == bakedColor.z;
+	}
+	if(!compatible)
+		return bake (result);
+
+	WorkerPool::instance ().parallelFor (changed.count (), threadCount, [&] (int i)
+	{
+		transformInstance (result, changed[i]);
+	});
+	changed.removeAll ();
+	result.computeBounds ();
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* InstancedModel::createModel (UrlRef folder, int* drawCount)
+{
+	MeshData baked;
+	if(!bake (baked))
+		return nullptr;
+
+	if(drawCount)
+		*drawCount = baked.groups.count ();
+	return baked.createModel (folder);
+}
@@ -0,0 +1,86 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : instancedmodel.h
+// Description : Instanced Model
+//
+//************************************************************************************************
+
+#ifndef _instancedmodel_h
+#define _instancedmodel_h
+
+#include "meshdata.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// InstancedModel
+/** Many copies of one mesh with their own transform and color. The instances are baked into a
+	single mesh with one group per material and instance color, so a scene node draws all of them
+	with as many draws as the source has materials times the number of distinct colors, instead
+	of one node and draw per copy. Baking transforms the vertices of each instance in parallel.
+
+	This is not GPU instancing: the 3D interfaces have no instanced draw, so every copy is stored
+	as transformed vertices. It saves nodes and draw calls, not vertex memory. After a bake,
+	instances marked as changed can be transformed again on their own with update (). */
+//************************************************************************************************
+
+class InstancedModel: public Object
+{
+public:
+	InstancedModel ();
+
+	struct Instance
+	{
+		PointF3D position;
+		PointF3D scale = PointF3D (1.f, 1.f, 1.f);
+		float yaw = 0.f;					///< radians
+		float pitch = 0.f;
+		float roll = 0.f;
+		float color[3] = {1.f, 1.f, 1.f};	///< multiplies the material color
+	};
+
+	PROPERTY_VARIABLE (int, threadCount, ThreadCount)
+
+	/** The mesh shared by all instances, must stay valid while baking. */
+	void setSource (const MeshData* source);
+
+	Vector<Instance> instances;
+
+	/** Build the combined mesh, fails if it exceeds the index range. */
+	bool bake (MeshData& result);
+
+	/** Mark an instance whose transform or color changed after the last bake. */
+	void invalidate (int index);
+
+	/** Transform the vertices of the changed instances into the result of the last bake again.
+		Bakes everything if instances were added or removed or a changed one has a new color. */
+	bool update (MeshData& result);
+
+	/** Bake and create a model from the result. Caller releases. */
+	IModel3D* createModel (UrlRef folder, int* drawCount = nullptr);
+
+protected:
+	const MeshData* source;
+	Vector<int> changed;
+	Vector<int> bakedColors;		///< index in palette per instance of the last bake
+	Vector<PointF3D> palette;		///< distinct instance colors (red, green, blue) of the last bake
+
+	void transformInstance (MeshData& result, int index) const;
+};
+
+} // namespace CCL
+
+#endif // _instancedmodel_h
@@ -0,0 +1,140 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : lodmodel.cpp
+// Description : Level of Detail Model
+//
+//************************************************************************************************
+
+#include "lodmodel.h"
+
+#include "ccl/public/math/mathprimitives.h"
+
+#include <cfloat>
+#include <cmath>
+
+using namespace CCL;
+
+//************************************************************************************************
+// LODModel
+//************************************************************************************************
+
+LODModel::LODModel (LODContent* content)
+: hysteresis (kDefaultHysteresis),
+  content (content),
+  currentLevel (-1)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+LODModel::~LODModel ()
+{
+	for(Level& level : levels)
+		if(level.model)
+			level.model->release ();
+	delete content;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LODModel::addLevel (float minScreenSize, int triangleCount)
+{
+	ASSERT (levels.isEmpty () || minScreenSize <= levels[levels.count () - 1].minScreenSize)
+	Level level;
+	level.minScreenSize = minScreenSize;
+	level.triangleCount = triangleCount;
+	levels.add (level);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LODModel::getTriangleCount (int level) const
+{
+	return level >= 0 && level < levels.count () ? levels[level].triangleCount : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* LODModel::getModel (int level)
+{
+	if(level < 0 || level >= levels.count ())
+		return nullptr;
+
+	Level& entry = levels[level];
+	if(!entry.model && content)
+		entry.model = content->createLevel (level);
+	return entry.model;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LODModel::selectLevel (float screenSize) const
+{
+	int count = levels.count ();
+	if(count == 0)
+		return -1;
+
+	if(currentLevel < 0)
+	{
+		int level = 0;
+		while(level < count - 1 && screenSize < levels[level].minScreenSize)
+			level++;
+		return level;
+	}
+
+	// finer levels need the size to exceed their threshold, coarser ones to fall below it
+	int level = currentLevel;
+	while(level > 0 && screenSize >= levels[level - 1].minScreenSize * (1.f + hysteresis))
+		level--;
+	while(level < count - 1 && screenSize < levels[level].minScreenSize * (1.f - hysteresis))
+		level++;
+	return level;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LODModel::update (IModelNode3D& node, float screenSize)
+{
+	int level = selectLevel (screenSize);
+	if(level == currentLevel)
+		return false;
+
+	IModel3D* model = getModel (level);
+	if(!model)
+		return false;
+
+	node.setModelData (model);
+	currentLevel = level;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+float LODModel::getScreenSize (ICamera3D& camera, PointF3DRef center, float radius, CoordF viewHeight)
+{
+	PointF3DRef position = camera.getPosition ();
+	float dx = center.x - position.x;
+	float dy = center.y - position.y;
+	float dz = center.z - position.z;
+	float distance = ::sqrtf (dx * dx + dy * dy + dz * dz);
+	if(distance <= radius)
+		return FLT_MAX;
+
+	float tanY = ::tanf (Math::degreesToRad (camera.getFieldOfViewAngle ()) * .5f);
+	if(tanY <= 0.f)
+		return FLT_MAX;
+
+	return radius / (distance * tanY) * viewHeight;
+}
@@ -0,0 +1,96 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : lodmodel.h
+// Description : Level of Detail Model
+//
+//************************************************************************************************
+
+#ifndef _lodmodel_h
+#define _lodmodel_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/collections/vector.h"
+#include "ccl/public/gui/graphics/3d/iscene3d.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// LODContent
+/** Creates the model of a detail level on demand, level 0 is the most detailed one. */
+//************************************************************************************************
+
+struct LODContent
+{
+	virtual ~LODContent () {}
+
+	virtual IModel3D* createLevel (int level) = 0;
+};
+
+//************************************************************************************************
+// LODModel
+/** Switches the model of a node between detail levels by its projected size on screen. Level
+	models are created on first use and kept. A level is left only when the size has moved past
+	its threshold by the hysteresis margin, so a node near a threshold does not flip between two
+	levels from frame to frame. */
+//************************************************************************************************
+
+class LODModel: public Object
+{
+public:
+	LODModel (LODContent* content);	///< takes ownership of content
+	~LODModel ();
+
+	static constexpr float kDefaultHysteresis = .2f;
+
+	PROPERTY_VARIABLE (float, hysteresis, Hysteresis)	///< relative margin around thresholds
+
+	/** Add levels from detailed to coarse, a level is meant for sizes from minScreenSize pixels up
+		to the threshold of the previous one. The last level should use 0. */
+	void addLevel (float minScreenSize, int triangleCount);
+
+	int countLevels () const { return levels.count (); }
+	int getTriangleCount (int level) const;
+	IModel3D* getModel (int level);
+
+	/** Level for a projected size, considering the current level for hysteresis. */
+	int selectLevel (float screenSize) const;
+
+	/** Select the level and assign its model to the node, returns true if the level changed. */
+	bool update (IModelNode3D& node, float screenSize);
+
+	int getCurrentLevel () const { return currentLevel; }
+
+	/** Projected diameter in pixels of a sphere, camera angles and field of view as in
+		Frustum3D::fromCamera (). */
+	static float getScreenSize (ICamera3D& camera, PointF3DRef center, float radius, CoordF viewHeight);
+
+protected:
+	struct Level
+	{
+		float minScreenSize = 0.f;
+		int triangleCount = 0;
+		IModel3D* model = nullptr;	///< owned, created on first use
+	};
+
+	LODContent* content;
+	Vector<Level> levels;
+	int currentLevel;
+};
+
+} // namespace CCL
+
+#endif // _lodmodel_h
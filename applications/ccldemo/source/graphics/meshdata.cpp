@@ -0,0 +1,348 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : meshdata.cpp
+// Description : Mesh Data
+//
+//************************************************************************************************
+
+#include "meshdata.h"
+
+#include "ccl/public/gui/graphics/3d/modelfactory3d.h"
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+#include "ccl/public/plugservices.h"
+#include "ccl/public/systemservices.h"
+
+#include <cfloat>
+#include <cstring>
+#include <vector>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MeshFormat
+{
+	static const char kMagic[4] = {'M', 'E', 'S', 'H'};
+	static constexpr int32 kMaxStringLength = 4096;
+	static constexpr int32 kMaxCount = 0x7FFFFFFF / 16;
+
+	struct Header
+	{
+		int32 version;
+		int32 reserved;
+		int64 sourceSize;
+		uint64 sourceHash;
+		int32 vertexCount;
+		int32 indexCount;
+		int32 groupCount;
+		int32 materialCount;
+		float bounds[6];
+	};
+
+	static bool writeStream (IStream& stream, const void* data, int64 size)
+	{
+		return size == 0 || stream.write (data, int (size)) == int (size);
+	}
+
+	static bool readStream (IStream& stream, void* data, int64 size)
+	{
+		return size == 0 || stream.read (data, int (size)) == int (size);
+	}
+
+	static bool writeString (IStream& stream, StringRef string)
+	{
+		MutableCString utf8 (string, Text::kUTF8);
+		int32 length = utf8.length ();
+		return writeStream (stream, &length, 4) && writeStream (stream, utf8.str (), length);
+	}
+
+	static bool readString (IStream& stream, String& string)
+	{
+		int32 length = 0;
+		if(!readStream (stream, &length, 4) || length < 0 || length > kMaxStringLength)
+			return false;
+
+		std::vector<char> buffer (length + 1, 0);
+		if(!readStream (stream, buffer.data (), length))
+			return false;
+
+		string.appendCString (Text::kUTF8, buffer.data ());
+		return true;
+	}
+
+	static Color toColor (const float color[3], float opacity)
+	{
+		auto channel = [] (float value) { return uint8 (ccl_bound (value, 0.f, 1.f) * 255.f + .5f); };
+		return Color (channel (color[0]), channel (color[1]), channel (color[2]), channel (opacity));
+	}
+}
+
+using namespace MeshFormat;
+
+//************************************************************************************************
+// MeshData
+//************************************************************************************************
+
+MeshData::MeshData ()
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshData::removeAll ()
+{
+	positions.removeAll ();
+	normals.removeAll ();
+	textureCoordinates.removeAll ();
+	indices.removeAll ();
+	groups.removeAll ();
+	materials.removeAll ();
+	boundsMin = boundsMax = PointF3D ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 MeshData::getByteSize () const
+{
+	return int64 (positions.count ()) * sizeof(PointF3D) + int64 (normals.count ()) * sizeof(PointF3D)
+		+ int64 (textureCoordinates.count ()) * sizeof(PointF) + int64 (indices.count ()) * sizeof(uint32);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshData::computeBounds ()
+{
+	if(positions.isEmpty ())
+	{
+		boundsMin = boundsMax = PointF3D ();
+		return;
+	}
+
+	boundsMin = PointF3D (FLT_MAX, FLT_MAX, FLT_MAX);
+	boundsMax = PointF3D (-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	for(const PointF3D& p : positions)
+	{
+		boundsMin.x = ccl_min (boundsMin.x, p.x);
+		boundsMin.y = ccl_min (boundsMin.y, p.y);
+		boundsMin.z = ccl_min (boundsMin.z, p.z);
+		boundsMax.x = ccl_max (boundsMax.x, p.x);
+		boundsMax.y = ccl_max (boundsMax.y, p.y);
+		boundsMax.z = ccl_max (boundsMax.z, p.z);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IModel3D* MeshData::createModel (UrlRef folder) const
+{
+	if(isEmpty ())
+		return nullptr;
+
+	IModel3D* model = ccl_new<IModel3D> (ClassID::Model3D);
+	if(!model)
+		return nullptr;
+
+	// materials are shared by all groups referencing them
+	Vector<IMaterial3D*> modelMaterials;
+	for(const Material& material : materials)
+	{
+		IMaterial3D* modelMaterial = nullptr;
+		if(!material.texture.isEmpty ())
+		{
+			Url texturePath (folder);
+			texturePath.descend (material.texture);
+			AutoPtr<IImage> texture = GraphicsFactory::loadImageFile (texturePath);
+			UnknownPtr<IBitmap> bitmap (texture);
+			if(bitmap.isValid ())
+			{
+				ITextureMaterial3D* textureMaterial = ModelFactory3D::createTextureMaterial (bitmap, toColor (material.color, 1.f));
+				textureMaterial->setOpacity (material.opacity);
+				modelMaterial = textureMaterial;
+			}
+		}
+		if(!modelMaterial)
+		{
+			modelMaterial = ModelFactory3D::createSolidColorMaterial (toColor (material.color, material.opacity));
+			if(UnknownPtr<ISolidColorMaterial3D> solidMaterial = modelMaterial)
+				solidMaterial->setShininess (material.shininess);
+		}
+		modelMaterials.add (modelMaterial);
+	}
+
+	auto addGeometry = [&] (const PointF3D* groupPositions, const PointF3D* groupNormals, const PointF* groupCoordinates, int vertexCount,
+							const uint32* groupIndices, int indexCount, int materialIndex)
+	{
+		IGeometry3D* geometry = model->createGeometry ();
+		geometry->setPositions (groupPositions, vertexCount);
+		geometry->setNormals (groupNormals, vertexCount);
+		geometry->setTextureCoordinates (groupCoordinates, vertexCount);
+		geometry->setIndices (groupIndices, indexCount);
+		if(materialIndex >= 0 && materialIndex < modelMaterials.count ())
+			geometry->setMaterial (modelMaterials[materialIndex]);
+		model->addGeometry (geometry);
+	};
+
+	if(groups.count () <= 1)
+	{
+		int materialIndex = groups.isEmpty () ? -1 : groups[0].material;
+		addGeometry (positions.getItems (), normals.getItems (), textureCoordinates.getItems (), positions.count (), indices.getItems (), indices.count (), materialIndex);
+	}
+	else
+	{
+		// each group gets the vertices it references only
+		std::vector<int32> remap (positions.count (), -1);
+		std::vector<PointF3D> groupPositions, groupNormals;
+		std::vector<PointF> groupCoordinates;
+		std::vector<uint32> groupIndices;
+		for(const Group& group : groups)
+		{
+			groupPositions.clear ();
+			groupNormals.clear ();
+			groupCoordinates.clear ();
+			groupIndices.clear ();
+			for(int i = group.firstIndex; i < group.firstIndex + group.indexCount; i++)
+			{
+				uint32 index = indices[i];
+				if(remap[index] < 0)
+				{
+					remap[index] = int32 (groupPositions.size ());
+					groupPositions.push_back (positions[index]);
+					groupNormals.push_back (normals[index]);
+					groupCoordinates.push_back (textureCoordinates[index]);
+				}
+				groupIndices.push_back (uint32 (remap[index]));
+			}
+			for(int i = group.firstIndex; i < group.firstIndex + group.indexCount; i++)
+				remap[indices[i]] = -1;
+
+			addGeometry (groupPositions.data (), groupNormals.data (), groupCoordinates.data (), int (groupPositions.size ()),
+						 groupIndices.data (), int (groupIndices.size ()), group.material);
+		}
+	}
+
+	for(IMaterial3D* modelMaterial : modelMaterials)
+		modelMaterial->release ();
+	return model;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool MeshData::save (UrlRef path, int64 sourceSize, uint64 sourceHash) const
+{
+	AutoPtr<IStream> stream = System::GetFileSystem ().openStream (path, IStream::kCreateMode);
+	if(!stream)
+		return false;
+
+	Header header = {};
+	header.version = kFileVersion;
+	header.sourceSize = sourceSize;
+	header.sourceHash = sourceHash;
+	header.vertexCount = positions.count ();
+	header.indexCount = indices.count ();
+	header.groupCount = groups.count ();
+	header.materialCount = materials.count ();
+	float bounds[6] = {boundsMin.x, boundsMin.y, boundsMin.z, boundsMax.x, boundsMax.y, boundsMax.z};
+	::memcpy (header.bounds, bounds, sizeof(bounds));
+
+	if(!writeStream (*stream, kMagic, 4) || !writeStream (*stream, &header, sizeof(header)))
+		return false;
+
+	int64 vertexCount = header.vertexCount;
+	if(!writeStream (*stream, positions.getItems (), vertexCount * sizeof(PointF3D))
+	   || !writeStream (*stream, normals.getItems (), vertexCount * sizeof(PointF3D))
+	   || !writeStream (*stream, textureCoordinates.getItems (), vertexCount * sizeof(PointF))
+	   || !writeStream (*stream, indices.getItems (), int64 (header.indexCount) * sizeof(uint32))
+	   || !writeStream (*stream, groups.getItems (), int64 (header.groupCount) * sizeof(Group)))
+		return false;
+
+	for(const Material& material : materials)
+	{
+		float values[5] = {material.color[0], material.color[1], material.color[2], material.shininess, material.opacity};
+		if(!writeString (*stream, material.name) || !writeStream (*stream, values, sizeof(values)) || !writeString (*stream, material.texture))
+			return false;
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool MeshData::load (UrlRef path, int64 sourceSize, uint64 sourceHash)
+{
+	removeAll ();
+
+	if(!System::GetFileSystem ().fileExists (path))
+		return false;
+
+	AutoPtr<IStream> stream = System::GetFileSystem ().openStream (path, IStream::kOpenMode);
+	if(!stream)
+		return false;
+
+	char magic[4] = {};
+	Header header = {};
+	if(!readStream (*stream, magic, 4) || ::memcmp (magic, kMagic, 4) != 0 || !readStream (*stream, &header, sizeof(header)))
+		return false;
+	if(header.version != kFileVersion || header.sourceSize != sourceSize || header.sourceHash != sourceHash)
+		return false;
+	if(header.vertexCount < 0 || header.vertexCount > kMaxCount || header.indexCount < 0 || header.indexCount > kMaxCount
+	   || header.groupCount < 0 || header.groupCount > kMaxCount || header.materialCount < 0 || header.materialCount > kMaxCount)
+		return false;
+
+	positions.setCount (header.vertexCount);
+	normals.setCount (header.vertexCount);
+	textureCoordinates.setCount (header.vertexCount);
+	indices.setCount (header.indexCount);
+	groups.setCount (header.groupCount);
+
+	int64 vertexCount = header.vertexCount;
+	bool result = readStream (*stream, positions.getItems (), vertexCount * sizeof(PointF3D))
+		&& readStream (*stream, normals.getItems (), vertexCount * sizeof(PointF3D))
+		&& readStream (*stream, textureCoordinates.getItems (), vertexCount * sizeof(PointF))
+		&& readStream (*stream, indices.getItems (), int64 (header.indexCount) * sizeof(uint32))
+		&& readStream (*stream, groups.getItems (), int64 (header.groupCount) * sizeof(Group));
+
+	for(int i = 0; result && i < header.materialCount; i++)
+	{
+		Material material;
+		float values[5] = {};
+		result = readString (*stream, material.name) && readStream (*stream, values, sizeof(values)) && readString (*stream, material.texture);
+		::memcpy (material.color, values, sizeof(material.color));
+		material.shininess = values[3];
+		material.opacity = values[4];
+		materials.add (material);
+	}
+
+	// indices must not point outside of the vertex arrays, groups outside of the indices or materials
+	for(int i = 0; result && i < indices.count (); i++)
+		result = indices[i] < uint32 (header.vertexCount);
+	for(int i = 0; result && i < groups.count (); i++)
+	{
+		const Group& group = groups[i];
+		result = group.firstIndex >= 0 && group.indexCount >= 0 && int64 (group.firstIndex) + group.indexCount <= indices.count ()
+			&& group.material >= -1 && group.material < materials.count ();
+	}
+
+	if(!result)
+	{
+		removeAll ();
+		return false;
+	}
+
+	boundsMin = PointF3D (header.bounds[0], header.bounds[1], header.bounds[2]);
+	boundsMax = PointF3D (header.bounds[3], header.bounds[4], header.bounds[5]);
+	return true;
+}
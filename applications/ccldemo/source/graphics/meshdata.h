@@ -0,0 +1,95 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : meshdata.h
+// Description : Mesh Data
+//
+//************************************************************************************************
+
+#ifndef _meshdata_h
+#define _meshdata_h
+
+#include "ccl/base/object.h"
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/gui/graphics/3d/iscene3d.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// MeshData
+/** Indexed triangle mesh in CPU memory. Vertices have a position, a normal and texture
+	coordinates (normals and texture coordinates are zero if the source has none), index
+	ranges are grouped by material.
+
+	Binary file layout (native little endian): "MESH", version, source size, source hash,
+	counts, bounds, vertex arrays, indices, groups, materials (strings are UTF-8 with length).
+	The source size and hash tell whether the file is still valid for its source. */
+//************************************************************************************************
+
+class MeshData: public Object
+{
+public:
+	MeshData ();
+
+	static constexpr int32 kFileVersion = 2;
+
+	struct Material
+	{
+		String name;
+		float color[3] = {.8f, .8f, .8f};	///< diffuse RGB
+		float shininess = 0.f;
+		float opacity = 1.f;
+		String texture;				///< diffuse map, relative to the source file
+	};
+
+	struct Group
+	{
+		int32 material = -1;		///< index in materials, -1 for the default material
+		int32 firstIndex = 0;
+		int32 indexCount = 0;
+	};
+
+	Vector<PointF3D> positions;
+	Vector<PointF3D> normals;
+	Vector<PointF> textureCoordinates;
+	Vector<uint32> indices;
+	Vector<Group> groups;
+	Vector<Material> materials;
+	PointF3D boundsMin;
+	PointF3D boundsMax;
+
+	int getVertexCount () const { return positions.count (); }
+	int getTriangleCount () const { return indices.count () / 3; }
+	bool isEmpty () const { return indices.isEmpty (); }
+	int64 getByteSize () const;
+
+	void removeAll ();
+	void computeBounds ();
+
+	/** Model with one geometry per group, materials are created from the material table.
+		Textures are resolved relative to the folder. Caller releases. */
+	IModel3D* createModel (UrlRef folder) const;
+
+	bool save (UrlRef path, int64 sourceSize, uint64 sourceHash) const;
+
+	/** Fails if the file has another version or was written for another source. */
+	bool load (UrlRef path, int64 sourceSize, uint64 sourceHash);
+};
+
+} // namespace CCL
+
+#endif // _meshdata_h
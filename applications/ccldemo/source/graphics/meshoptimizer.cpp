@@ -0,0 +1,648 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : meshoptimizer.cpp
+// Description : Mesh Optimizer
+//
+//************************************************************************************************
+
+#include "meshoptimizer.h"
+
+#include "ccl/public/systemservices.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MeshOptimization
+{
+	// vertex scoring after Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+	static constexpr int kScoringCacheSize = 32;
+	static constexpr int kMaxValence = 32;
+	static constexpr float kCacheDecayPower = 1.5f;
+	static constexpr float kLastTriangleScore = .75f;
+	static constexpr float kValenceBoostScale = 2.f;
+	static constexpr float kValenceBoostPower = .5f;
+
+	struct ScoreTable
+	{
+		float cache[kScoringCacheSize];
+		float valence[kMaxValence];
+
+		ScoreTable ()
+		{
+			for(int i = 0; i < kScoringCacheSize; i++)
+				cache[i] = i < 3 ? kLastTriangleScore : ::powf (1.f - float (i - 3) / (kScoringCacheSize - 3), kCacheDecayPower);
+			for(int i = 0; i < kMaxValence; i++)
+				valence[i] = i == 0 ? 0.f : kValenceBoostScale * ::powf (float (i), -kValenceBoostPower);
+		}
+
+		float getScore (int cachePosition, int remainingValence) const
+		{
+			if(remainingValence == 0)
+				return -1.f;
+
+			float score = valence[ccl_min (remainingValence, kMaxValence - 1)];
+			if(cachePosition >= 0)
+				score += cache[cachePosition];
+			return score;
+		}
+	};
+
+	struct VertexKey
+	{
+		float values[8];
+
+		bool operator == (const VertexKey& other) const
+		{
+			return ::memcmp (values, other.values, sizeof(values)) == 0;
+		}
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator () (const VertexKey& key) const
+		{
+			// FNV-1a over the bit patterns
+			uint32 bits[8];
+			::memcpy (bits, key.values, sizeof(bits));
+			uint64 hash = 14695981039346656037ull;
+			for(uint32 value : bits)
+				hash = (hash ^ value) * 1099511628211ull;
+			return size_t (hash);
+		}
+	};
+
+	inline PointF3D subtract (PointF3DRef a, PointF3DRef b)
+	{
+		return PointF3D (a.x - b.x, a.y - b.y, a.z - b.z);
+	}
+
+	inline PointF3D cross (PointF3DRef a, PointF3DRef b)
+	{
+		return PointF3D (a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	inline float dot (PointF3DRef a, PointF3DRef b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline float sign (float value)
+	{
+		return value < 0.f ? -1.f : 1.f;
+	}
+
+	inline uint16 toUnorm16 (float value, float minimum, float range)
+	{
+		float normalized = range > 0.f ? (value - minimum) / range : 0.f;
+		return uint16 (::lroundf (ccl_max (0.f, ccl_min (normalized, 1.f)) * 65535.f));
+	}
+
+	inline int16 toSnorm16 (float value)
+	{
+		return int16 (::lroundf (ccl_max (-1.f, ccl_min (value, 1.f)) * 32767.f));
+	}
+
+	inline double getMilliseconds (double startTime)
+	{
+		return (System::GetProfileTime () - startTime) * 1000.;
+	}
+
+	template <typename Body>
+	void forEachGroup (MeshData& mesh, Body body)
+	{
+		if(mesh.groups.isEmpty ())
+			body (0, mesh.indices.count ());
+		else
+			for(const MeshData::Group& group : mesh.groups)
+				body (group.firstIndex, group.indexCount);
+	}
+}
+
+using namespace MeshOptimization;
+
+//************************************************************************************************
+// MeshOptimizer
+//************************************************************************************************
+
+MeshOptimizer::MeshOptimizer ()
+: steps (kDefaultSteps)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::optimize (MeshData& mesh, Statistics* before, Statistics* after) const
+{
+	if(before)
+		*before = analyze (mesh);
+
+	if(mesh.indices.isEmpty ())
+		generateIndices (mesh);
+	if(steps & kDeduplicate)
+		deduplicate (mesh);
+
+	int vertexCount = mesh.getVertexCount ();
+	if(steps & kVertexCache)
+		forEachGroup (mesh, [&] (int first, int count) { optimizeVertexCache (mesh.indices.getItems () + first, count, vertexCount); });
+	if(steps & kOverdraw)
+		forEachGroup (mesh, [&] (int first, int count) { optimizeOverdraw (mesh.indices.getItems () + first, count, mesh); });
+	if(steps & kVertexFetch)
+		optimizeVertexFetch (mesh);
+
+	if(steps & kQuantize)
+	{
+		QuantizedMesh quantized;
+		quantize (quantized, mesh);
+		dequantize (mesh, quantized);
+	}
+
+	mesh.computeBounds ();
+	if(after)
+		*after = analyze (mesh);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+MeshOptimizer::Statistics MeshOptimizer::analyze (const MeshData& mesh)
+{
+	Statistics statistics;
+	statistics.vertexCount = mesh.getVertexCount ();
+	statistics.triangleCount = mesh.getTriangleCount ();
+	if(mesh.indices.isEmpty ())
+	{
+		// plain triangle list, every vertex is transformed
+		statistics.triangleCount = statistics.vertexCount / 3;
+		statistics.acmr = statistics.triangleCount > 0 ? 3.f : 0.f;
+		statistics.atvr = statistics.triangleCount > 0 ? 1.f : 0.f;
+	}
+	else
+	{
+		int misses = countCacheMisses (mesh.indices.getItems (), mesh.indices.count (), statistics.vertexCount);
+		statistics.acmr = float (misses) / statistics.triangleCount;
+		statistics.atvr = statistics.vertexCount > 0 ? float (misses) / statistics.vertexCount : 0.f;
+	}
+
+	statistics.byteSize = mesh.getByteSize ();
+	int indexSize = statistics.vertexCount <= 0x10000 ? 2 : 4;
+	statistics.quantizedByteSize = int64 (statistics.vertexCount) * sizeof(Quantized) + int64 (mesh.indices.count ()) * indexSize;
+	return statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int MeshOptimizer::countCacheMisses (const uint32* indices, int indexCount, int vertexCount, int cacheSize)
+{
+	// a vertex is cached while less than cacheSize other vertices entered after it
+	std::vector<int> timestamps (size_t (vertexCount), 0);
+	int time = cacheSize + 1;
+	int misses = 0;
+	for(int i = 0; i < indexCount; i++)
+	{
+		uint32 index = indices[i];
+		if(time - timestamps[index] > cacheSize)
+		{
+			timestamps[index] = time++;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::generateIndices (MeshData& mesh)
+{
+	// plain triangle list, every vertex is used once
+	int vertexCount = mesh.getVertexCount ();
+	if(vertexCount == 0 || vertexCount % 3 != 0)
+		return;
+
+	mesh.indices.setCount (vertexCount);
+	for(int i = 0; i < vertexCount; i++)
+		mesh.indices[i] = uint32 (i);
+
+	if(mesh.groups.isEmpty ())
+	{
+		MeshData::Group group;
+		group.indexCount = vertexCount;
+		mesh.groups.add (group);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::deduplicate (MeshData& mesh)
+{
+	int vertexCount = mesh.getVertexCount ();
+	std::unordered_map<VertexKey, uint32, VertexKeyHash> unique;
+	unique.reserve (size_t (vertexCount));
+	std::vector<uint32> remap (vertexCount);
+
+	int uniqueCount = 0;
+	for(int i = 0; i < vertexCount; i++)
+	{
+		PointF3DRef p = mesh.positions[i];
+		PointF3DRef n = mesh.normals[i];
+		PointF uv = mesh.textureCoordinates[i];
+		VertexKey key = {{p.x, p.y, p.z, n.x, n.y, n.z, uv.x, uv.y}};
+
+		auto result = unique.emplace (key, uint32 (uniqueCount));
+		if(result.second)
+		{
+			// unique vertices move to the front, in place
+			mesh.positions[uniqueCount] = p;
+			mesh.normals[uniqueCount] = n;
+			mesh.textureCoordinates[uniqueCount] = uv;
+			uniqueCount++;
+		}
+		remap[size_t (i)] = result.first->second;
+	}
+
+	if(uniqueCount == vertexCount)
+		return;
+
+	for(uint32& index : mesh.indices)
+		index = remap[index];
+	mesh.positions.setCount (uniqueCount);
+	mesh.normals.setCount (uniqueCount);
+	mesh.textureCoordinates.setCount (uniqueCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::optimizeVertexCache (uint32* indices, int indexCount, int vertexCount)
+{
+	static const ScoreTable scores;
+
+	int triangleCount = indexCount / 3;
+	if(triangleCount < 2)
+		return;
+
+	// triangles of each vertex, the ones not emitted yet are kept in front
+	std::vector<int> remaining (size_t (vertexCount), 0);
+	for(int i = 0; i < indexCount; i++)
+		remaining[indices[i]]++;
+
+	std::vector<int> offsets (size_t (vertexCount) + 1, 0);
+	for(int v = 0; v < vertexCount; v++)
+		offsets[size_t (v) + 1] = offsets[size_t (v)] + remaining[size_t (v)];
+
+	std::vector<int> adjacency (indexCount);
+	std::vector<int> fill (offsets.begin (), offsets.end () - 1);
+	for(int i = 0; i < indexCount; i++)
+		adjacency[size_t (fill[indices[i]]++)] = i / 3;
+
+	std::vector<int> cachePosition (size_t (vertexCount), -1);
+	std::vector<float> vertexScore (vertexCount);
+	for(int v = 0; v < vertexCount; v++)
+		vertexScore[size_t (v)] = scores.getScore (-1, remaining[size_t (v)]);
+
+	std::vector<float> triangleScore (triangleCount);
+	std::vector<bool> emitted (size_t (triangleCount), false);
+	int best = 0;
+	for(int t = 0; t < triangleCount; t++)
+	{
+		const uint32* triangle = indices + t * 3;
+		triangleScore[size_t (t)] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+		if(triangleScore[size_t (t)] > triangleScore[size_t (best)])
+			best = t;
+	}
+
+	std::vector<uint32> result;
+	result.reserve (size_t (indexCount));
+	uint32 cache[kScoringCacheSize + 3];
+	int cacheCount = 0;
+	int scanPosition = 0;
+
+	while(int (result.size ()) < triangleCount * 3)
+	{
+		// dead end: continue with the next triangle in the original order
+		if(best < 0)
+		{
+			while(emitted[size_t (scanPosition)])
+				scanPosition++;
+			best = scanPosition;
+		}
+
+		const uint32* triangle = indices + best * 3;
+		emitted[size_t (best)] = true;
+		for(int k = 0; k < 3; k++)
+		{
+			uint32 v = triangle[k];
+			result.push_back (v);
+
+			int* begin = adjacency.data () + offsets[v];
+			int* end = begin + remaining[v];
+			int* it = std::find (begin, end, best);
+			std::swap (*it, *(end - 1));
+			remaining[v]--;
+		}
+
+		// the triangle moves to the front of the LRU cache
+		uint32 newCache[kScoringCacheSize + 3];
+		int newCount = 0;
+		for(int k = 0; k < 3; k++)
+			newCache[newCount++] = triangle[k];
+		for(int i = 0; i < cacheCount; i++)
+			if(cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2])
+				newCache[newCount++] = cache[i];
+
+		for(int i = 0; i < newCount; i++)
+		{
+			uint32 v = newCache[i];
+			cachePosition[v] = i < kScoringCacheSize ? i : -1;
+			vertexScore[v] = scores.getScore (cachePosition[v], remaining[v]);
+		}
+
+		// rescore the triangles touching the cache, including vertices that just dropped out
+		best = -1;
+		float bestScore = -1.f;
+		for(int i = 0; i < newCount; i++)
+		{
+			uint32 v = newCache[i];
+			for(int j = offsets[v]; j < offsets[v] + remaining[v]; j++)
+			{
+				int t = adjacency[size_t (j)];
+				const uint32* other = indices + t * 3;
+				float score = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+				triangleScore[size_t (t)] = score;
+				if(score > bestScore)
+				{
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+
+		cacheCount = ccl_min (newCount, kScoringCacheSize);
+		::memcpy (cache, newCache, cacheCount * sizeof(uint32));
+	}
+
+	::memcpy (indices, result.data (), result.size () * sizeof(uint32));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::optimizeOverdraw (uint32* indices, int indexCount, const MeshData& mesh)
+{
+	// after Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+	int triangleCount = indexCount / 3;
+	if(triangleCount < 2)
+		return;
+
+	// clusters start where all three vertices miss the cache, reordering them costs no misses
+	std::vector<int> clusterStarts;
+	std::vector<int> timestamps (size_t (mesh.getVertexCount ()), 0);
+	int time = kCacheSize + 1;
+	for(int t = 0; t < triangleCount; t++)
+	{
+		int misses = 0;
+		for(int k = 0; k < 3; k++)
+		{
+			uint32 index = indices[t * 3 + k];
+			if(time - timestamps[index] > kCacheSize)
+			{
+				timestamps[index] = time++;
+				misses++;
+			}
+		}
+		if(misses == 3 || t == 0)
+			clusterStarts.push_back (t);
+	}
+
+	int clusterCount = int (clusterStarts.size ());
+	if(clusterCount < 2)
+		return;
+	clusterStarts.push_back (triangleCount);
+
+	// area weighted centers and normals
+	struct Cluster
+	{
+		PointF3D center;
+		PointF3D normal;
+		float area = 0.f;
+		float sortKey = 0.f;
+	};
+
+	std::vector<Cluster> clusters (clusterCount);
+	PointF3D meshCenter;
+	float meshArea = 0.f;
+	for(int c = 0; c < clusterCount; c++)
+	{
+		Cluster& cluster = clusters[size_t (c)];
+		for(int t = clusterStarts[size_t (c)]; t < clusterStarts[size_t (c) + 1]; t++)
+		{
+			PointF3DRef a = mesh.positions[int (indices[t * 3])];
+			PointF3DRef b = mesh.positions[int (indices[t * 3 + 1])];
+			PointF3DRef d = mesh.positions[int (indices[t * 3 + 2])];
+			PointF3D normal = cross (subtract (b, a), subtract (d, a));
+			float area = ::sqrtf (dot (normal, normal)) * .5f;
+
+			cluster.normal = PointF3D (cluster.normal.x + normal.x, cluster.normal.y + normal.y, cluster.normal.z + normal.z);
+			cluster.center.x += (a.x + b.x + d.x) / 3.f * area;
+			cluster.center.y += (a.y + b.y + d.y) / 3.f * area;
+			cluster.center.z += (a.z + b.z + d.z) / 3.f * area;
+			cluster.area += area;
+		}
+
+		meshCenter = PointF3D (meshCenter.x + cluster.center.x, meshCenter.y + cluster.center.y, meshCenter.z + cluster.center.z);
+		meshArea += cluster.area;
+		if(cluster.area > 0.f)
+			cluster.center = PointF3D (cluster.center.x / cluster.area, cluster.center.y / cluster.area, cluster.center.z / cluster.area);
+	}
+
+	if(meshArea <= 0.f)
+		return;
+	meshCenter = PointF3D (meshCenter.x / meshArea, meshCenter.y / meshArea, meshCenter.z / meshArea);
+
+	// clusters facing away from the center occlude the others and are drawn first
+	std::vector<int> order (clusterCount);
+	for(int c = 0; c < clusterCount; c++)
+	{
+		Cluster& cluster = clusters[size_t (c)];
+		float length = ::sqrtf (dot (cluster.normal, cluster.normal));
+		if(length > 0.f)
+			cluster.sortKey = dot (subtract (cluster.center, meshCenter), cluster.normal) / length;
+		order[size_t (c)] = c;
+	}
+	std::stable_sort (order.begin (), order.end (), [&] (int a, int b) { return clusters[size_t (a)].sortKey > clusters[size_t (b)].sortKey; });
+
+	std::vector<uint32> result;
+	result.reserve (size_t (indexCount));
+	for(int c : order)
+		result.insert (result.end (), indices + clusterStarts[size_t (c)] * 3, indices + clusterStarts[size_t (c) + 1] * 3);
+	::memcpy (indices, result.data (), result.size () * sizeof(uint32));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::optimizeVertexFetch (MeshData& mesh)
+{
+	// vertices in order of first use, unused ones are dropped
+	int vertexCount = mesh.getVertexCount ();
+	std::vector<int32> remap (size_t (vertexCount), -1);
+	std::vector<PointF3D> positions, normals;
+	std::vector<PointF> textureCoordinates;
+	positions.reserve (size_t (vertexCount));
+	normals.reserve (size_t (vertexCount));
+	textureCoordinates.reserve (size_t (vertexCount));
+	for(uint32& index : mesh.indices)
+	{
+		int32& target = remap[index];
+		if(target < 0)
+		{
+			target = int32 (positions.size ());
+			positions.push_back (mesh.positions[int (index)]);
+			normals.push_back (mesh.normals[int (index)]);
+			textureCoordinates.push_back (mesh.textureCoordinates[int (index)]);
+		}
+		index = uint32 (target);
+	}
+
+	int usedCount = int (positions.size ());
+	mesh.positions.setCount (usedCount);
+	mesh.normals.setCount (usedCount);
+	mesh.textureCoordinates.setCount (usedCount);
+	for(int i = 0; i < usedCount; i++)
+	{
+		mesh.positions[i] = positions[size_t (i)];
+		mesh.normals[i] = normals[size_t (i)];
+		mesh.textureCoordinates[i] = textureCoordinates[size_t (i)];
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::quantize (QuantizedMesh& result, const MeshData& mesh)
+{
+	int vertexCount = mesh.getVertexCount ();
+	result.vertices.setCount (vertexCount);
+	if(vertexCount == 0)
+		return;
+
+	PointF3D positionMax = mesh.positions[0];
+	PointF coordinateMax = mesh.textureCoordinates[0];
+	result.positionMin = positionMax;
+	result.coordinateMin = coordinateMax;
+	for(int i = 1; i < vertexCount; i++)
+	{
+		PointF3DRef p = mesh.positions[i];
+		result.positionMin = PointF3D (ccl_min (result.positionMin.x, p.x), ccl_min (result.positionMin.y, p.y), ccl_min (result.positionMin.z, p.z));
+		positionMax = PointF3D (ccl_max (positionMax.x, p.x), ccl_max (positionMax.y, p.y), ccl_max (positionMax.z, p.z));
+		PointF uv = mesh.textureCoordinates[i];
+		result.coordinateMin = PointF (ccl_min (result.coordinateMin.x, uv.x), ccl_min (result.coordinateMin.y, uv.y));
+		coordinateMax = PointF (ccl_max (coordinateMax.x, uv.x), ccl_max (coordinateMax.y, uv.y));
+	}
+
+	PointF3D positionRange = subtract (positionMax, result.positionMin);
+	PointF coordinateRange (coordinateMax.x - result.coordinateMin.x, coordinateMax.y - result.coordinateMin.y);
+	result.positionScale = PointF3D (positionRange.x / 65535.f, positionRange.y / 65535.f, positionRange.z / 65535.f);
+	result.coordinateScale = PointF (coordinateRange.x / 65535.f, coordinateRange.y / 65535.f);
+
+	for(int i = 0; i < vertexCount; i++)
+	{
+		Quantized& vertex = result.vertices[i];
+		PointF3DRef p = mesh.positions[i];
+		vertex.position[0] = toUnorm16 (p.x, result.positionMin.x, positionRange.x);
+		vertex.position[1] = toUnorm16 (p.y, result.positionMin.y, positionRange.y);
+		vertex.position[2] = toUnorm16 (p.z, result.positionMin.z, positionRange.z);
+
+		// project on the octahedron, the lower half is folded over the diagonals
+		PointF3DRef n = mesh.normals[i];
+		float sum = ::fabsf (n.x) + ::fabsf (n.y) + ::fabsf (n.z);
+		float x = sum > 0.f ? n.x / sum : 0.f;
+		float y = sum > 0.f ? n.y / sum : 0.f;
+		if(n.z < 0.f)
+		{
+			float foldedX = (1.f - ::fabsf (y)) * sign (x);
+			y = (1.f - ::fabsf (x)) * sign (y);
+			x = foldedX;
+		}
+		vertex.normal[0] = toSnorm16 (x);
+		vertex.normal[1] = toSnorm16 (y);
+
+		PointF uv = mesh.textureCoordinates[i];
+		vertex.textureCoordinate[0] = toUnorm16 (uv.x, result.coordinateMin.x, coordinateRange.x);
+		vertex.textureCoordinate[1] = toUnorm16 (uv.y, result.coordinateMin.y, coordinateRange.y);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void MeshOptimizer::dequantize (MeshData& mesh, const QuantizedMesh& quantized)
+{
+	int vertexCount = quantized.vertices.count ();
+	mesh.positions.setCount (vertexCount);
+	mesh.normals.setCount (vertexCount);
+	mesh.textureCoordinates.setCount (vertexCount);
+
+	for(int i = 0; i < vertexCount; i++)
+	{
+		const Quantized& vertex = quantized.vertices[i];
+		mesh.positions[i] = PointF3D (quantized.positionMin.x + vertex.position[0] * quantized.positionScale.x,
+									  quantized.positionMin.y + vertex.position[1] * quantized.positionScale.y,
+									  quantized.positionMin.z + vertex.position[2] * quantized.positionScale.z);
+
+		float x = vertex.normal[0] / 32767.f;
+		float y = vertex.normal[1] / 32767.f;
+		float z = 1.f - ::fabsf (x) - ::fabsf (y);
+		if(z < 0.f)
+		{
+			float unfoldedX = (1.f - ::fabsf (y)) * sign (x);
+			y = (1.f - ::fabsf (x)) * sign (y);
+			x = unfoldedX;
+		}
+		float length = ::sqrtf (x * x + y * y + z * z);
+		mesh.normals[i] = length > 0.f ? PointF3D (x / length, y / length, z / length) : PointF3D ();
+
+		mesh.textureCoordinates[i] = PointF (quantized.coordinateMin.x + vertex.textureCoordinate[0] * quantized.coordinateScale.x,
+											 quantized.coordinateMin.y + vertex.textureCoordinate[1] * quantized.coordinateScale.y);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String MeshOptimizer::runBenchmark (MeshData& mesh, int steps)
+{
+	MeshOptimizer optimizer;
+	optimizer.setSteps (steps);
+	Statistics before, after;
+	double startTime = System::GetProfileTime ();
+	optimizer.optimize (mesh, &before, &after);
+	double optimizeMs = getMilliseconds (startTime);
+
+	String s;
+	s << before.vertexCount << " -> " << after.vertexCount << " vertices, " << after.triangleCount << " triangles | ACMR ";
+	s.appendFloatValue (before.acmr, 2);
+	s << " -> ";
+	s.appendFloatValue (after.acmr, 2);
+	s << ", ATVR ";
+	s.appendFloatValue (before.atvr, 2);
+	s << " -> ";
+	s.appendFloatValue (after.atvr, 2);
+	s << " | " << before.byteSize / 1024 << " KB -> " << after.byteSize / 1024 << " KB, " << after.quantizedByteSize / 1024 << " KB quantized | ";
+	s.appendFloatValue (optimizeMs, 2);
+	s << "ms";
+	return s;
+}
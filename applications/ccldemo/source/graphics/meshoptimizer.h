@@ -0,0 +1,115 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : meshoptimizer.h
+// Description : Mesh Optimizer
+//
+//************************************************************************************************
+
+#ifndef _meshoptimizer_h
+#define _meshoptimizer_h
+
+#include "meshdata.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// MeshOptimizer
+/** Prepares a MeshData for drawing. Steps run in this order:
+
+	- deduplication merges vertices with identical attributes (indices are generated first for
+	  meshes that have none, i.e. plain triangle lists)
+	- vertex cache ordering sorts the triangles of each group for a small post-transform cache
+	  (Forsyth's greedy scoring)
+	- overdraw ordering moves clusters of triangles facing outwards to the front of each group,
+	  clusters start where the simulated cache runs cold, so the cache order is kept
+	- vertex fetch ordering renumbers vertices in the order of first use
+	- quantization rounds the vertices to the Quantized format (16 bit positions, octahedral
+	  normals), the mesh keeps floats but holds exactly the values the compact format decodes to
+
+	Triangles never move between groups. */
+//************************************************************************************************
+
+class MeshOptimizer: public Object
+{
+public:
+	MeshOptimizer ();
+
+	enum Steps
+	{
+		kDeduplicate = 1<<0,
+		kVertexCache = 1<<1,
+		kOverdraw = 1<<2,
+		kVertexFetch = 1<<3,
+		kQuantize = 1<<4,
+
+		kDefaultSteps = kDeduplicate|kVertexCache|kOverdraw|kVertexFetch
+	};
+
+	static constexpr int kCacheSize = 16;	///< FIFO entries of the simulated vertex cache
+
+	PROPERTY_VARIABLE (int, steps, Steps)
+
+	struct Statistics
+	{
+		int vertexCount = 0;
+		int triangleCount = 0;
+		float acmr = 0.f;				///< cache misses per triangle, 0.5 to 3
+		float atvr = 0.f;				///< cache misses per vertex, 1 is optimal
+		int64 byteSize = 0;				///< float vertices, 32 bit indices
+		int64 quantizedByteSize = 0;	///< Quantized vertices, 16 bit indices where they fit
+	};
+
+	void optimize (MeshData& mesh, Statistics* before = nullptr, Statistics* after = nullptr) const;
+
+	static Statistics analyze (const MeshData& mesh);
+
+	/** Cache misses of the triangles in indices with a FIFO cache of cacheSize vertices. */
+	static int countCacheMisses (const uint32* indices, int indexCount, int vertexCount, int cacheSize = kCacheSize);
+
+	/** Compact vertex format, decoded with the bounds of the mesh. */
+	struct Quantized
+	{
+		uint16 position[3];			///< unorm within the position bounds
+		int16 normal[2];			///< snorm, octahedral encoding
+		uint16 textureCoordinate[2];	///< unorm within the texture coordinate bounds
+	};
+
+	struct QuantizedMesh
+	{
+		Vector<Quantized> vertices;
+		PointF3D positionMin;
+		PointF3D positionScale;		///< bounds size / 65535
+		PointF coordinateMin;
+		PointF coordinateScale;
+	};
+
+	static void quantize (QuantizedMesh& result, const MeshData& mesh);
+	static void dequantize (MeshData& mesh, const QuantizedMesh& quantized);
+
+	/** Optimize the mesh and describe the gain and the time taken. */
+	static String runBenchmark (MeshData& mesh, int steps = kDefaultSteps);
+
+protected:
+	static void generateIndices (MeshData& mesh);
+	static void deduplicate (MeshData& mesh);
+	static void optimizeVertexCache (uint32* indices, int indexCount, int vertexCount);
+	static void optimizeOverdraw (uint32* indices, int indexCount, const MeshData& mesh);
+	static void optimizeVertexFetch (MeshData& mesh);
+};
+
+} // namespace CCL
+
+#endif // _meshoptimizer_h
@@ -0,0 +1,1006 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : objimporter.cpp
+// Description : OBJ Importer
+//
+//************************************************************************************************
+
+#include "objimporter.h"
+#include "meshoptimizer.h"
+
+#include "../workerpool.h"
+
+#include "ccl/public/system/inativefilesystem.h"
+#include "ccl/public/system/isysteminfo.h"
+#include "ccl/public/systemservices.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !CCL_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace ObjFormat
+{
+	//********************************************************************************************
+	// MappedFile
+	/** Read-only view of a whole file, memory mapped where available, read into one buffer
+		otherwise. */
+	//********************************************************************************************
+
+	class MappedFile
+	{
+	public:
+		MappedFile ()
+		: data (nullptr),
+		  size (0),
+		  mapping (nullptr)
+		{}
+
+		~MappedFile ()
+		{
+			#if !CCL_PLATFORM_WINDOWS
+			if(mapping)
+				::munmap (mapping, size_t (size));
+			#endif
+		}
+
+		bool open (UrlRef path)
+		{
+			#if !CCL_PLATFORM_WINDOWS
+			// file URLs display as native paths
+			MutableCString nativePath (UrlDisplayString (path), Text::kUTF8);
+			int fd = ::open (nativePath.str (), O_RDONLY);
+			if(fd >= 0)
+			{
+				struct stat info;
+				if(::fstat (fd, &info) == 0 && info.st_size > 0)
+				{
+					void* address = ::mmap (nullptr, size_t (info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+					if(address != MAP_FAILED)
+					{
+						::madvise (address, size_t (info.st_size), MADV_WILLNEED);
+						mapping = address;
+						data = static_cast<const char*> (address);
+						size = int64 (info.st_size);
+					}
+				}
+				::close (fd);
+				if(mapping)
+					return true;
+			}
+			#endif
+
+			AutoPtr<IStream> stream = System::GetFileSystem ().openStream (path, IStream::kOpenMode);
+			if(!stream)
+				return false;
+
+			static constexpr int kBlockSize = 1 << 20;
+			for(;;)
+			{
+				size_t offset = buffer.size ();
+				buffer.resize (offset + kBlockSize);
+				int bytesRead = stream->read (buffer.data () + offset, kBlockSize);
+				buffer.resize (offset + ccl_max (bytesRead, 0));
+				if(bytesRead < kBlockSize)
+					break;
+			}
+			data = buffer.data ();
+			size = int64 (buffer.size ());
+			return true;
+		}
+
+		const char* getData () const { return data; }
+		int64 getSize () const { return size; }
+
+	private:
+		const char* data;
+		int64 size;
+		void* mapping;
+		std::vector<char> buffer;
+	};
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	// Number parsing
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	static const double kPowersOf10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	inline bool isSpace (char c) { return c == ' ' || c == '\t'; }
+	inline bool isDigit (char c) { return c >= '0' && c <= '9'; }
+
+	/** True if all of the eight bytes at p are ASCII digits, tested in one 64 bit word. */
+	inline bool hasEightDigits (const char* p)
+	{
+		uint64 value;
+		::memcpy (&value, p, 8);
+		return (((value & 0xF0F0F0F0F0F0F0F0ull) | (((value + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+	}
+
+	/** Value of eight ASCII digits, combined pairwise in three multiplications (little endian). */
+	inline uint32 parseEightDigits (const char* p)
+	{
+		uint64 value;
+		::memcpy (&value, p, 8);
+		value -= 0x3030303030303030ull;
+		value = (value * 10) + (value >> 8);
+		value = (((value & 0x000000FF000000FFull) * 0x000F424000000064ull) + (((value >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+		return uint32 (value);
+	}
+
+	/** Parse a decimal number with optional fraction and exponent, p is advanced past it. */
+	static bool parseFloat (const char*& p, const char* end, float& result)
+	{
+		while(p < end && isSpace (*p))
+			p++;
+
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		uint64 mantissa = 0;
+		int exponent = 0;
+		auto readDigits = [&] (bool fraction)
+		{
+			const char* start = p;
+
+			// eight at a time as long as the mantissa can't overflow
+			while(end - p >= 8 && mantissa < 10000000000ull && hasEightDigits (p))
+			{
+				mantissa = mantissa * 100000000ull + parseEightDigits (p);
+				p += 8;
+				if(fraction)
+					exponent -= 8;
+			}
+
+			// digits beyond the precision of the mantissa only count in the integer part
+			while(p < end && isDigit (*p))
+			{
+				if(mantissa < 100000000000000000ull)
+				{
+					mantissa = mantissa * 10 + uint64 (*p - '0');
+					if(fraction)
+						exponent--;
+				}
+				else if(!fraction)
+					exponent++;
+				p++;
+			}
+			return p != start;
+		};
+
+		bool hasDigits = readDigits (false);
+		if(p < end && *p == '.')
+		{
+			p++;
+			hasDigits |= readDigits (true);
+		}
+		if(!hasDigits)
+			return false;
+
+		if(p < end && (*p == 'e' || *p == 'E'))
+		{
+			const char* e = p + 1;
+			bool negativeExponent = false;
+			if(e < end && (*e == '-' || *e == '+'))
+				negativeExponent = *e++ == '-';
+			if(e < end && isDigit (*e))
+			{
+				int value = 0;
+				for(; e < end && isDigit (*e); e++)
+					if(value < 10000)
+						value = value * 10 + (*e - '0');
+				exponent += negativeExponent ? -value : value;
+				p = e;
+			}
+		}
+
+		double value = double (mantissa);
+		for(; exponent > 22; exponent -= 22)
+			value *= 1e22;
+		for(; exponent < -22; exponent += 22)
+			value /= 1e22;
+		value = exponent >= 0 ? value * kPowersOf10[exponent] : value / kPowersOf10[-exponent];
+		result = float (negative ? -value : value);
+		return true;
+	}
+
+	static bool parseInt (const char*& p, const char* end, int64& result)
+	{
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+		if(p >= end || !isDigit (*p))
+			return false;
+
+		int64 value = 0;
+		for(; p < end && isDigit (*p); p++)
+			if(value < 0x7FFFFFFF)
+				value = value * 10 + (*p - '0');
+		result = negative ? -value : value;
+		return true;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	// Lines
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Next line without leading white space and trailing line break, p is advanced past it. */
+	inline void nextLine (const char*& lineStart, const char*& lineEnd, const char*& p, const char* end)
+	{
+		while(p < end && isSpace (*p))
+			p++;
+		lineStart = p;
+		const char* newline = static_cast<const char*> (::memchr (p, '\n', size_t (end - p)));
+		p = newline ? newline + 1 : end;
+		lineEnd = newline ? newline : end;
+		if(lineEnd > lineStart && lineEnd[-1] == '\r')
+			lineEnd--;
+	}
+
+	inline bool hasKeyword (const char* line, const char* lineEnd, const char* keyword, int length)
+	{
+		return lineEnd - line > length && ::memcmp (line, keyword, size_t (length)) == 0 && isSpace (line[length]);
+	}
+
+	inline std::string getArgument (const char* line, const char* lineEnd, int keywordLength)
+	{
+		const char* p = line + keywordLength;
+		while(p < lineEnd && isSpace (*p))
+			p++;
+		const char* e = lineEnd;
+		while(e > p && isSpace (e[-1]))
+			e--;
+		return std::string (p, size_t (e - p));
+	}
+
+	static int countTokens (const char* p, const char* end)
+	{
+		int count = 0;
+		while(p < end)
+		{
+			while(p < end && isSpace (*p))
+				p++;
+			if(p >= end || *p == '#')
+				break;
+			count++;
+			while(p < end && !isSpace (*p))
+				p++;
+		}
+		return count;
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	// Chunks
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	static constexpr int64 kMinChunkSize = 64 * 1024;
+
+	static void addMaterialLibrary (std::vector<std::string>& libraries, const std::string& name)
+	{
+		for(const std::string& library : libraries)
+			if(library == name)
+				return;
+		libraries.push_back (name);
+	}
+
+	/** Names of all mtllib statements without parsing the rest, searching for their first
+		letter, which is rare in OBJ data. */
+	static void findMaterialLibraries (std::vector<std::string>& libraries, const char* data, int64 size)
+	{
+		const char* end = data + size;
+		for(const char* p = data; p < end; p++)
+		{
+			p = static_cast<const char*> (::memchr (p, 'm', size_t (end - p)));
+			if(!p)
+				break;
+			if(p > data && p[-1] != '\n' && !isSpace (p[-1]))
+				continue;
+
+			const char* newline = static_cast<const char*> (::memchr (p, '\n', size_t (end - p)));
+			const char* lineEnd = newline ? newline : end;
+			if(lineEnd > p && lineEnd[-1] == '\r')
+				lineEnd--;
+			if(hasKeyword (p, lineEnd, "mtllib", 6))
+				addMaterialLibrary (libraries, getArgument (p, lineEnd, 6));
+		}
+	}
+
+	static Url getMaterialLibraryPath (UrlRef path, const std::string& library)
+	{
+		Url libraryPath (path);
+		libraryPath.ascend ();
+		String name;
+		name.appendCString (Text::kUTF8, library.c_str ());
+		libraryPath.descend (name);
+		return libraryPath;
+	}
+
+	struct Corner
+	{
+		int32 position;
+		int32 coordinate;		///< -1 if missing
+		int32 normal;			///< -1 if missing
+
+		bool operator == (const Corner& other) const
+		{
+			return position == other.position && coordinate == other.coordinate && normal == other.normal;
+		}
+	};
+
+	struct CornerHash
+	{
+		size_t operator () (const Corner& corner) const
+		{
+			uint64 h = uint64 (uint32 (corner.position)) * 0x9E3779B97F4A7C15ull;
+			h ^= uint64 (uint32 (corner.coordinate)) * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+			h ^= uint64 (uint32 (corner.normal)) * 0x165667B19E3779F9ull + (h >> 31);
+			return size_t (h);
+		}
+	};
+
+	struct MaterialSwitch
+	{
+		int64 triangle;
+		std::string name;
+	};
+
+	struct Chunk
+	{
+		const char* begin = nullptr;
+		const char* end = nullptr;
+
+		int64 positionCount = 0;
+		int64 coordinateCount = 0;
+		int64 normalCount = 0;
+		int64 triangleCount = 0;
+
+		int64 positionOffset = 0;
+		int64 coordinateOffset = 0;
+		int64 normalOffset = 0;
+		int64 triangleOffset = 0;
+
+		std::vector<std::string> materialLibraries;
+		std::vector<MaterialSwitch> materialSwitches;
+		bool failed = false;
+	};
+
+	struct Arrays
+	{
+		std::vector<PointF3D> positions;
+		std::vector<PointF> coordinates;
+		std::vector<PointF3D> normals;
+		std::vector<Corner> corners;		///< three per triangle
+	};
+
+	static void splitChunks (std::vector<Chunk>& chunks, const char* data, int64 size, int threadCount)
+	{
+		int64 chunkSize = ccl_max (kMinChunkSize, size / (threadCount * 4) + 1);
+		const char* end = data + size;
+		for(const char* p = data; p < end;)
+		{
+			Chunk chunk;
+			chunk.begin = p;
+			const char* split = end - p > chunkSize ? p + chunkSize : end;
+			const char* newline = split < end ? static_cast<const char*> (::memchr (split, '\n', size_t (end - split))) : nullptr;
+			chunk.end = newline ? newline + 1 : end;
+			chunks.push_back (chunk);
+			p = chunk.end;
+		}
+	}
+
+	/** First pass: number of elements of each kind in the chunk. */
+	static void countChunk (Chunk& chunk)
+	{
+		const char* line = nullptr;
+		const char* lineEnd = nullptr;
+		for(const char* p = chunk.begin; p < chunk.end;)
+		{
+			nextLine (line, lineEnd, p, chunk.end);
+			if(lineEnd - line < 2)
+				continue;
+
+			if(line[0] == 'v')
+			{
+				if(isSpace (line[1]))
+					chunk.positionCount++;
+				else if(line[1] == 't' && hasKeyword (line, lineEnd, "vt", 2))
+					chunk.coordinateCount++;
+				else if(line[1] == 'n' && hasKeyword (line, lineEnd, "vn", 2))
+					chunk.normalCount++;
+			}
+			else if(line[0] == 'f' && isSpace (line[1]))
+				chunk.triangleCount += ccl_max (countTokens (line + 1, lineEnd) - 2, 0);
+			else if(hasKeyword (line, lineEnd, "mtllib", 6))
+				addMaterialLibrary (chunk.materialLibraries, getArgument (line, lineEnd, 6));
+		}
+	}
+
+	/** Resolve a 1-based or relative OBJ index against the number of elements read so far. */
+	inline int32 resolveIndex (int64 index, int64 countSoFar, int64 totalCount)
+	{
+		int64 resolved = index > 0 ? index - 1 : countSoFar + index;
+		return resolved >= 0 && resolved < totalCount ? int32 (resolved) : -1;
+	}
+
+	/** Second pass: parse the elements into their final place in the arrays. */
+	static void parseChunk (Chunk& chunk, Arrays& arrays)
+	{
+		int64 positionIndex = chunk.positionOffset;
+		int64 coordinateIndex = chunk.coordinateOffset;
+		int64 normalIndex = chunk.normalOffset;
+		int64 triangleIndex = chunk.triangleOffset;
+		int64 positionTotal = int64 (arrays.positions.size ());
+		int64 coordinateTotal = int64 (arrays.coordinates.size ());
+		int64 normalTotal = int64 (arrays.normals.size ());
+		std::vector<Corner> face;
+
+		const char* line = nullptr;
+		const char* lineEnd = nullptr;
+		for(const char* p = chunk.begin; p < chunk.end && !chunk.failed;)
+		{
+			nextLine (line, lineEnd, p, chunk.end);
+			if(lineEnd - line < 2)
+				continue;
+
+			const char* q = line + 2;
+			if(line[0] == 'v' && isSpace (line[1]))
+			{
+				PointF3D& position = arrays.positions[size_t (positionIndex++)];
+				chunk.failed = !parseFloat (q, lineEnd, position.x) || !parseFloat (q, lineEnd, position.y) || !parseFloat (q, lineEnd, position.z);
+			}
+			else if(line[0] == 'v' && line[1] == 't' && hasKeyword (line, lineEnd, "vt", 2))
+			{
+				q = line + 3;
+				PointF& coordinate = arrays.coordinates[size_t (coordinateIndex++)];
+				chunk.failed = !parseFloat (q, lineEnd, coordinate.x);
+				if(!parseFloat (q, lineEnd, coordinate.y))
+					coordinate.y = 0.f;
+			}
+			else if(line[0] == 'v' && line[1] == 'n' && hasKeyword (line, lineEnd, "vn", 2))
+			{
+				q = line + 3;
+				PointF3D& normal = arrays.normals[size_t (normalIndex++)];
+				chunk.failed = !parseFloat (q, lineEnd, normal.x) || !parseFloat (q, lineEnd, normal.y) || !parseFloat (q, lineEnd, normal.z);
+			}
+			else if(line[0] == 'f' && isSpace (line[1]))
+			{
+				face.clear ();
+				q = line + 1;
+				while(q < lineEnd)
+				{
+					while(q < lineEnd && isSpace (*q))
+						q++;
+					if(q >= lineEnd || *q == '#')
+						break;
+
+					// v, v/vt, v//vn or v/vt/vn
+					int64 value = 0;
+					Corner corner {-1, -1, -1};
+					if(!parseInt (q, lineEnd, value))
+					{
+						chunk.failed = true;
+						break;
+					}
+					corner.position = resolveIndex (value, positionIndex, positionTotal);
+					if(q < lineEnd && *q == '/')
+					{
+						q++;
+						if(parseInt (q, lineEnd, value))
+							corner.coordinate = resolveIndex (value, coordinateIndex, coordinateTotal);
+						if(q < lineEnd && *q == '/')
+						{
+							q++;
+							if(parseInt (q, lineEnd, value))
+								corner.normal = resolveIndex (value, normalIndex, normalTotal);
+						}
+					}
+					if(corner.position < 0)
+					{
+						chunk.failed = true;
+						break;
+					}
+					face.push_back (corner);
+					while(q < lineEnd && !isSpace (*q))
+						q++;
+				}
+
+				// fan triangulation
+				for(size_t i = 2; i < face.size () && !chunk.failed; i++)
+				{
+					Corner* triangle = &arrays.corners[size_t (triangleIndex++) * 3];
+					triangle[0] = face[0];
+					triangle[1] = face[i - 1];
+					triangle[2] = face[i];
+				}
+			}
+			else if(hasKeyword (line, lineEnd, "usemtl", 6))
+				chunk.materialSwitches.push_back ({triangleIndex, getArgument (line, lineEnd, 6)});
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	// Materials
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	static void parseMaterialLibrary (MeshData& mesh, UrlRef path)
+	{
+		MappedFile file;
+		if(!file.open (path))
+			return;
+
+		MeshData::Material* material = nullptr;
+		const char* end = file.getData () + file.getSize ();
+		const char* line = nullptr;
+		const char* lineEnd = nullptr;
+		for(const char* p = file.getData (); p < end;)
+		{
+			nextLine (line, lineEnd, p, end);
+			if(hasKeyword (line, lineEnd, "newmtl", 6))
+			{
+				std::string name = getArgument (line, lineEnd, 6);
+				material = nullptr;
+				for(MeshData::Material& m : mesh.materials)
+					if(m.name == name.c_str ())
+						material = &m;
+				continue;
+			}
+			if(!material)
+				continue;
+
+			const char* q = line + 3;
+			if(hasKeyword (line, lineEnd, "Kd", 2))
+			{
+				for(int i = 0; i < 3; i++)
+					parseFloat (q, lineEnd, material->color[i]);
+			}
+			else if(hasKeyword (line, lineEnd, "Ns", 2))
+				parseFloat (q, lineEnd, material->shininess);
+			else if(hasKeyword (line, lineEnd, "d", 1))
+			{
+				q = line + 2;
+				parseFloat (q, lineEnd, material->opacity);
+			}
+			else if(hasKeyword (line, lineEnd, "Tr", 2))
+			{
+				float transparency = 0.f;
+				if(parseFloat (q, lineEnd, transparency))
+					material->opacity = 1.f - transparency;
+			}
+			else if(hasKeyword (line, lineEnd, "map_Kd", 6))
+			{
+				material->texture = String ();
+				material->texture.appendCString (Text::kUTF8, getArgument (line, lineEnd, 6).c_str ());
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	// Signature
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** FNV-1a style hash over all of the data, eight bytes per step with a shift to carry the
+		high bits back down. Reads at memory speed, far below the cost of parsing. */
+	static uint64 getContentHash (const char* data, int64 size, uint64 hash = 0xCBF29CE484222325ull)
+	{
+		hash = (hash ^ uint64 (size)) * 0x100000001B3ull;
+		int64 i = 0;
+		for(; i + 8 <= size; i += 8)
+		{
+			uint64 word;
+			::memcpy (&word, data + i, 8);
+			hash = (hash ^ word) * 0x100000001B3ull;
+			hash ^= hash >> 29;
+		}
+		for(; i < size; i++)
+			hash = (hash ^ uint8 (data[i])) * 0x100000001B3ull;
+		return hash;
+	}
+
+	/** Hash of the OBJ text and of all material libraries it references, a missing library
+		counts as empty. */
+	static uint64 getSourceHash (UrlRef path, const char* data, int64 size)
+	{
+		uint64 hash = getContentHash (data, size);
+
+		std::vector<std::string> libraries;
+		findMaterialLibraries (libraries, data, size);
+		for(const std::string& library : libraries)
+		{
+			MappedFile file;
+			if(file.open (getMaterialLibraryPath (path, library)))
+				hash = getContentHash (file.getData (), file.getSize (), hash);
+			else
+				hash = getContentHash (nullptr, 0, hash);
+		}
+		return hash;
+	}
+
+	inline double getMilliseconds (double startTime)
+	{
+		return (System::GetProfileTime () - startTime) * 1000.;
+	}
+}
+
+using namespace ObjFormat;
+
+//************************************************************************************************
+// ObjImporter
+//************************************************************************************************
+
+ObjImporter::ObjImporter ()
+: threadCount (WorkerPool::getHardwareThreadCount ()),
+  cacheEnabled (true),
+  optimizing (true)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ObjImporter::getCachePath (Url& cachePath, UrlRef path)
+{
+	if(!System::GetSystem ().getLocation (cachePath, System::kTempFolder))
+		return false;
+	cachePath.descend ("MeshCache", Url::kFolder);
+	if(!System::GetFileSystem ().createFolder (cachePath) && !System::GetFileSystem ().fileExists (cachePath))
+		return false;
+
+	// sources with the same name in different folders get their own file
+	MutableCString sourcePath (UrlDisplayString (path), Text::kUTF8);
+	uint64 pathHash = getContentHash (sourcePath.str (), int64 (::strlen (sourcePath.str ())));
+
+	String name;
+	path.getName (name);
+	name << "." << int64 (pathHash & 0xFFFFFFFF) << ".meshcache";
+	cachePath.descend (name);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ObjImporter::import (MeshData& mesh, UrlRef path)
+{
+	timing = Timing ();
+
+	double startTime = System::GetProfileTime ();
+	MappedFile file;
+	if(!file.open (path))
+		return false;
+	timing.mapMs = getMilliseconds (startTime);
+	timing.fileBytes = file.getSize ();
+
+	Url cachePath;
+	bool cacheAvailable = cacheEnabled && getCachePath (cachePath, path);
+	uint64 hash = cacheAvailable ? getSourceHash (path, file.getData (), file.getSize ()) : 0;
+	if(cacheAvailable)
+	{
+		startTime = System::GetProfileTime ();
+		if(mesh.load (cachePath, file.getSize (), hash))
+		{
+			timing.fromCache = true;
+			timing.cacheMs = getMilliseconds (startTime);
+			return true;
+		}
+	}
+
+	if(!parseText (mesh, file.getData (), file.getSize (), path))
+		return false;
+
+	// a failed write just means there is no cache next time
+	if(cacheAvailable)
+	{
+		startTime = System::GetProfileTime ();
+		mesh.save (cachePath, file.getSize (), hash);
+		timing.cacheMs = getMilliseconds (startTime);
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ObjImporter::parse (MeshData& mesh, UrlRef path)
+{
+	timing = Timing ();
+
+	double startTime = System::GetProfileTime ();
+	MappedFile file;
+	if(!file.open (path))
+		return false;
+	timing.mapMs = getMilliseconds (startTime);
+	timing.fileBytes = file.getSize ();
+
+	return parseText (mesh, file.getData (), file.getSize (), path);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ObjImporter::parseText (MeshData& mesh, const char* text, int64 size, UrlRef path)
+{
+	mesh.removeAll ();
+
+	double startTime = System::GetProfileTime ();
+	int threads = ccl_max (threadCount, 1);
+	std::vector<Chunk> chunks;
+	splitChunks (chunks, text, size, threads);
+	int chunkCount = int (chunks.size ());
+	timing.chunkCount = chunkCount;
+
+	WorkerPool::instance ().parallelFor (chunkCount, threads, [&] (int index)
+	{
+		countChunk (chunks[size_t (index)]);
+	});
+
+	// element offsets of the chunks
+	Arrays arrays;
+	int64 positionCount = 0, coordinateCount = 0, normalCount = 0, triangleCount = 0;
+	for(Chunk& chunk : chunks)
+	{
+		chunk.positionOffset = positionCount;
+		chunk.coordinateOffset = coordinateCount;
+		chunk.normalOffset = normalCount;
+		chunk.triangleOffset = triangleCount;
+		positionCount += chunk.positionCount;
+		coordinateCount += chunk.coordinateCount;
+		normalCount += chunk.normalCount;
+		triangleCount += chunk.triangleCount;
+	}
+	if(triangleCount == 0 || positionCount > 0x7FFFFFFF || triangleCount * 3 > 0x7FFFFFFF)
+		return false;
+
+	arrays.positions.resize (size_t (positionCount));
+	arrays.coordinates.resize (size_t (coordinateCount));
+	arrays.normals.resize (size_t (normalCount));
+	arrays.corners.resize (size_t (triangleCount * 3));
+
+	WorkerPool::instance ().parallelFor (chunkCount, threads, [&] (int index)
+	{
+		parseChunk (chunks[size_t (index)], arrays);
+	});
+	for(const Chunk& chunk : chunks)
+		if(chunk.failed)
+			return false;
+	timing.parseMs = getMilliseconds (startTime);
+
+	startTime = System::GetProfileTime ();
+
+	// materials in order of first use, triangles before the first usemtl use the default one
+	std::vector<int32> triangleMaterials (size_t (triangleCount), -1);
+	{
+		int32 current = -1;
+		int64 start = 0;
+		auto fill = [&] (int64 until)
+		{
+			for(int64 t = start; t < until; t++)
+				triangleMaterials[size_t (t)] = current;
+			start = until;
+		};
+		for(const Chunk& chunk : chunks)
+			for(const MaterialSwitch& materialSwitch : chunk.materialSwitches)
+			{
+				fill (materialSwitch.triangle);
+				current = -1;
+				for(int i = 0; i < mesh.materials.count (); i++)
+					if(mesh.materials[i].name == materialSwitch.name.c_str ())
+						current = i;
+				if(current < 0)
+				{
+					MeshData::Material material;
+					material.name.appendCString (Text::kUTF8, materialSwitch.name.c_str ());
+					current = mesh.materials.count ();
+					mesh.materials.add (material);
+				}
+			}
+		fill (triangleCount);
+	}
+
+	// libraries of all chunks in file order, later definitions of a material win
+	std::vector<std::string> libraries;
+	for(const Chunk& chunk : chunks)
+		for(const std::string& library : chunk.materialLibraries)
+			addMaterialLibrary (libraries, library);
+	for(const std::string& library : libraries)
+		parseMaterialLibrary (mesh, getMaterialLibraryPath (path, library));
+
+	// stable counting sort of the triangles by material, one group per material
+	int groupCount = mesh.materials.count () + 1;
+	std::vector<int64> groupStarts (size_t (groupCount + 1), 0);
+	for(int32 material : triangleMaterials)
+		groupStarts[size_t (material + 2)]++;
+	for(int g = 1; g <= groupCount; g++)
+		groupStarts[size_t (g)] += groupStarts[size_t (g - 1)];
+	std::vector<int64> order (size_t (triangleCount));
+	{
+		std::vector<int64> next (groupStarts.begin (), groupStarts.end () - 1);
+		for(int64 t = 0; t < triangleCount; t++)
+			order[size_t (next[size_t (triangleMaterials[size_t (t)] + 1)]++)] = t;
+	}
+
+	// vertices shared by position index only don't need a lookup
+	bool identity = true;
+	bool hasNormals = normalCount > 0;
+	for(const Corner& corner : arrays.corners)
+	{
+		identity &= (corner.coordinate < 0 || corner.coordinate == corner.position) && (corner.normal < 0 || corner.normal == corner.position);
+		hasNormals &= corner.normal >= 0;
+	}
+
+	std::vector<Corner> vertices;
+	mesh.indices.setCount (int (triangleCount * 3));
+	uint32* indices = mesh.indices.getItems ();
+	if(identity)
+	{
+		vertices.resize (size_t (positionCount));
+		for(int32 i = 0; i < int32 (positionCount); i++)
+			vertices[size_t (i)] = {i, i < coordinateCount ? i : -1, i < normalCount ? i : -1};
+		for(int64 t = 0; t < triangleCount; t++)
+			for(int c = 0; c < 3; c++)
+				*indices++ = uint32 (arrays.corners[size_t (order[size_t (t)] * 3 + c)].position);
+	}
+	else
+	{
+		std::unordered_map<Corner, uint32, CornerHash> lookup;
+		lookup.reserve (size_t (positionCount * 2));
+		vertices.reserve (size_t (positionCount));
+		for(int64 t = 0; t < triangleCount; t++)
+			for(int c = 0; c < 3; c++)
+			{
+				const Corner& corner = arrays.corners[size_t (order[size_t (t)] * 3 + c)];
+				auto result = lookup.emplace (corner, uint32 (vertices.size ()));
+				if(result.second)
+					vertices.push_back (corner);
+				*indices++ = result.first->second;
+			}
+	}
+
+	int vertexCount = int (vertices.size ());
+	mesh.positions.setCount (vertexCount);
+	mesh.normals.setCount (vertexCount);
+	mesh.textureCoordinates.setCount (vertexCount);
+	for(int i = 0; i < vertexCount; i++)
+	{
+		const Corner& vertex = vertices[size_t (i)];
+		mesh.positions[i] = arrays.positions[size_t (vertex.position)];
+		mesh.normals[i] = vertex.normal >= 0 ? arrays.normals[size_t (vertex.normal)] : PointF3D ();
+		mesh.textureCoordinates[i] = vertex.coordinate >= 0 ? arrays.coordinates[size_t (vertex.coordinate)] : PointF ();
+	}
+
+	// area weighted face normals for files without normals
+	if(!hasNormals)
+	{
+		for(int i = 0; i < vertexCount; i++)
+			mesh.normals[i] = PointF3D ();
+		for(int i = 0; i + 2 < mesh.indices.count (); i += 3)
+		{
+			uint32 i0 = mesh.indices[i], i1 = mesh.indices[i + 1], i2 = mesh.indices[i + 2];
+			PointF3D a = mesh.positions[i0], b = mesh.positions[i1], c = mesh.positions[i2];
+			PointF3D u (b.x - a.x, b.y - a.y, b.z - a.z);
+			PointF3D v (c.x - a.x, c.y - a.y, c.z - a.z);
+			PointF3D n (u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+			for(uint32 index : {i0, i1, i2})
+			{
+				mesh.normals[index].x += n.x;
+				mesh.normals[index].y += n.y;
+				mesh.normals[index].z += n.z;
+			}
+		}
+		for(int i = 0; i < vertexCount; i++)
+		{
+			PointF3D& n = mesh.normals[i];
+			float length = std::sqrt (n.x * n.x + n.y * n.y + n.z * n.z);
+			if(length > 0.f)
+				n = PointF3D (n.x / length, n.y / length, n.z / length);
+		}
+	}
+
+	for(int g = 0; g < groupCount; g++)
+	{
+		int64 first = groupStarts[size_t (g)];
+		int64 count = groupStarts[size_t (g + 1)] - first;
+		if(count == 0)
+			continue;
+
+		MeshData::Group group;
+		group.material = g - 1;
+		group.firstIndex = int32 (first * 3);
+		group.indexCount = int32 (count * 3);
+		mesh.groups.add (group);
+	}
+
+	mesh.computeBounds ();
+	timing.buildMs = getMilliseconds (startTime);
+
+	// vertices are merged already
+	if(optimizing)
+	{
+		startTime = System::GetProfileTime ();
+		MeshOptimizer optimizer;
+		optimizer.setSteps (MeshOptimizer::kDefaultSteps & ~MeshOptimizer::kDeduplicate);
+		optimizer.optimize (mesh);
+		timing.optimizeMs = getMilliseconds (startTime);
+	}
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String ObjImporter::runBenchmark (UrlRef path, int iterations)
+{
+	auto measure = [&] (auto body)
+	{
+		double best = 0.;
+		for(int i = 0; i < ccl_max (iterations, 1); i++)
+		{
+			double startTime = System::GetProfileTime ();
+			body ();
+			double ms = getMilliseconds (startTime);
+			best = i == 0 ? ms : ccl_min (best, ms);
+		}
+		return best;
+	};
+
+	ObjImporter importer;
+	MeshData mesh;
+	bool succeeded = true;
+
+	importer.setThreadCount (1);
+	double serialMs = measure ([&] () { succeeded &= importer.parse (mesh, path); });
+	importer.setThreadCount (WorkerPool::getHardwareThreadCount ());
+	double parallelMs = measure ([&] () { succeeded &= importer.parse (mesh, path); });
+	Timing parseTiming = importer.getLastTiming ();
+
+	// the first import writes the cache, the measured ones read it
+	succeeded &= importer.import (mesh, path);
+	double cacheMs = measure ([&] () { succeeded &= importer.import (mesh, path); });
+	bool fromCache = importer.getLastTiming ().fromCache;
+
+	Url folder (path);
+	folder.ascend ();
+	double modelMs = measure ([&] () { AutoPtr<IModel3D> model = mesh.createModel (folder); });
+
+	if(!succeeded)
+		return CCLSTR ("Import failed");
+
+	String s;
+	s << mesh.getVertexCount () << " vertices, " << mesh.getTriangleCount () << " triangles, " << parseTiming.fileBytes / 1024 << " KB: text ";
+	s.appendFloatValue (serialMs, 2);
+	s << "ms (1 thread) / ";
+	s.appendFloatValue (parallelMs, 2);
+	s << "ms (" << importer.getThreadCount () << " threads, " << parseTiming.chunkCount << " chunks, optimize ";
+	s.appendFloatValue (parseTiming.optimizeMs, 2);
+	s << "ms), ";
+	s << (fromCache ? "cache " : "cache unavailable ");
+	s.appendFloatValue (cacheMs, 2);
+	s << "ms, model ";
+	s.appendFloatValue (modelMs, 2);
+	s << "ms";
+	return s;
+}
@@ -0,0 +1,86 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : objimporter.h
+// Description : OBJ Importer
+//
+//************************************************************************************************
+
+#ifndef _objimporter_h
+#define _objimporter_h
+
+#include "meshdata.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ObjImporter
+/** Wavefront OBJ/MTL import into MeshData. The file is memory mapped and split into chunks at
+	line boundaries. A first parallel pass counts the elements of each chunk, a second one parses
+	them directly into their final position, so face indices (including relative ones) resolve
+	without merging. Numbers are parsed eight digits at a time.
+
+	Faces are triangulated as fans and grouped by material. Vertices sharing position, texture
+	coordinates and normal are merged. Normals are generated if the file has none.
+
+	The mesh is then reordered for the vertex cache and overdraw by MeshOptimizer (optional).
+	The result is written to a binary cache in the temporary folder (.meshcache), which is used
+	instead of parsing as long as the OBJ file and its material libraries hash the same. */
+//************************************************************************************************
+
+class ObjImporter: public Object
+{
+public:
+	ObjImporter ();
+
+	PROPERTY_VARIABLE (int, threadCount, ThreadCount)
+	PROPERTY_BOOL (cacheEnabled, CacheEnabled)
+	PROPERTY_BOOL (optimizing, Optimizing)
+
+	struct Timing
+	{
+		bool fromCache = false;
+		int chunkCount = 0;
+		int64 fileBytes = 0;
+		double mapMs = 0.;
+		double parseMs = 0.;		///< both passes over the text
+		double buildMs = 0.;		///< vertex merging, grouping and normals
+		double optimizeMs = 0.;
+		double cacheMs = 0.;		///< loading or writing the cache
+	};
+
+	/** Import from the cache if it is valid, otherwise parse the file and write the cache. */
+	bool import (MeshData& mesh, UrlRef path);
+
+	/** Parse the file, the cache is neither read nor written. */
+	bool parse (MeshData& mesh, UrlRef path);
+
+	const Timing& getLastTiming () const { return timing; }
+
+	/** Cache file of the source in the temporary folder, which is created if needed. */
+	static bool getCachePath (Url& cachePath, UrlRef path);
+
+	/** Import times of the text (single and multi-threaded), the cache and the model creation. */
+	static String runBenchmark (UrlRef path, int iterations = 3);
+
+protected:
+	Timing timing;
+
+	bool parseText (MeshData& mesh, const char* text, int64 size, UrlRef path);
+};
+
+} // namespace CCL
+
+#endif // _objimporter_h
@@ -0,0 +1,173 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : primitivebatch.cpp
+// Description : Batched Primitive Drawing
+//
+//************************************************************************************************
+
+#include "primitivebatch.h"
+
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+namespace PrimitiveBatch {
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline uint16 styleAt (const uint16 indices[], int item)
+{
+	return indices ? indices[item] : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Call submit (style, items, itemCount) for each run of items sharing a style. */
+template <typename Submit>
+static int forEachRun (int count, const uint16 indices[], int options, const Submit& submit)
+{
+	if(count <= 0)
+		return 0;
+
+	Vector<int> order;
+	order.resize (count);
+	order.setCount (count);
+
+	if(indices && (options & kUnordered))
+	{
+		// counting sort by style, stable within a style
+		int maxStyle = 0;
+		for(int i = 0; i < count; i++)
+			maxStyle = ccl_max<int> (maxStyle, indices[i]);
+
+		Vector<int> offsets;
+		offsets.resize (maxStyle + 2);
+		offsets.setCount (maxStyle + 2);
+		for(int s = 0; s < maxStyle + 2; s++)
+			offsets[s] = 0;
+		for(int i = 0; i < count; i++)
+			offsets[indices[i] + 1]++;
+		for(int s = 1; s < maxStyle + 2; s++)
+			offsets[s] += offsets[s - 1];
+		for(int i = 0; i < count; i++)
+			order[offsets[indices[i]]++] = i;
+	}
+	else
+	{
+		for(int i = 0; i < count; i++)
+			order[i] = i;
+	}
+
+	int submissions = 0;
+	for(int start = 0; start < count;)
+	{
+		uint16 style = styleAt (indices, order[start]);
+		int end = start + 1;
+		while(end < count && styleAt (indices, order[end]) == style)
+			end++;
+
+		submit (style, order.getItems () + start, end - start);
+		submissions++;
+		start = end;
+	}
+	return submissions;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// PrimitiveBatch
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int drawRects (IGraphics& graphics, const RectF rects[], int count, const Pen pens[], const uint16 penIndices[], int options)
+{
+	return forEachRun (count, penIndices, options, [&] (uint16 style, const int items[], int itemCount)
+	{
+		if(itemCount == 1)
+		{
+			graphics.drawRect (rects[items[0]], pens[style]);
+			return;
+		}
+
+		AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
+		for(int i = 0; i < itemCount; i++)
+			path->addRect (rects[items[i]]);
+		graphics.drawPath (path, pens[style]);
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int fillRects (IGraphics& graphics, const RectF rects[], int count, const SolidBrush brushes[], const uint16 brushIndices[], int options)
+{
+	return forEachRun (count, brushIndices, options, [&] (uint16 style, const int items[], int itemCount)
+	{
+		if(itemCount == 1)
+		{
+			graphics.fillRect (rects[items[0]], brushes[style]);
+			return;
+		}
+
+		// all rects have the same orientation, so the default (nonzero) fill mode fills their union
+		AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
+		for(int i = 0; i < itemCount; i++)
+			path->addRect (rects[items[i]]);
+		graphics.fillPath (path, brushes[style]);
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int drawLines (IGraphics& graphics, const PointF points[], int count, const Pen pens[], const uint16 penIndices[], int options)
+{
+	return forEachRun (count, penIndices, options, [&] (uint16 style, const int items[], int itemCount)
+	{
+		if(itemCount == 1)
+		{
+			graphics.drawLine (points[2 * items[0]], points[2 * items[0] + 1], pens[style]);
+			return;
+		}
+
+		AutoPtr<IGraphicsPath> path = GraphicsFactory::createPath ();
+		for(int i = 0; i < itemCount; i++)
+		{
+			path->startFigure (points[2 * items[i]]);
+			path->lineTo (points[2 * items[i] + 1]);
+		}
+		graphics.drawPath (path, pens[style]);
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int drawImages (IGraphics& graphics, const ImageItem items[], int count, IImage* const images[], const uint16 imageIndices[], int options)
+{
+	int submissions = 0;
+	forEachRun (count, imageIndices, options, [&] (uint16 style, const int runItems[], int itemCount)
+	{
+		IImage* image = images[style];
+		if(!image)
+			return;
+
+		for(int i = 0; i < itemCount; i++)
+			graphics.drawImage (image, items[runItems[i]].src, items[runItems[i]].dst);
+		submissions += itemCount;
+	});
+	return submissions;
+}
+
+} // namespace PrimitiveBatch
+} // namespace CCL
@@ -0,0 +1,69 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : primitivebatch.h
+// Description : Batched Primitive Drawing
+//
+//************************************************************************************************
+
+#ifndef _primitivebatch_h
+#define _primitivebatch_h
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/iimage.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// PrimitiveBatch
+/** Draws arrays of primitives with one backend submission per style instead of one IGraphics
+	call per item. Items are passed as contiguous arrays plus an optional per-item index into
+	a pen, brush or image table (nullptr: index 0 for all items).
+
+	By default, only consecutive items with the same style are merged, so the drawing order is
+	kept. With kUnordered, all items of a style are merged, which is only correct when items of
+	different styles do not overlap. Either way, merged items become one path: opaque items look
+	the same as drawn one by one, but overlapping translucent items of the same style blend once
+	instead of once per item. */
+//************************************************************************************************
+
+namespace PrimitiveBatch
+{
+	enum Options
+	{
+		kPreserveOrder = 0,
+		kUnordered = 1 << 0
+	};
+
+	struct ImageItem
+	{
+		Rect src;
+		Rect dst;
+	};
+
+	/** Returns the number of backend submissions. */
+	int drawRects (IGraphics& graphics, const RectF rects[], int count, const Pen pens[], const uint16 penIndices[] = nullptr, int options = kPreserveOrder);
+	int fillRects (IGraphics& graphics, const RectF rects[], int count, const SolidBrush brushes[], const uint16 brushIndices[] = nullptr, int options = kPreserveOrder);
+	int drawLines (IGraphics& graphics, const PointF points[], int count, const Pen pens[], const uint16 penIndices[] = nullptr, int options = kPreserveOrder); ///< points holds 2 * count points
+
+	/** IGraphics has no call for several images, so every item is still one drawImage () call.
+		With kUnordered the calls are grouped by image, the backend then switches the source
+		image once per image instead of once per item. */
+	int drawImages (IGraphics& graphics, const ImageItem items[], int count, IImage* const images[], const uint16 imageIndices[] = nullptr, int options = kPreserveOrder);
+}
+
+} // namespace CCL
+
+#endif // _primitivebatch_h
@@ -0,0 +1,229 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : progressiveimage.cpp
+// Description : Progressive Image Loading
+//
+//************************************************************************************************
+
+#include "progressiveimage.h"
+#include "scaledimagecache.h"
+
+#include "../workerpool.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+#include "ccl/public/systemservices.h"
+
+#include <atomic>
+#include <mutex>
+
+using namespace CCL;
+
+//************************************************************************************************
+// ProgressiveImage::Implementation
+//************************************************************************************************
+
+struct ProgressiveImage::Implementation
+{
+	mutable std::mutex lock;
+	std::atomic<int> state {kLoading};
+	std::atomic<bool> canceled {false};
+	AutoPtr<IImage> image;		///< guarded by lock
+	Report report;				///< guarded by lock
+	double startTime = 0.;
+
+	/** Ignored once canceled, so a late result can't replace the canceled state. */
+	bool publish (IImage* newImage, State newState)
+	{
+		std::lock_guard<std::mutex> guard (lock);
+		if(canceled)
+			return false;
+
+		if(newImage)
+			newImage->retain ();
+		image = newImage;
+		state = newState;
+		return true;
+	}
+
+	static int64 getBytes (int width, int height)
+	{
+		return int64 (width) * height * 4;
+	}
+};
+
+//************************************************************************************************
+// ProgressiveImage
+//************************************************************************************************
+
+ProgressiveImage::ProgressiveImage (UrlRef path, int targetWidth, int targetHeight)
+: implementation (NEW Implementation),
+  path (path),
+  targetWidth (ccl_max (targetWidth, 1)),
+  targetHeight (ccl_max (targetHeight, 1))
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ProgressiveImage::~ProgressiveImage ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ProgressiveImage::start ()
+{
+	implementation->startTime = System::GetProfileTime ();
+
+	retain (); // the task keeps this alive until it is done
+	WorkerPool::instance ().post ([this] ()
+	{
+		load ();
+		release ();
+	});
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ProgressiveImage::cancel ()
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	if(implementation->state == kComplete || implementation->canceled)
+		return;
+
+	implementation->canceled = true;
+	implementation->image.release ();
+	implementation->state = kCanceled;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ProgressiveImage::State ProgressiveImage::getState () const
+{
+	return State (implementation->state.load ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ProgressiveImage::retainImage () const
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	IImage* image = implementation->image;
+	if(image)
+		image->retain ();
+	return image;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ProgressiveImage::Report ProgressiveImage::getReport () const
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	return implementation->report;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ProgressiveImage::load ()
+{
+	auto elapsedMs = [&] () { return (System::GetProfileTime () - implementation->startTime) * 1000.; };
+	auto updateReport = [&] (auto update)
+	{
+		std::lock_guard<std::mutex> guard (implementation->lock);
+		update (implementation->report);
+	};
+
+	AutoPtr<IImage> source = GraphicsFactory::loadImageFile (path);
+	if(implementation->canceled)
+		return;
+	if(!source || !UnknownPtr<IBitmap> (source).isValid ())
+	{
+		implementation->publish (nullptr, kFailed);
+		return;
+	}
+
+	int sourceWidth = source->getWidth ();
+	int sourceHeight = source->getHeight ();
+	int64 sourceBytes = Implementation::getBytes (sourceWidth, sourceHeight);
+	double decodeMs = elapsedMs ();
+
+	// fit into the target, never enlarge
+	float scale = ccl_min (1.f, ccl_min (float (targetWidth) / sourceWidth, float (targetHeight) / sourceHeight));
+	int width = ccl_max (int (sourceWidth * scale + .5f), 1);
+	int height = ccl_max (int (sourceHeight * scale + .5f), 1);
+
+	// coarse preview, point sampled from the locked source pixels
+	int previewWidth = ccl_max (width / 8, 1);
+	int previewHeight = ccl_max (height / 8, 1);
+	AutoPtr<IImage> preview = ScaledImageCache::createSampled (source, previewWidth, previewHeight);
+	if(!preview)
+	{
+		implementation->publish (nullptr, kFailed);
+		return;
+	}
+	if(!implementation->publish (preview, kPreview))
+		return;
+	int64 previewBytes = Implementation::getBytes (previewWidth, previewHeight);
+
+	updateReport ([&] (Report& report)
+	{
+		report.sourceWidth = sourceWidth;
+		report.sourceHeight = sourceHeight;
+		report.decodeMs = decodeMs;
+		report.firstPixelMs = elapsedMs ();
+		report.peakBytes = sourceBytes + previewBytes;
+	});
+
+	if(implementation->canceled)
+		return;
+
+	// refined image from the source pixels, the full resolution decode is released right after
+	int64 downscalePeak = 0;
+	AutoPtr<IImage> result = ScaledImageCache::createDownscaled (source, width, height, &downscalePeak);
+	source.release ();
+	if(!result)
+	{
+		implementation->publish (nullptr, kFailed);
+		return;
+	}
+
+	// the report is complete before the state changes, the view reads it on kComplete
+	updateReport ([&] (Report& report)
+	{
+		report.completeMs = elapsedMs ();
+		report.peakBytes = ccl_max (report.peakBytes, sourceBytes + previewBytes + downscalePeak);
+		report.residentBytes = Implementation::getBytes (width, height);
+	});
+	implementation->publish (result, kComplete);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String ProgressiveImage::getReportString () const
+{
+	Report report = getReport ();
+
+	String s;
+	s << report.sourceWidth << "x" << report.sourceHeight << " decode ";
+	s.appendFloatValue (report.decodeMs, 1);
+	s << "ms, first pixel ";
+	s.appendFloatValue (report.firstPixelMs, 1);
+	s << "ms, complete ";
+	s.appendFloatValue (report.completeMs, 1);
+	s << "ms, peak " << report.peakBytes / 1024 << " KB, resident " << report.residentBytes / 1024 << " KB";
+	return s;
+}
@@ -0,0 +1,84 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : progressiveimage.h
+// Description : Progressive Image Loading
+//
+//************************************************************************************************
+
+#ifndef _progressiveimage_h
+#define _progressiveimage_h
+
+#include "ccl/base/storage/url.h"
+
+#include "ccl/public/gui/graphics/iimage.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ProgressiveImage
+/** Loads an image file on the background thread of the worker pool for display at a target
+	size. Decoding is not progressive: the graphics backend decodes the whole file at its
+	resolution first. A coarse preview (1/8 of the target) is published right after that,
+	before the high quality downscale, which then replaces it and the full resolution decode
+	is released, so only target sized pixels stay resident.
+
+	The worker only locks bitmap pixels and never draws with graphics, files that don't
+	decode to a bitmap (e.g. vector images) fail. */
+//************************************************************************************************
+
+class ProgressiveImage: public Object
+{
+public:
+	ProgressiveImage (UrlRef path, int targetWidth, int targetHeight);
+	~ProgressiveImage ();
+
+	enum State { kLoading, kPreview, kComplete, kFailed, kCanceled };
+
+	void start ();
+	void cancel ();	///< releases the image unless loading is complete
+	State getState () const;
+
+	/** Best image available so far (null while loading), caller releases. */
+	IImage* retainImage () const;
+
+	struct Report
+	{
+		int sourceWidth = 0;
+		int sourceHeight = 0;
+		double decodeMs = 0.;
+		double firstPixelMs = 0.;	///< until the preview is available
+		double completeMs = 0.;
+		int64 peakBytes = 0;		///< largest amount of bitmap memory alive at the same time
+		int64 residentBytes = 0;	///< kept after completion
+	};
+
+	Report getReport () const;
+	String getReportString () const;
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+
+	Url path;
+	int targetWidth;
+	int targetHeight;
+
+	void load ();
+};
+
+} // namespace CCL
+
+#endif // _progressiveimage_h
@@ -0,0 +1,450 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scaledimagecache.cpp
+// Description : Scaled Image Cache
+//
+//************************************************************************************************
+
+#include "scaledimagecache.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace ImageLevels
+{
+	/** 2x2 box filter, odd edges repeat the last source pixel. */
+	static void downsample (BitmapData& dest, const BitmapData& source)
+	{
+		for(int y = 0; y < dest.height; y++)
+		{
+			int y0 = ccl_min (y * 2, source.height - 1);
+			int y1 = ccl_min (y * 2 + 1, source.height - 1);
+			const uint8* row0 = static_cast<const uint8*> (source.scan0) + y0 * source.rowBytes;
+			const uint8* row1 = static_cast<const uint8*> (source.scan0) + y1 * source.rowBytes;
+			uint8* out = static_cast<uint8*> (dest.scan0) + y * dest.rowBytes;
+
+			for(int x = 0; x < dest.width; x++)
+			{
+				int x0 = ccl_min (x * 2, source.width - 1) * 4;
+				int x1 = ccl_min (x * 2 + 1, source.width - 1) * 4;
+				for(int c = 0; c < 4; c++)
+					out[x * 4 + c] = uint8 ((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+			}
+		}
+	}
+
+	/** Bilinear filter, for factors between 1/2 and 1 where it doesn't alias. */
+	static void resample (BitmapData& dest, const BitmapData& source)
+	{
+		float fx = float (source.width) / dest.width;
+		float fy = float (source.height) / dest.height;
+		for(int y = 0; y < dest.height; y++)
+		{
+			float sy = ccl_max ((y + .5f) * fy - .5f, 0.f);
+			int y0 = ccl_min (int (sy), source.height - 1);
+			int y1 = ccl_min (y0 + 1, source.height - 1);
+			int wy = int ((sy - y0) * 256.f);
+			const uint8* row0 = static_cast<const uint8*> (source.scan0) + y0 * source.rowBytes;
+			const uint8* row1 = static_cast<const uint8*> (source.scan0) + y1 * source.rowBytes;
+			uint8* out = static_cast<uint8*> (dest.scan0) + y * dest.rowBytes;
+
+			for(int x = 0; x < dest.width; x++)
+			{
+				float sx = ccl_max ((x + .5f) * fx - .5f, 0.f);
+				int x0 = ccl_min (int (sx), source.width - 1);
+				int x1 = ccl_min (x0 + 1, source.width - 1) * 4;
+				int wx = int ((sx - x0) * 256.f);
+				x0 *= 4;
+				for(int c = 0; c < 4; c++)
+				{
+					int top = row0[x0 + c] * (256 - wx) + row0[x1 + c] * wx;
+					int bottom = row1[x0 + c] * (256 - wx) + row1[x1 + c] * wx;
+					out[x * 4 + c] = uint8 ((top * (256 - wy) + bottom * wy + 32768) >> 16);
+				}
+			}
+		}
+	}
+
+	/** Nearest source pixel at the center of each destination pixel. */
+	static void pointSample (BitmapData& dest, const BitmapData& source)
+	{
+		for(int y = 0; y < dest.height; y++)
+		{
+			int sy = ccl_min (int ((y + .5f) * source.height / dest.height), source.height - 1);
+			const uint8* row = static_cast<const uint8*> (source.scan0) + sy * source.rowBytes;
+			uint8* out = static_cast<uint8*> (dest.scan0) + y * dest.rowBytes;
+			for(int x = 0; x < dest.width; x++)
+			{
+				int sx = ccl_min (int ((x + .5f) * source.width / dest.width), source.width - 1);
+				::memcpy (out + x * 4, row + sx * 4, 4);
+			}
+		}
+	}
+
+	static int getLevelSize (int sourceSize, int level)
+	{
+		return ccl_max (sourceSize >> level, 1);
+	}
+
+	/** Bitmap of the given size filtered from the pixels of another bitmap. */
+	static IImage* createFiltered (IImage* parent, int width, int height, void (*filter) (BitmapData&, const BitmapData&))
+	{
+		IImage* result = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+		if(!result)
+			return nullptr;
+
+		BitmapDataLocker src (UnknownPtr<IBitmap> (parent), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+		BitmapDataLocker dst (UnknownPtr<IBitmap> (result), IBitmap::kRGBAlpha, IBitmap::kLockWrite);
+		if(src.result != kResultOk || dst.result != kResultOk)
+		{
+			result->release ();
+			return nullptr;
+		}
+		filter (dst.data, src.data);
+		return result;
+	}
+
+	/** Bitmap of the given size box filtered from a bitmap of about twice the size. */
+	static IImage* createHalf (IImage* parent, int width, int height)
+	{
+		return createFiltered (parent, width, height, downsample);
+	}
+
+	/** Lockable copy of the source, which may be a multi-resolution or vector image.
+		Draws with bitmap graphics, so this must run on the UI thread. */
+	static IImage* createRendering (IImage* source)
+	{
+		IImage* rendering = GraphicsFactory::createBitmap (source->getWidth (), source->getHeight (), IBitmap::kRGBAlpha);
+		if(!rendering)
+			return nullptr;
+
+		AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (rendering);
+		if(!graphics)
+		{
+			rendering->release ();
+			return nullptr;
+		}
+		graphics->drawImage (source, Point ());
+		return rendering;
+	}
+
+	/** Bitmap of the given level (>= 1) created from the next larger one. */
+	static IImage* createLevel (IImage* source, IImage* parent, int level)
+	{
+		AutoPtr<IImage> rendering;
+		if(level == 1)
+			parent = rendering = createRendering (source);
+		if(!parent)
+			return nullptr;
+
+		return createHalf (parent, getLevelSize (source->getWidth (), level), getLevelSize (source->getHeight (), level));
+	}
+
+	static int64 getBytes (IImage* image)
+	{
+		return image ? int64 (image->getWidth ()) * image->getHeight () * 4 : 0;
+	}
+}
+
+using namespace ImageLevels;
+
+//************************************************************************************************
+// ScaledImageCache::Implementation
+//************************************************************************************************
+
+struct ScaledImageCache::Implementation
+{
+	struct Entry
+	{
+		SharedPtr<IImage> source;	///< keeps the address from being reused by another image
+		int level;
+		IImage* image;
+		int64 bytes;
+		int64 lastUse;
+	};
+
+	mutable std::mutex lock;
+	std::vector<Entry> entries;
+	int64 memoryLimit = kDefaultMemoryLimit;
+	int64 useCounter = 0;
+	Statistics statistics;
+
+	~Implementation ()
+	{
+		clear ();
+	}
+
+	void clear ()
+	{
+		for(Entry& entry : entries)
+			entry.image->release ();
+		entries.clear ();
+		statistics.bytes = 0;
+	}
+
+	IImage* find (IImage* source, int level)
+	{
+		for(Entry& entry : entries)
+			if(entry.source == source && entry.level == level)
+			{
+				entry.lastUse = ++useCounter;
+				entry.image->retain ();
+				return entry.image;
+			}
+		return nullptr;
+	}
+
+	void evict (IImage* keep)
+	{
+		while(statistics.bytes > memoryLimit && entries.size () > 1)
+		{
+			auto oldest = entries.end ();
+			for(auto it = entries.begin (); it != entries.end (); ++it)
+				if(it->image != keep && (oldest == entries.end () || it->lastUse < oldest->lastUse))
+					oldest = it;
+			if(oldest == entries.end ())
+				break;
+
+			statistics.bytes -= oldest->bytes;
+			statistics.evictions++;
+			oldest->image->release ();
+			entries.erase (oldest);
+		}
+	}
+};
+
+//************************************************************************************************
+// ScaledImageCache
+//************************************************************************************************
+
+DEFINE_SINGLETON (ScaledImageCache)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScaledImageCache::ScaledImageCache ()
+: implementation (NEW Implementation)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScaledImageCache::~ScaledImageCache ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScaledImageCache::setMemoryLimit (int64 bytes)
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	implementation->memoryLimit = bytes;
+	implementation->evict (nullptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64 ScaledImageCache::getMemoryUsage () const
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	return implementation->statistics.bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int ScaledImageCache::getLevel (float scale)
+{
+	// largest level that doesn't fall below the target size
+	if(scale <= 0.f || scale >= .5f)
+		return 0;
+	return ccl_min (int (std::floor (std::log2 (1.f / scale))), kMaxLevel);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ScaledImageCache::retainLevel (IImage* source, int level)
+{
+	if(!source)
+		return nullptr;
+
+	// smaller than a pixel isn't useful
+	while(level > 0 && (source->getWidth () >> level) < 1 && (source->getHeight () >> level) < 1)
+		level--;
+
+	if(level <= 0)
+	{
+		source->retain ();
+		return source;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard (implementation->lock);
+		if(IImage* image = implementation->find (source, level))
+		{
+			implementation->statistics.hits++;
+			return image;
+		}
+		implementation->statistics.misses++;
+	}
+
+	// filtering happens outside of the lock, the parent level is cached as well
+	AutoPtr<IImage> parent = level > 1 ? retainLevel (source, level - 1) : nullptr;
+	IImage* image = createLevel (source, parent, level);
+	if(!image)
+	{
+		source->retain ();
+		return source;
+	}
+
+	std::lock_guard<std::mutex> guard (implementation->lock);
+
+	// another thread may have created the same level meanwhile, keep the cached one
+	if(IImage* cached = implementation->find (source, level))
+	{
+		image->release ();
+		return cached;
+	}
+
+	Implementation::Entry entry;
+	entry.source = source;
+	entry.level = level;
+	entry.image = image;
+	entry.bytes = int64 (image->getWidth ()) * image->getHeight () * 4;
+	entry.lastUse = ++implementation->useCounter;
+	image->retain ();
+	implementation->entries.push_back (entry);
+	implementation->statistics.bytes += entry.bytes;
+	implementation->evict (image);
+	return image;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScaledImageCache::drawImage (IGraphics& graphics, IImage* source, RectRef src, RectRef dst, float scale)
+{
+	if(!source || src.isEmpty () || dst.isEmpty ())
+		return;
+
+	float drawScale = ccl_min (float (dst.getWidth ()) / src.getWidth (), float (dst.getHeight ()) / src.getHeight ()) * scale;
+	AutoPtr<IImage> image = retainLevel (source, getLevel (drawScale));
+	if(!image)
+		return;
+
+	if(image == source)
+	{
+		graphics.drawImage (source, src, dst);
+		return;
+	}
+
+	// source rect in level pixels
+	float fx = float (image->getWidth ()) / source->getWidth ();
+	float fy = float (image->getHeight ()) / source->getHeight ();
+	Rect levelSrc (Coord (src.left * fx), Coord (src.top * fy), Coord (std::ceil (src.right * fx)), Coord (std::ceil (src.bottom * fy)));
+	graphics.drawImage (image, levelSrc, dst);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ScaledImageCache::createDownscaled (IImage* source, int width, int height, int64* peakBytes)
+{
+	if(!source || width <= 0 || height <= 0)
+		return nullptr;
+
+	// halve with the box filter while the result stays at least as large as the target
+	int level = 0;
+	while(level < kMaxLevel && getLevelSize (source->getWidth (), level + 1) >= width && getLevelSize (source->getHeight (), level + 1) >= height)
+		level++;
+
+	// bitmaps are filtered directly, other images are rendered into one first
+	int64 peak = 0;
+	AutoPtr<IImage> levelImage;
+	if(UnknownPtr<IBitmap> (source).isValid ())
+		levelImage.share (source);
+	else
+	{
+		levelImage = createRendering (source);
+		peak = getBytes (levelImage);
+	}
+	if(!levelImage)
+		return nullptr;
+
+	if(level > 0)
+	{
+		for(int n = 1; n <= level && levelImage; n++)
+		{
+			IImage* next = createHalf (levelImage, getLevelSize (source->getWidth (), n), getLevelSize (source->getHeight (), n));
+			peak = ccl_max (peak, (levelImage != source ? getBytes (levelImage) : 0) + getBytes (next));
+			levelImage = next;
+		}
+		if(!levelImage)
+			return nullptr;
+	}
+
+	// the remaining factor is between 1/2 and 1, where bilinear filtering is fine
+	IImage* result = createFiltered (levelImage, width, height, resample);
+	if(peakBytes)
+		*peakBytes = ccl_max (peak, (levelImage != source ? getBytes (levelImage) : 0) + getBytes (result));
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+IImage* ScaledImageCache::createSampled (IImage* source, int width, int height)
+{
+	if(!source || width <= 0 || height <= 0)
+		return nullptr;
+
+	return createFiltered (source, width, height, pointSample);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScaledImageCache::removeAll ()
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	implementation->clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScaledImageCache::Statistics ScaledImageCache::getStatistics () const
+{
+	std::lock_guard<std::mutex> guard (implementation->lock);
+	return implementation->statistics;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String ScaledImageCache::getStatisticsString () const
+{
+	Statistics statistics = getStatistics ();
+
+	String s;
+	s << statistics.hits << " hits / " << statistics.misses << " misses / " << statistics.evictions << " evictions, ";
+	s << statistics.bytes / 1024 << " KB";
+	return s;
+}
@@ -0,0 +1,89 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scaledimagecache.h
+// Description : Scaled Image Cache
+//
+//************************************************************************************************
+
+#ifndef _scaledimagecache_h
+#define _scaledimagecache_h
+
+#include "ccl/base/singleton.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/iimage.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ScaledImageCache
+/** Downscaled variants (mip levels) of source images. Level n has 1/2^n of the source size
+	and is box filtered from level n-1, so it is sharp and free of aliasing at that size.
+	Draws pick the smallest level that is still at least as large as the target, level 0 is
+	the source itself. Levels are evicted least recently used first beyond the memory limit. */
+//************************************************************************************************
+
+class ScaledImageCache: public Object,
+						public Singleton<ScaledImageCache>
+{
+public:
+	ScaledImageCache ();
+	~ScaledImageCache ();
+
+	static constexpr int64 kDefaultMemoryLimit = 32 * 1024 * 1024;
+	static constexpr int kMaxLevel = 8;
+
+	void setMemoryLimit (int64 bytes);
+	int64 getMemoryUsage () const;
+
+	/** Level for drawing at scale (target pixels per source pixel). */
+	static int getLevel (float scale);
+
+	/** Image of the level (the source itself for level 0), caller releases. */
+	IImage* retainLevel (IImage* source, int level);
+
+	/** Draw src of the source into dst, scale is the device scale including any transform. */
+	void drawImage (IGraphics& graphics, IImage* source, RectRef src, RectRef dst, float scale = 1.f);
+
+	/** High quality bitmap of the source at the given size, not cached. peakBytes receives the
+		largest amount of intermediate bitmap memory alive at the same time. Bitmap sources are
+		only accessed through their pixels, so this can run on background threads; other images
+		are rendered with bitmap graphics first, which is left to the UI thread. */
+	static IImage* createDownscaled (IImage* source, int width, int height, int64* peakBytes = nullptr);
+
+	/** Coarse bitmap of a bitmap source, one source pixel per target pixel. Pixel access only. */
+	static IImage* createSampled (IImage* source, int width, int height);
+
+	struct Statistics
+	{
+		int64 hits = 0;
+		int64 misses = 0;
+		int64 evictions = 0;
+		int64 bytes = 0;
+	};
+
+	Statistics getStatistics () const;
+	String getStatisticsString () const;
+	void removeAll ();
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+};
+
+} // namespace CCL
+
+#endif // _scaledimagecache_h
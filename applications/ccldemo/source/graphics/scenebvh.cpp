@@ -0,0 +1,606 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenebvh.cpp
+// Description : Scene Bounding Volume Hierarchy
+//
+//************************************************************************************************
+
+#include "scenebvh.h"
+
+#include "ccl/public/math/mathprimitives.h"
+
+#include <cmath>
+#include <utility>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace SceneMath
+{
+	struct Matrix3
+	{
+		float m[3][3];
+
+		PointF3D operator * (PointF3DRef p) const
+		{
+			return PointF3D (m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z,
+							 m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z,
+							 m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z);
+		}
+
+		Matrix3 operator * (const Matrix3& other) const
+		{
+			Matrix3 result;
+			for(int i = 0; i < 3; i++)
+				for(int j = 0; j < 3; j++)
+					result.m[i][j] = m[i][0] * other.m[0][j] + m[i][1] * other.m[1][j] + m[i][2] * other.m[2][j];
+			return result;
+		}
+	};
+
+	/** Ry (yaw) * Rx (pitch) * Rz (roll), angles in radians. */
+	static Matrix3 makeRotation (float yaw, float pitch, float roll)
+	{
+		float cy = ::cosf (yaw), sy = ::sinf (yaw);
+		float cp = ::cosf (pitch), sp = ::sinf (pitch);
+		float cr = ::cosf (roll), sr = ::sinf (roll);
+
+		Matrix3 ry = {{{cy, 0.f, sy}, {0.f, 1.f, 0.f}, {-sy, 0.f, cy}}};
+		Matrix3 rx = {{{1.f, 0.f, 0.f}, {0.f, cp, -sp}, {0.f, sp, cp}}};
+		Matrix3 rz = {{{cr, -sr, 0.f}, {sr, cr, 0.f}, {0.f, 0.f, 1.f}}};
+		return ry * rx * rz;
+	}
+
+	inline float dot (PointF3DRef a, PointF3DRef b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline PointF3D add (PointF3DRef a, PointF3DRef b, float factor = 1.f)
+	{
+		return PointF3D (a.x + b.x * factor, a.y + b.y * factor, a.z + b.z * factor);
+	}
+}
+
+using namespace SceneMath;
+
+//************************************************************************************************
+// RotationMatrix3D
+//************************************************************************************************
+
+RotationMatrix3D::RotationMatrix3D (float yaw, float pitch, float roll)
+{
+	Matrix3 rotation = makeRotation (yaw, pitch, roll);
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			m[i][j] = rotation.m[i][j];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PointF3D RotationMatrix3D::operator * (PointF3DRef p) const
+{
+	return PointF3D (m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z,
+					 m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z,
+					 m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+PointF3D RotationMatrix3D::applyInverse (PointF3DRef p) const
+{
+	return PointF3D (m[0][0] * p.x + m[1][0] * p.y + m[2][0] * p.z,
+					 m[0][1] * p.x + m[1][1] * p.y + m[2][1] * p.z,
+					 m[0][2] * p.x + m[1][2] * p.y + m[2][2] * p.z);
+}
+
+//************************************************************************************************
+// BoundingBox3D
+//************************************************************************************************
+
+bool BoundingBox3D::contains (const BoundingBox3D& other) const
+{
+	return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+		&& max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+float BoundingBox3D::getSurfaceArea () const
+{
+	float dx = max.x - min.x;
+	float dy = max.y - min.y;
+	float dz = max.z - min.z;
+	return 2.f * (dx * dy + dy * dz + dz * dx);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+BoundingBox3D& BoundingBox3D::join (const BoundingBox3D& other)
+{
+	min.x = ccl_min (min.x, other.min.x);
+	min.y = ccl_min (min.y, other.min.y);
+	min.z = ccl_min (min.z, other.min.z);
+	max.x = ccl_max (max.x, other.max.x);
+	max.y = ccl_max (max.y, other.max.y);
+	max.z = ccl_max (max.z, other.max.z);
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+BoundingBox3D& BoundingBox3D::expand (float margin)
+{
+	min = add (min, PointF3D (margin, margin, margin), -1.f);
+	max = add (max, PointF3D (margin, margin, margin));
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+BoundingBox3D BoundingBox3D::joined (const BoundingBox3D& a, const BoundingBox3D& b)
+{
+	BoundingBox3D result (a);
+	return result.join (b);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool BoundingBox3D::intersectRay (float& tNear, PointF3DRef origin, PointF3DRef inverseDirection, float maxDistance) const
+{
+	// infinite inverse components are handled by IEEE arithmetic
+	const float origins[3] = {origin.x, origin.y, origin.z};
+	const float inverses[3] = {inverseDirection.x, inverseDirection.y, inverseDirection.z};
+	const float mins[3] = {min.x, min.y, min.z};
+	const float maxs[3] = {max.x, max.y, max.z};
+
+	float t0 = 0.f, t1 = maxDistance;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		float tEnter = (mins[axis] - origins[axis]) * inverses[axis];
+		float tExit = (maxs[axis] - origins[axis]) * inverses[axis];
+		if(tEnter > tExit)
+			std::swap (tEnter, tExit);
+		t0 = tEnter > t0 ? tEnter : t0; // NaN (origin on a slab border) keeps the old value
+		t1 = tExit < t1 ? tExit : t1;
+		if(t0 > t1)
+			return false;
+	}
+	tNear = t0;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+BoundingBox3D BoundingBox3D::transformed (PointF3DRef scale, float yaw, float pitch, float roll, PointF3DRef position) const
+{
+	// Transform the center and project the extents onto the world axes (Arvo)
+	PointF3D center ((min.x + max.x) * .5f * scale.x, (min.y + max.y) * .5f * scale.y, (min.z + max.z) * .5f * scale.z);
+	PointF3D extent ((max.x - min.x) * .5f * ::fabsf (scale.x), (max.y - min.y) * .5f * ::fabsf (scale.y), (max.z - min.z) * .5f * ::fabsf (scale.z));
+
+	Matrix3 rotation = makeRotation (yaw, pitch, roll);
+	Matrix3 absolute;
+	for(int i = 0; i < 3; i++)
+		for(int j = 0; j < 3; j++)
+			absolute.m[i][j] = ::fabsf (rotation.m[i][j]);
+
+	center = add (rotation * center, position);
+	extent = absolute * extent;
+	return BoundingBox3D (add (center, extent, -1.f), add (center, extent));
+}
+
+//************************************************************************************************
+// Frustum3D
+//************************************************************************************************
+
+Frustum3D::Result Frustum3D::classify (const BoundingBox3D& box) const
+{
+	Result result = kInside;
+	for(int i = 0; i < planeCount; i++)
+	{
+		const Plane& plane = planes[i];
+
+		// corner furthest along the normal decides outside, the opposite one inside
+		PointF3D positive (plane.normal.x >= 0.f ? box.max.x : box.min.x,
+						   plane.normal.y >= 0.f ? box.max.y : box.min.y,
+						   plane.normal.z >= 0.f ? box.max.z : box.min.z);
+		if(dot (plane.normal, positive) + plane.distance < 0.f)
+			return kOutside;
+
+		PointF3D negative (plane.normal.x >= 0.f ? box.min.x : box.max.x,
+						   plane.normal.y >= 0.f ? box.min.y : box.max.y,
+						   plane.normal.z >= 0.f ? box.min.z : box.max.z);
+		if(dot (plane.normal, negative) + plane.distance < 0.f)
+			result = kIntersecting;
+	}
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Frustum3D Frustum3D::fromCamera (PointF3DRef position, float yaw, float pitch, float roll,
+								 float fieldOfView, float aspectRatio, float nearDistance, float farDistance)
+{
+	Matrix3 rotation = makeRotation (yaw, pitch, roll);
+	PointF3D forward = rotation * PointF3D (0.f, 0.f, -1.f);
+	PointF3D up = rotation * PointF3D (0.f, 1.f, 0.f);
+	PointF3D right = rotation * PointF3D (1.f, 0.f, 0.f);
+
+	float tanY = ::tanf (Math::degreesToRad (fieldOfView) * .5f);
+	float tanX = tanY * aspectRatio;
+
+	Frustum3D frustum;
+	auto addPlane = [&] (PointF3DRef normal, float offset)
+	{
+		float length = ::sqrtf (dot (normal, normal));
+		Plane& plane = frustum.planes[frustum.planeCount++];
+		plane.normal = PointF3D (normal.x / length, normal.y / length, normal.z / length);
+		plane.distance = (offset - dot (normal, position)) / length;
+	};
+
+	// side planes pass through the camera position
+	addPlane (add (right, forward, tanX), 0.f);
+	addPlane (add (PointF3D (-right.x, -right.y, -right.z), forward, tanX), 0.f);
+	addPlane (add (up, forward, tanY), 0.f);
+	addPlane (add (PointF3D (-up.x, -up.y, -up.z), forward, tanY), 0.f);
+	addPlane (forward, -nearDistance);
+	if(farDistance > 0.f)
+		addPlane (PointF3D (-forward.x, -forward.y, -forward.z), farDistance);
+	return frustum;
+}
+
+//************************************************************************************************
+// DynamicBVH
+//************************************************************************************************
+
+DynamicBVH::DynamicBVH ()
+: margin (kDefaultMargin),
+  root (kNull),
+  freeList (kNull),
+  leafCount (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DynamicBVH::allocateNode ()
+{
+	int index = freeList;
+	if(index == kNull)
+	{
+		nodes.add (Node ());
+		index = nodes.count () - 1;
+	}
+	else
+		freeList = nodes[index].parent;
+
+	Node& node = nodes[index];
+	node.parent = kNull;
+	node.child1 = kNull;
+	node.child2 = kNull;
+	node.height = 0;
+	node.userIndex = -1;
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::freeNode (int index)
+{
+	nodes[index].parent = freeList;
+	nodes[index].height = -1;
+	freeList = index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DynamicBVH::insert (const BoundingBox3D& bounds, int userIndex)
+{
+	int proxy = allocateNode ();
+	nodes[proxy].bounds = bounds;
+	nodes[proxy].bounds.expand (margin);
+	nodes[proxy].userIndex = userIndex;
+	insertLeaf (proxy);
+	leafCount++;
+	return proxy;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::remove (int proxy)
+{
+	ASSERT (nodes[proxy].isLeaf ())
+	removeLeaf (proxy);
+	freeNode (proxy);
+	leafCount--;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DynamicBVH::move (int proxy, const BoundingBox3D& bounds)
+{
+	if(nodes[proxy].bounds.contains (bounds))
+		return false;
+
+	removeLeaf (proxy);
+	nodes[proxy].bounds = bounds;
+	nodes[proxy].bounds.expand (margin);
+	insertLeaf (proxy);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DynamicBVH::getHeight () const
+{
+	return root == kNull ? 0 : nodes[root].height;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::removeAll ()
+{
+	nodes.removeAll ();
+	root = kNull;
+	freeList = kNull;
+	leafCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::insertLeaf (int leaf)
+{
+	if(root == kNull)
+	{
+		root = leaf;
+		nodes[leaf].parent = kNull;
+		return;
+	}
+
+	// Descend to the sibling with the least surface area cost
+	BoundingBox3D leafBounds = nodes[leaf].bounds;
+	int index = root;
+	while(!nodes[index].isLeaf ())
+	{
+		const Node& node = nodes[index];
+		float area = node.bounds.getSurfaceArea ();
+		float combinedArea = BoundingBox3D::joined (node.bounds, leafBounds).getSurfaceArea ();
+
+		// cost of a new parent for this node and the leaf, and the growth pushed to the children
+		float cost = 2.f * combinedArea;
+		float inheritanceCost = 2.f * (combinedArea - area);
+
+		auto getChildCost = [&] (int child)
+		{
+			const Node& childNode = nodes[child];
+			float childArea = BoundingBox3D::joined (childNode.bounds, leafBounds).getSurfaceArea ();
+			if(!childNode.isLeaf ())
+				childArea -= childNode.bounds.getSurfaceArea ();
+			return childArea + inheritanceCost;
+		};
+
+		float cost1 = getChildCost (node.child1);
+		float cost2 = getChildCost (node.child2);
+		if(cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	int sibling = index;
+	int oldParent = nodes[sibling].parent;
+	int newParent = allocateNode (); // may grow the node vector, no references across this call
+
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = BoundingBox3D::joined (leafBounds, nodes[sibling].bounds);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if(oldParent == kNull)
+		root = newParent;
+	else if(nodes[oldParent].child1 == sibling)
+		nodes[oldParent].child1 = newParent;
+	else
+		nodes[oldParent].child2 = newParent;
+
+	refit (newParent);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::removeLeaf (int leaf)
+{
+	if(leaf == root)
+	{
+		root = kNull;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	nodes[sibling].parent = grandParent;
+	freeNode (parent);
+
+	if(grandParent == kNull)
+	{
+		root = sibling;
+		return;
+	}
+
+	if(nodes[grandParent].child1 == parent)
+		nodes[grandParent].child1 = sibling;
+	else
+		nodes[grandParent].child2 = sibling;
+
+	refit (grandParent);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::refit (int index)
+{
+	while(index != kNull)
+	{
+		index = balance (index);
+
+		Node& node = nodes[index];
+		node.height = 1 + ccl_max (nodes[node.child1].height, nodes[node.child2].height);
+		node.bounds = BoundingBox3D::joined (nodes[node.child1].bounds, nodes[node.child2].bounds);
+		index = node.parent;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int DynamicBVH::balance (int iA)
+{
+	// Rotate the higher child of A up if the heights differ by more than one,
+	// returns the index of the node that took the place of A.
+	Node& a = nodes[iA];
+	if(a.isLeaf () || a.height < 2)
+		return iA;
+
+	int iB = a.child1;
+	int iC = a.child2;
+	int heightDifference = nodes[iC].height - nodes[iB].height;
+	if(heightDifference >= -1 && heightDifference <= 1)
+		return iA;
+
+	int iUp = heightDifference > 0 ? iC : iB;		// child moving up
+	int iOther = heightDifference > 0 ? iB : iC;	// child staying below A
+	Node& up = nodes[iUp];
+	int iF = up.child1;
+	int iG = up.child2;
+
+	// up takes the place of A
+	up.child1 = iA;
+	up.parent = a.parent;
+	a.parent = iUp;
+
+	if(up.parent == kNull)
+		root = iUp;
+	else if(nodes[up.parent].child1 == iA)
+		nodes[up.parent].child1 = iUp;
+	else
+		nodes[up.parent].child2 = iUp;
+
+	// the higher grandchild stays with up, the other one replaces up below A
+	int iKeep = nodes[iF].height > nodes[iG].height ? iF : iG;
+	int iMove = iKeep == iF ? iG : iF;
+	up.child2 = iKeep;
+
+	if(heightDifference > 0)
+		a.child2 = iMove;
+	else
+		a.child1 = iMove;
+	nodes[iMove].parent = iA;
+
+	a.bounds = BoundingBox3D::joined (nodes[iOther].bounds, nodes[iMove].bounds);
+	a.height = 1 + ccl_max (nodes[iOther].height, nodes[iMove].height);
+	up.bounds = BoundingBox3D::joined (a.bounds, nodes[iKeep].bounds);
+	up.height = 1 + ccl_max (a.height, nodes[iKeep].height);
+	return iUp;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::collectLeaves (Vector<int>& result, int index) const
+{
+	const Node& node = nodes[index];
+	if(node.isLeaf ())
+		result.add (node.userIndex);
+	else
+	{
+		collectLeaves (result, node.child1);
+		collectLeaves (result, node.child2);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::query (Vector<int>& result, const Frustum3D& frustum, QueryStatistics* statistics) const
+{
+	if(root == kNull)
+		return;
+
+	Vector<int> stack;
+	stack.add (root);
+	while(!stack.isEmpty ())
+	{
+		int index = stack[stack.count () - 1];
+		stack.setCount (stack.count () - 1);
+
+		const Node& node = nodes[index];
+		if(statistics)
+			statistics->visitedNodes++;
+
+		Frustum3D::Result test = frustum.classify (node.bounds);
+		if(test == Frustum3D::kOutside)
+			continue;
+
+		if(node.isLeaf ())
+			result.add (node.userIndex);
+		else if(test == Frustum3D::kInside)
+		{
+			if(statistics)
+				statistics->acceptedSubtrees++;
+			collectLeaves (result, index);
+		}
+		else
+		{
+			stack.add (node.child1);
+			stack.add (node.child2);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DynamicBVH::queryRay (Vector<int>& result, PointF3DRef origin, PointF3DRef direction) const
+{
+	if(root == kNull)
+		return;
+
+	PointF3D inverse (1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+	float tNear = 0.f;
+
+	Vector<int> stack;
+	stack.add (root);
+	while(!stack.isEmpty ())
+	{
+		int index = stack[stack.count () - 1];
+		stack.setCount (stack.count () - 1);
+
+		const Node& node = nodes[index];
+		if(!node.bounds.intersectRay (tNear, origin, inverse))
+			continue;
+
+		if(node.isLeaf ())
+			result.add (node.userIndex);
+		else
+		{
+			stack.add (node.child1);
+			stack.add (node.child2);
+		}
+	}
+}
@@ -0,0 +1,175 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenebvh.h
+// Description : Scene Bounding Volume Hierarchy
+//
+//************************************************************************************************
+
+#ifndef _scenebvh_h
+#define _scenebvh_h
+
+#include "ccl/public/gui/graphics/3d/iscene3d.h"
+#include "ccl/public/collections/vector.h"
+
+#include <cmath>
+
+namespace CCL {
+
+//************************************************************************************************
+// RotationMatrix3D
+/** Rotation around z (roll), then x (pitch), then y (yaw), angles in radians. */
+//************************************************************************************************
+
+struct RotationMatrix3D
+{
+	float m[3][3];
+
+	RotationMatrix3D (float yaw, float pitch, float roll);
+
+	PointF3D operator * (PointF3DRef p) const;
+	PointF3D applyInverse (PointF3DRef p) const;	///< multiply with the transposed matrix
+};
+
+//************************************************************************************************
+// BoundingBox3D
+/** Axis aligned box. */
+//************************************************************************************************
+
+struct BoundingBox3D
+{
+	PointF3D min;
+	PointF3D max;
+
+	BoundingBox3D () {}
+	BoundingBox3D (PointF3DRef min, PointF3DRef max): min (min), max (max) {}
+
+	bool contains (const BoundingBox3D& other) const;
+	float getSurfaceArea () const;
+	BoundingBox3D& join (const BoundingBox3D& other);
+	BoundingBox3D& expand (float margin);
+
+	static BoundingBox3D joined (const BoundingBox3D& a, const BoundingBox3D& b);
+
+	/** Slab test of the ray origin + t * direction for t in [0, maxDistance], inverseDirection holds
+		the reciprocal components of the direction. tNear receives the entry distance. */
+	bool intersectRay (float& tNear, PointF3DRef origin, PointF3DRef inverseDirection, float maxDistance = HUGE_VALF) const;
+
+	/** Bounds of this box scaled, rotated (roll around z, pitch around x, then yaw around y)
+		and moved to position, the order scene nodes apply their attributes in. */
+	BoundingBox3D transformed (PointF3DRef scale, float yaw, float pitch, float roll, PointF3DRef position) const;
+};
+
+//************************************************************************************************
+// Frustum3D
+/** View frustum as inward facing planes. */
+//************************************************************************************************
+
+struct Frustum3D
+{
+	struct Plane
+	{
+		PointF3D normal;
+		float distance;		///< inside where dot (normal, p) + distance >= 0
+	};
+
+	enum Result { kOutside, kIntersecting, kInside };
+
+	Plane planes[6];
+	int planeCount = 0;
+
+	Result classify (const BoundingBox3D& box) const;
+
+	/** Perspective frustum of a camera that looks along -z with all angles zero (rotation order as
+		in BoundingBox3D::transformed ()). fieldOfView is the vertical angle in degrees, a far
+		distance of 0 leaves the frustum open. */
+	static Frustum3D fromCamera (PointF3DRef position, float yaw, float pitch, float roll,
+								 float fieldOfView, float aspectRatio, float nearDistance, float farDistance = 0.f);
+};
+
+//************************************************************************************************
+// DynamicBVH
+/** Bounding volume hierarchy for moving objects. Leaves store boxes enlarged by a margin, so
+	small movements don't change the tree. Leaves that leave their box are reinserted at the
+	place of least surface area growth and the ancestors are refit and rebalanced by rotations,
+	which keeps the height logarithmic. */
+//************************************************************************************************
+
+class DynamicBVH
+{
+public:
+	DynamicBVH ();
+
+	static constexpr float kDefaultMargin = .1f;
+
+	PROPERTY_VARIABLE (float, margin, Margin)
+
+	/** Add a leaf, returns its proxy id. */
+	int insert (const BoundingBox3D& bounds, int userIndex);
+	void remove (int proxy);
+
+	/** Update the bounds of a leaf, returns true if the tree changed. */
+	bool move (int proxy, const BoundingBox3D& bounds);
+
+	int getUserIndex (int proxy) const { return nodes[proxy].userIndex; }
+	const BoundingBox3D& getFatBounds (int proxy) const { return nodes[proxy].bounds; }
+	int getLeafCount () const { return leafCount; }
+	int getHeight () const;
+	void removeAll ();
+
+	struct QueryStatistics
+	{
+		int visitedNodes = 0;
+		int acceptedSubtrees = 0;	///< inside the frustum as a whole, leaves taken without tests
+	};
+
+	/** User indices of the leaves intersecting the frustum. */
+	void query (Vector<int>& result, const Frustum3D& frustum, QueryStatistics* statistics = nullptr) const;
+
+	/** User indices of the leaves whose box the ray hits, in no particular order. */
+	void queryRay (Vector<int>& result, PointF3DRef origin, PointF3DRef direction) const;
+
+protected:
+	static constexpr int kNull = -1;
+
+	struct Node
+	{
+		BoundingBox3D bounds;
+		int parent;				///< next free node for unused nodes
+		int child1;
+		int child2;
+		int height;				///< 0 for leaves, -1 for unused nodes
+		int userIndex;
+
+		bool isLeaf () const { return child1 == kNull; }
+	};
+
+	Vector<Node> nodes;
+	int root;
+	int freeList;
+	int leafCount;
+
+	int allocateNode ();
+	void freeNode (int index);
+	void insertLeaf (int leaf);
+	void removeLeaf (int leaf);
+	int balance (int index);
+	void refit (int index);
+	void collectLeaves (Vector<int>& result, int index) const;
+};
+
+} // namespace CCL
+
+#endif // _scenebvh_h
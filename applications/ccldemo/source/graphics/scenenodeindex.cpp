@@ -0,0 +1,263 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenenodeindex.cpp
+// Description : Scene Node Index
+//
+//************************************************************************************************
+
+#include "scenenodeindex.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace CCL;
+
+//************************************************************************************************
+// SceneNodeIndex::Implementation
+//************************************************************************************************
+
+struct SceneNodeIndex::Implementation
+{
+	struct Entry
+	{
+		ISceneNode3D* node = nullptr;	///< observed, the entry is removed when the node is destroyed
+		ISubject* subject = nullptr;	///< the node as sender of the destroyed message
+		std::string name;
+		int tag = 0;
+	};
+
+	/** Nodes in the order they were added. */
+	typedef std::vector<Entry*> EntryList;
+
+	std::unordered_map<ISceneNode3D*, Entry*> entries;
+	std::unordered_map<std::string, EntryList> names;
+	std::unordered_map<int, EntryList> tags;
+	IScene3D* scene = nullptr;
+	IObserver* observer = nullptr;
+
+	~Implementation ()
+	{
+		removeAll ();
+	}
+
+	void add (ISceneNode3D* node, const std::string& name, int tag)
+	{
+		remove (node);
+
+		Entry* entry = NEW Entry;
+		entry->node = node;
+		entry->subject = UnknownPtr<ISubject> (node);
+		entry->name = name;
+		entry->tag = tag;
+		entries[node] = entry;
+		ISubject::addObserver (node, observer);
+		if(!name.empty ())
+			names[name].push_back (entry);
+		if(tag != 0)
+			tags[tag].push_back (entry);
+	}
+
+	template<typename Map, typename Key>
+	static void unlink (Map& map, const Key& key, Entry* entry)
+	{
+		auto it = map.find (key);
+		if(it == map.end ())
+			return;
+		EntryList& list = it->second;
+		for(auto e = list.begin (); e != list.end (); ++e)
+			if(*e == entry)
+			{
+				list.erase (e);
+				break;
+			}
+		if(list.empty ())
+			map.erase (it);
+	}
+
+	void remove (Entry* entry)
+	{
+		unlink (names, entry->name, entry);
+		unlink (tags, entry->tag, entry);
+		delete entry;
+	}
+
+	void remove (ISceneNode3D* node)
+	{
+		auto it = entries.find (node);
+		if(it == entries.end ())
+			return;
+
+		Entry* entry = it->second;
+		entries.erase (it);
+		ISubject::removeObserver (node, observer);
+		remove (entry);
+	}
+
+	/** Called while the node is destroyed, before its address can be reused by a new node. */
+	void removeDestroyed (ISubject* subject)
+	{
+		for(auto it = entries.begin (); it != entries.end (); ++it)
+			if(it->second->subject == subject)
+			{
+				Entry* entry = it->second;
+				entries.erase (it);
+				remove (entry);
+				return;
+			}
+	}
+
+	/** First entry of the list whose node is a child of the scene. */
+	template<typename Map, typename Key>
+	ISceneNode3D* findFirst (const Map& map, const Key& key) const
+	{
+		auto it = map.find (key);
+		if(it == map.end ())
+			return nullptr;
+
+		for(Entry* entry : it->second)
+			if(isInScene (entry->node))
+				return entry->node;
+		return nullptr;
+	}
+
+	bool isInScene (ISceneNode3D* node) const
+	{
+		return scene && isEqualUnknown (node->getParentNode (), scene);
+	}
+
+	void removeAll ()
+	{
+		for(auto& entry : entries)
+		{
+			ISubject::removeObserver (entry.first, observer);
+			delete entry.second;
+		}
+		entries.clear ();
+		names.clear ();
+		tags.clear ();
+	}
+};
+
+//************************************************************************************************
+// SceneNodeIndex
+//************************************************************************************************
+
+SceneNodeIndex::SceneNodeIndex ()
+: implementation (NEW Implementation)
+{
+	implementation->observer = this;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SceneNodeIndex::~SceneNodeIndex ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult SceneNodeIndex::addNode (IScene3D& scene, ISceneNode3D* node, StringID name, int tag)
+{
+	if(!name.isEmpty ())
+		node->setNodeName (name);
+
+	// the scene takes over the reference of the caller, the index only observes the node
+	implementation->scene = &scene;
+	tresult result = scene.getChildren ()->addNode (node);
+	if(result == kResultOk && (!name.isEmpty () || tag != 0))
+		implementation->add (node, name.str (), tag);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+tresult SceneNodeIndex::removeNode (IScene3D& scene, ISceneNode3D* node)
+{
+	if(!node)
+		return kResultInvalidArgument;
+
+	tresult result = scene.getChildren ()->removeNode (node);
+	if(result == kResultOk)
+		implementation->remove (node);
+	return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SceneNodeIndex::renameNode (ISceneNode3D* node, StringID name)
+{
+	node->setNodeName (name);
+
+	auto it = implementation->entries.find (node);
+	int tag = it != implementation->entries.end () ? it->second->tag : 0;
+	if(!name.isEmpty () || tag != 0)
+		implementation->add (node, name.str (), tag);
+	else
+		implementation->remove (node);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ISceneNode3D* SceneNodeIndex::findNode (StringID name) const
+{
+	return implementation->findFirst (implementation->names, std::string (name.str ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ISceneNode3D* SceneNodeIndex::findNodeByTag (int tag) const
+{
+	return implementation->findFirst (implementation->tags, tag);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SceneNodeIndex::collectNodes (Vector<ISceneNode3D*>& result, StringID name) const
+{
+	auto it = implementation->names.find (name.str ());
+	if(it == implementation->names.end ())
+		return;
+
+	for(Implementation::Entry* entry : it->second)
+		if(implementation->isInScene (entry->node))
+			result.add (entry->node);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int SceneNodeIndex::count () const
+{
+	return int (implementation->entries.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SceneNodeIndex::removeAll ()
+{
+	implementation->removeAll ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CCL_API SceneNodeIndex::notify (ISubject* subject, MessageRef msg)
+{
+	if(msg == kDestroyed)
+		implementation->removeDestroyed (subject);
+	else
+		Object::notify (subject, msg);
+}
@@ -0,0 +1,75 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenenodeindex.h
+// Description : Scene Node Index
+//
+//************************************************************************************************
+
+#ifndef _scenenodeindex_h
+#define _scenenodeindex_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/3d/iscene3d.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// SceneNodeIndex
+/** Hash index from name and tag to the top level nodes of a scene, so lookups don't search the
+	children of the scene. Nodes are added, removed and renamed through the index to keep it
+	consistent. Nodes with empty name and tag 0 are passed through to the scene only.
+
+	The index observes its nodes instead of holding references: a node is dropped when it is
+	destroyed, and nodes removed from the scene behind the index's back are not found until
+	they are added again.
+	Several nodes can share a name or tag, lookups return the first one added. */
+//************************************************************************************************
+
+class SceneNodeIndex: public Object
+{
+public:
+	SceneNodeIndex ();
+	~SceneNodeIndex ();
+
+	/** Name the node and add it to the scene, which takes ownership as with addNode (). */
+	tresult addNode (IScene3D& scene, ISceneNode3D* node, StringID name, int tag = 0);
+
+	/** Remove the node from the scene, ownership goes back to the caller as with removeNode (). */
+	tresult removeNode (IScene3D& scene, ISceneNode3D* node);
+
+	void renameNode (ISceneNode3D* node, StringID name);
+
+	ISceneNode3D* findNode (StringID name) const;
+	ISceneNode3D* findNodeByTag (int tag) const;
+
+	/** All nodes in the scene with the name, in the order they were added. */
+	void collectNodes (Vector<ISceneNode3D*>& result, StringID name) const;
+	int count () const;
+	void removeAll ();
+
+	// Object
+	void CCL_API notify (ISubject* subject, MessageRef msg) override;
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+};
+
+} // namespace CCL
+
+#endif // _scenenodeindex_h
@@ -0,0 +1,597 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenepicker.cpp
+// Description : Scene Picker
+//
+//************************************************************************************************
+
+#include "scenepicker.h"
+
+#include "ccl/public/math/mathprimitives.h"
+#include "ccl/public/systemservices.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace CCL;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace PickMath
+{
+	static constexpr int kMaxDepth = 64;
+	static constexpr int kNumBins = 12;
+
+	inline float component (PointF3DRef p, int axis)
+	{
+		return axis == 0 ? p.x : axis == 1 ? p.y : p.z;
+	}
+
+	inline PointF3D subtract (PointF3DRef a, PointF3DRef b)
+	{
+		return PointF3D (a.x - b.x, a.y - b.y, a.z - b.z);
+	}
+
+	inline PointF3D cross (PointF3DRef a, PointF3DRef b)
+	{
+		return PointF3D (a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+	}
+
+	inline float dot (PointF3DRef a, PointF3DRef b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline PointF3D reciprocal (PointF3DRef p)
+	{
+		return PointF3D (1.f / p.x, 1.f / p.y, 1.f / p.z);
+	}
+
+	/** Möller-Trumbore, both sides of the triangle count. */
+	inline bool intersectTriangle (float& t, PointF3DRef origin, PointF3DRef direction, const PointF3D* v)
+	{
+		PointF3D e1 = subtract (v[1], v[0]);
+		PointF3D e2 = subtract (v[2], v[0]);
+		PointF3D p = cross (direction, e2);
+		float determinant = dot (e1, p);
+		if(::fabsf (determinant) < 1e-12f)
+			return false;
+
+		float inverse = 1.f / determinant;
+		PointF3D s = subtract (origin, v[0]);
+		float u = dot (s, p) * inverse;
+		if(u < 0.f || u > 1.f)
+			return false;
+
+		PointF3D q = cross (s, e1);
+		float w = dot (direction, q) * inverse;
+		if(w < 0.f || u + w > 1.f)
+			return false;
+
+		t = dot (e2, q) * inverse;
+		return t >= 0.f;
+	}
+}
+
+using namespace PickMath;
+
+//************************************************************************************************
+// TriangleBVH::BuildItem
+//************************************************************************************************
+
+struct TriangleBVH::BuildItem
+{
+	BoundingBox3D bounds;
+	PointF3D centroid;
+	int id;
+};
+
+//************************************************************************************************
+// TriangleBVH
+//************************************************************************************************
+
+TriangleBVH::TriangleBVH ()
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TriangleBVH::build (const MeshData& mesh)
+{
+	nodes.removeAll ();
+	vertices.removeAll ();
+	triangleIds.removeAll ();
+
+	int triangleCount = mesh.getTriangleCount ();
+	if(triangleCount == 0)
+		return;
+
+	std::vector<BuildItem> items (triangleCount);
+	for(int i = 0; i < triangleCount; i++)
+	{
+		const PointF3D& a = mesh.positions[mesh.indices[i * 3]];
+		const PointF3D& b = mesh.positions[mesh.indices[i * 3 + 1]];
+		const PointF3D& c = mesh.positions[mesh.indices[i * 3 + 2]];
+
+		BuildItem& item = items[i];
+		item.bounds = BoundingBox3D (a, a);
+		item.bounds.join (BoundingBox3D (b, b)).join (BoundingBox3D (c, c));
+		item.centroid = PointF3D ((a.x + b.x + c.x) / 3.f, (a.y + b.y + c.y) / 3.f, (a.z + b.z + c.z) / 3.f);
+		item.id = i;
+	}
+
+	buildNode (items.data (), 0, triangleCount, 0);
+
+	// leaves refer to ranges of the partitioned items
+	vertices.setCount (triangleCount * 3);
+	triangleIds.setCount (triangleCount);
+	for(int i = 0; i < triangleCount; i++)
+	{
+		int id = items[i].id;
+		for(int k = 0; k < 3; k++)
+			vertices[i * 3 + k] = mesh.positions[mesh.indices[id * 3 + k]];
+		triangleIds[i] = id;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int TriangleBVH::buildNode (BuildItem* items, int first, int count, int depth)
+{
+	int index = nodes.count ();
+	nodes.add (Node ());
+
+	BoundingBox3D bounds = items[first].bounds;
+	BoundingBox3D centroidBounds (items[first].centroid, items[first].centroid);
+	for(int i = first + 1; i < first + count; i++)
+	{
+		bounds.join (items[i].bounds);
+		centroidBounds.join (BoundingBox3D (items[i].centroid, items[i].centroid));
+	}
+
+	auto makeLeaf = [&] ()
+	{
+		Node& node = nodes[index];
+		node.bounds = bounds;
+		node.first = first;
+		node.count = count;
+		return index;
+	};
+
+	if(count <= kMaxLeafSize || depth >= kMaxDepth)
+		return makeLeaf ();
+
+	int axis = 0;
+	PointF3D extent = subtract (centroidBounds.max, centroidBounds.min);
+	if(extent.y > extent.x)
+		axis = 1;
+	if(extent.z > component (extent, axis))
+		axis = 2;
+
+	float axisMin = component (centroidBounds.min, axis);
+	float axisExtent = component (extent, axis);
+	int middle = first;
+
+	if(axisExtent > 0.f)
+	{
+		// Bin the centroids and choose the split with the least surface area cost
+		struct Bin
+		{
+			BoundingBox3D bounds;
+			int count = 0;
+		};
+		Bin bins[kNumBins];
+		float binScale = kNumBins * (1.f - 1e-5f) / axisExtent;
+		auto getBin = [&] (const BuildItem& item)
+		{
+			return ccl_min (int ((component (item.centroid, axis) - axisMin) * binScale), kNumBins - 1);
+		};
+
+		for(int i = first; i < first + count; i++)
+		{
+			Bin& bin = bins[getBin (items[i])];
+			if(bin.count++ == 0)
+				bin.bounds = items[i].bounds;
+			else
+				bin.bounds.join (items[i].bounds);
+		}
+
+		float rightAreas[kNumBins] = {};
+		int rightCounts[kNumBins] = {};
+		BoundingBox3D accumulated;
+		int accumulatedCount = 0;
+		for(int b = kNumBins - 1; b > 0; b--)
+		{
+			if(bins[b].count > 0)
+				accumulated = accumulatedCount == 0 ? bins[b].bounds : accumulated.join (bins[b].bounds);
+			accumulatedCount += bins[b].count;
+			rightAreas[b] = accumulatedCount > 0 ? accumulated.getSurfaceArea () : 0.f;
+			rightCounts[b] = accumulatedCount;
+		}
+
+		float bestCost = HUGE_VALF;
+		int bestSplit = -1;
+		accumulatedCount = 0;
+		for(int b = 0; b < kNumBins - 1; b++)
+		{
+			if(bins[b].count > 0)
+				accumulated = accumulatedCount == 0 ? bins[b].bounds : accumulated.join (bins[b].bounds);
+			accumulatedCount += bins[b].count;
+			if(accumulatedCount == 0 || rightCounts[b + 1] == 0)
+				continue;
+
+			float cost = accumulatedCount * accumulated.getSurfaceArea () + rightCounts[b + 1] * rightAreas[b + 1];
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = b;
+			}
+		}
+
+		float leafCost = count * bounds.getSurfaceArea ();
+		if(bestSplit < 0 || (bestCost >= leafCost && count <= 4 * kMaxLeafSize))
+			return makeLeaf ();
+
+		middle = int (std::partition (items + first, items + first + count, [&] (const BuildItem& item) { return getBin (item) <= bestSplit; }) - items);
+	}
+
+	if(middle == first || middle == first + count)
+	{
+		// coincident centroids, split by count
+		middle = first + count / 2;
+		std::nth_element (items + first, items + middle, items + first + count, [axis] (const BuildItem& a, const BuildItem& b)
+		{
+			return component (a.centroid, axis) < component (b.centroid, axis);
+		});
+	}
+
+	buildNode (items, first, middle - first, depth + 1);
+	int second = buildNode (items, middle, first + count - middle, depth + 1);
+
+	Node& node = nodes[index];
+	node.bounds = bounds;
+	node.first = second;
+	node.count = 0;
+	return index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool TriangleBVH::intersect (float& distance, PointF3DRef origin, PointF3DRef direction, int* triangle) const
+{
+	if(nodes.isEmpty ())
+		return false;
+
+	PointF3D inverse = reciprocal (direction);
+	float best = distance;
+	int bestTriangle = -1;
+
+	int stack[2 * kMaxDepth + 2];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize > 0)
+	{
+		int index = stack[--stackSize];
+		const Node& node = nodes[index];
+		float tNear = 0.f;
+		if(!node.bounds.intersectRay (tNear, origin, inverse, best))
+			continue;
+
+		if(node.count > 0)
+		{
+			for(int i = node.first; i < node.first + node.count; i++)
+			{
+				float t = 0.f;
+				if(intersectTriangle (t, origin, direction, &vertices[i * 3]) && t < best)
+				{
+					best = t;
+					bestTriangle = i;
+				}
+			}
+			continue;
+		}
+
+		// visit the nearer child first
+		int child1 = index + 1;
+		int child2 = node.first;
+		float t1 = 0.f, t2 = 0.f;
+		bool hit1 = nodes[child1].bounds.intersectRay (t1, origin, inverse, best);
+		bool hit2 = nodes[child2].bounds.intersectRay (t2, origin, inverse, best);
+		if(hit1 && hit2)
+		{
+			stack[stackSize++] = t1 <= t2 ? child2 : child1;
+			stack[stackSize++] = t1 <= t2 ? child1 : child2;
+		}
+		else if(hit1)
+			stack[stackSize++] = child1;
+		else if(hit2)
+			stack[stackSize++] = child2;
+	}
+
+	if(bestTriangle < 0)
+		return false;
+
+	distance = best;
+	if(triangle)
+		*triangle = triangleIds[bestTriangle];
+	return true;
+}
+
+//************************************************************************************************
+// ScenePicker::Implementation
+//************************************************************************************************
+
+struct ScenePicker::Implementation
+{
+	struct Entry
+	{
+		ISceneNode3D* node = nullptr;	///< null for unused entries
+		const MeshData* mesh = nullptr;
+		BoundingBox3D localBounds;
+		Placement placement;
+		RotationMatrix3D rotation {0.f, 0.f, 0.f};
+		int proxy = -1;
+	};
+
+	std::vector<Entry> entries;
+	std::vector<int> freeEntries;
+	std::unordered_map<ISceneNode3D*, int> entryOfNode;
+	std::unordered_map<const MeshData*, std::unique_ptr<TriangleBVH>> meshTrees;
+	DynamicBVH tree;
+	double buildMs = 0.;
+
+	TriangleBVH* getMeshTree (const MeshData* mesh)
+	{
+		std::unique_ptr<TriangleBVH>& meshTree = meshTrees[mesh];
+		if(!meshTree)
+		{
+			double startTime = System::GetProfileTime ();
+			meshTree.reset (new TriangleBVH);
+			meshTree->build (*mesh);
+			buildMs += (System::GetProfileTime () - startTime) * 1000.;
+		}
+		return meshTree.get ();
+	}
+};
+
+//************************************************************************************************
+// ScenePicker
+//************************************************************************************************
+
+ScenePicker::ScenePicker ()
+: implementation (NEW Implementation)
+{
+	implementation->tree.setMargin (0.f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScenePicker::~ScenePicker ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::addNode (ISceneNode3D* node, const MeshData& mesh, const Placement& placement)
+{
+	addEntry (node, &mesh, BoundingBox3D (mesh.boundsMin, mesh.boundsMax), placement);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::addNode (ISceneNode3D* node, const BoundingBox3D& localBounds, const Placement& placement)
+{
+	addEntry (node, nullptr, localBounds, placement);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::addEntry (ISceneNode3D* node, const MeshData* mesh, const BoundingBox3D& localBounds, const Placement& placement)
+{
+	removeNode (node);
+
+	int index = 0;
+	if(implementation->freeEntries.empty ())
+	{
+		index = int (implementation->entries.size ());
+		implementation->entries.emplace_back ();
+	}
+	else
+	{
+		index = implementation->freeEntries.back ();
+		implementation->freeEntries.pop_back ();
+	}
+
+	Implementation::Entry& entry = implementation->entries[index];
+	entry.node = node;
+	entry.mesh = mesh;
+	entry.localBounds = localBounds;
+	entry.placement = placement;
+	entry.rotation = RotationMatrix3D (placement.yaw, placement.pitch, placement.roll);
+
+	BoundingBox3D worldBounds = localBounds.transformed (placement.scale, placement.yaw, placement.pitch, placement.roll, placement.position);
+	entry.proxy = implementation->tree.insert (worldBounds, index);
+	implementation->entryOfNode[node] = index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::removeNode (ISceneNode3D* node)
+{
+	auto it = implementation->entryOfNode.find (node);
+	if(it == implementation->entryOfNode.end ())
+		return;
+
+	Implementation::Entry& entry = implementation->entries[it->second];
+	implementation->tree.remove (entry.proxy);
+	entry = Implementation::Entry ();
+	implementation->freeEntries.push_back (it->second);
+	implementation->entryOfNode.erase (it);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::removeMesh (const MeshData& mesh)
+{
+	implementation->meshTrees.erase (&mesh);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::removeAll ()
+{
+	implementation->entries.clear ();
+	implementation->freeEntries.clear ();
+	implementation->entryOfNode.clear ();
+	implementation->meshTrees.clear ();
+	implementation->tree.removeAll ();
+	implementation->buildMs = 0.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int ScenePicker::countNodes () const
+{
+	return int (implementation->entryOfNode.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ScenePicker::pick (Hit& hit, PointF3DRef origin, PointF3DRef direction)
+{
+	Vector<int> candidates;
+	implementation->tree.queryRay (candidates, origin, direction);
+	if(candidates.isEmpty ())
+		return false;
+
+	// test the nodes in order of their box entry, stop at boxes behind the nearest hit
+	PointF3D inverse = reciprocal (direction);
+	std::vector<std::pair<float, int>> ordered;
+	ordered.reserve (candidates.count ());
+	for(int index : candidates)
+	{
+		float tNear = 0.f;
+		if(implementation->tree.getFatBounds (implementation->entries[index].proxy).intersectRay (tNear, origin, inverse))
+			ordered.emplace_back (tNear, index);
+	}
+	std::sort (ordered.begin (), ordered.end ());
+
+	float best = HUGE_VALF;
+	for(const auto& candidate : ordered)
+	{
+		if(candidate.first > best)
+			break;
+
+		const Implementation::Entry& entry = implementation->entries[candidate.second];
+		const Placement& placement = entry.placement;
+
+		// the ray in mesh space keeps its parameterization, so distances compare across nodes
+		PointF3D localOrigin = entry.rotation.applyInverse (subtract (origin, placement.position));
+		PointF3D localDirection = entry.rotation.applyInverse (direction);
+		localOrigin = PointF3D (localOrigin.x / placement.scale.x, localOrigin.y / placement.scale.y, localOrigin.z / placement.scale.z);
+		localDirection = PointF3D (localDirection.x / placement.scale.x, localDirection.y / placement.scale.y, localDirection.z / placement.scale.z);
+
+		float distance = best;
+		int triangle = -1;
+		bool hitNode = false;
+		if(entry.mesh)
+			hitNode = implementation->getMeshTree (entry.mesh)->intersect (distance, localOrigin, localDirection, &triangle);
+		else
+			hitNode = entry.localBounds.intersectRay (distance, localOrigin, reciprocal (localDirection), best);
+
+		if(hitNode && distance < best)
+		{
+			best = distance;
+			hit.node = entry.node;
+			hit.distance = distance;
+			hit.triangle = triangle;
+		}
+	}
+	return best < HUGE_VALF;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScenePicker::makeRay (PointF3D& origin, PointF3D& direction, ICamera3D& camera, PointFRef where, PointFRef viewSize)
+{
+	RotationMatrix3D rotation (camera.getYawAngle (), camera.getPitchAngle (), camera.getRollAngle ());
+	float tanY = ::tanf (Math::degreesToRad (camera.getFieldOfViewAngle ()) * .5f);
+	float tanX = viewSize.y > 0 ? tanY * viewSize.x / viewSize.y : tanY;
+
+	float x = viewSize.x > 0 ? 2.f * where.x / viewSize.x - 1.f : 0.f;
+	float y = viewSize.y > 0 ? 1.f - 2.f * where.y / viewSize.y : 0.f;
+
+	origin = camera.getPosition ();
+	direction = rotation * PointF3D (x * tanX, y * tanY, -1.f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ScenePicker::pickAt (Hit& hit, ICamera3D& camera, PointFRef where, PointFRef viewSize)
+{
+	PointF3D origin, direction;
+	makeRay (origin, direction, camera, where, viewSize);
+	return pick (hit, origin, direction);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+String ScenePicker::runBenchmark (ICamera3D& camera, PointFRef viewSize, int columns, int rows)
+{
+	// build all triangle hierarchies up front, so the rays measure picking only
+	implementation->buildMs = 0.;
+	int64 triangleCount = 0;
+	for(const auto& entry : implementation->entries)
+		if(entry.node && entry.mesh)
+		{
+			implementation->getMeshTree (entry.mesh);
+			triangleCount += entry.mesh->getTriangleCount ();
+		}
+
+	int hits = 0;
+	double totalMs = 0.;
+	double maxMs = 0.;
+	for(int row = 0; row < rows; row++)
+		for(int column = 0; column < columns; column++)
+		{
+			PointF where ((column + .5f) * viewSize.x / columns, (row + .5f) * viewSize.y / rows);
+			Hit hit;
+			double startTime = System::GetProfileTime ();
+			if(pickAt (hit, camera, where, viewSize))
+				hits++;
+			double ms = (System::GetProfileTime () - startTime) * 1000.;
+			totalMs += ms;
+			maxMs = ccl_max (maxMs, ms);
+		}
+
+	int rays = ccl_max (1, rows * columns);
+	String s;
+	s << countNodes () << " nodes, " << triangleCount << " triangles, " << int (implementation->meshTrees.size ()) << " meshes: build ";
+	s.appendFloatValue (implementation->buildMs, 1);
+	s << "ms | " << rays << " rays, " << hits << " hits: avg ";
+	s.appendFloatValue (totalMs * 1000. / rays, 1);
+	s << "us / max ";
+	s.appendFloatValue (maxMs * 1000., 1);
+	s << "us";
+	return s;
+}
@@ -0,0 +1,127 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scenepicker.h
+// Description : Scene Picker
+//
+//************************************************************************************************
+
+#ifndef _scenepicker_h
+#define _scenepicker_h
+
+#include "meshdata.h"
+#include "scenebvh.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// TriangleBVH
+/** Static bounding volume hierarchy over the triangles of a mesh, built top down with binned
+	surface area splits. Triangles are stored in tree order, so leaves read them sequentially. */
+//************************************************************************************************
+
+class TriangleBVH
+{
+public:
+	TriangleBVH ();
+
+	static constexpr int kMaxLeafSize = 4;
+
+	void build (const MeshData& mesh);
+
+	/** Nearest hit closer than distance, which receives the hit distance. */
+	bool intersect (float& distance, PointF3DRef origin, PointF3DRef direction, int* triangle = nullptr) const;
+
+	int getTriangleCount () const { return triangleIds.count (); }
+	int getNodeCount () const { return nodes.count (); }
+
+protected:
+	struct Node
+	{
+		BoundingBox3D bounds;
+		int first;			///< first triangle for leaves, second child for inner nodes (the first one follows)
+		int count;			///< 0 for inner nodes
+	};
+
+	Vector<Node> nodes;
+	Vector<PointF3D> vertices;	///< three per triangle, in tree order
+	Vector<int> triangleIds;	///< mesh triangle index per stored triangle
+
+	struct BuildItem;
+	int buildNode (BuildItem* items, int first, int count, int depth);
+};
+
+//************************************************************************************************
+// ScenePicker
+/** Ray picking for scene nodes. Nodes are registered with their mesh and placement and kept in
+	a DynamicBVH by world bounds; triangle hierarchies are built per mesh on the first ray that
+	reaches one of its nodes and shared by all nodes using the mesh. Nodes without a mesh are
+	hit by their bounds. Nodes are not retained, remove them before releasing them. */
+//************************************************************************************************
+
+class ScenePicker: public Object
+{
+public:
+	ScenePicker ();
+	~ScenePicker ();
+
+	struct Placement
+	{
+		PointF3D position;
+		PointF3D scale = PointF3D (1.f, 1.f, 1.f);
+		float yaw = 0.f;		///< radians
+		float pitch = 0.f;
+		float roll = 0.f;
+	};
+
+	struct Hit
+	{
+		ISceneNode3D* node = nullptr;
+		float distance = 0.f;	///< along the ray direction, in units of its length
+		int triangle = -1;
+	};
+
+	/** Register a node, the mesh must stay unchanged while it is registered. */
+	void addNode (ISceneNode3D* node, const MeshData& mesh, const Placement& placement);
+	void addNode (ISceneNode3D* node, const BoundingBox3D& localBounds, const Placement& placement);
+	void removeNode (ISceneNode3D* node);
+
+	/** Discard the triangle hierarchy of a mesh, e.g. before its contents change. */
+	void removeMesh (const MeshData& mesh);
+	void removeAll ();
+	int countNodes () const;
+
+	/** Nearest node hit by the ray origin + t * direction, t >= 0. */
+	bool pick (Hit& hit, PointF3DRef origin, PointF3DRef direction);
+
+	/** Pick through a point of a view showing the scene with the camera. */
+	bool pickAt (Hit& hit, ICamera3D& camera, PointFRef where, PointFRef viewSize);
+
+	/** Ray through a view point, camera angles and field of view as in Frustum3D::fromCamera (). */
+	static void makeRay (PointF3D& origin, PointF3D& direction, ICamera3D& camera, PointFRef where, PointFRef viewSize);
+
+	/** Time of building the triangle hierarchies and picking a grid of view points. */
+	String runBenchmark (ICamera3D& camera, PointFRef viewSize, int columns = 64, int rows = 48);
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+
+	void addEntry (ISceneNode3D* node, const MeshData* mesh, const BoundingBox3D& localBounds, const Placement& placement);
+};
+
+} // namespace CCL
+
+#endif // _scenepicker_h
@@ -0,0 +1,122 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scrollingtexture.cpp
+// Description : Scrolling Texture
+//
+//************************************************************************************************
+
+#include "scrollingtexture.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// ScrollingTexture
+//************************************************************************************************
+
+ScrollingTexture::ScrollingTexture ()
+: speed (kDefaultSpeed),
+  mipmapsEnabled (false),
+  startTime (-1.),
+  lastOffset (-1)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ScrollingTexture::setup (IImage* _content, int width, int height)
+{
+	content.share (_content);
+	texture = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+	if(!content || !texture)
+		return false;
+
+	if(AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (texture))
+		graphics->clearRect (Rect (0, 0, width, height));
+
+	contentRect = Rect ();
+	dirtyRect = Rect ();
+	startTime = -1.;
+	lastOffset = -1;
+
+	// 4 bytes per pixel, a full mip chain adds a third
+	statistics.textureBytes = int64 (width) * height * 4;
+	if(mipmapsEnabled)
+		statistics.textureBytes += statistics.textureBytes / 3;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool ScrollingTexture::update (double time)
+{
+	if(!texture)
+		return false;
+
+	statistics.ticks++;
+	if(startTime < 0.)
+		startTime = time;
+
+	// the content top moves from the bottom edge until the content has left at the top
+	int width = texture->getWidth ();
+	int height = texture->getHeight ();
+	int period = height + content->getHeight () + 1;
+	int offset = int ((time - startTime) * speed) % period;
+	if(offset == lastOffset)
+		return false;
+	lastOffset = offset;
+
+	Rect newRect (0, height - offset, content->getWidth (), height - offset + content->getHeight ());
+	Rect textureRect (0, 0, width, height);
+
+	dirtyRect = newRect;
+	if(!contentRect.isEmpty ())
+		dirtyRect.join (contentRect);
+	dirtyRect.bound (textureRect);
+	contentRect = newRect;
+	if(dirtyRect.isEmpty ())
+		return false;
+
+	AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (texture);
+	if(!graphics)
+		return false;
+
+	graphics->clearRect (dirtyRect);
+	Rect dst (newRect);
+	dst.bound (textureRect);
+	if(!dst.isEmpty ())
+	{
+		Rect src (dst);
+		src.offset (-newRect.left, -newRect.top);
+		graphics->drawImage (content, src, dst);
+	}
+
+	statistics.uploads++;
+	statistics.uploadedBytes += statistics.textureBytes;
+	statistics.dirtyBytes += int64 (width) * dirtyRect.getHeight () * 4;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ScrollingTexture::resetStatistics ()
+{
+	int64 textureBytes = statistics.textureBytes;
+	statistics = Statistics ();
+	statistics.textureBytes = textureBytes;
+}
@@ -0,0 +1,86 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : scrollingtexture.h
+// Description : Scrolling Texture
+//
+//************************************************************************************************
+
+#ifndef _scrollingtexture_h
+#define _scrollingtexture_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/iimage.h"
+#include "ccl/public/gui/graphics/rect.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// ScrollingTexture
+/** Texture bitmap showing content that scrolls upwards, entering at the bottom edge and leaving
+	at the top. The content is rasterized once by the caller and copied into the texture at its
+	current position, only the rows covered before or after the move are touched. The position
+	follows the time, so the texture changes (and needs to be uploaded) at most once per pixel
+	of movement, however often update () is called. */
+//************************************************************************************************
+
+class ScrollingTexture: public Object
+{
+public:
+	ScrollingTexture ();
+
+	static constexpr float kDefaultSpeed = 60.f;	///< pixels per second
+
+	PROPERTY_VARIABLE (float, speed, Speed)
+	PROPERTY_BOOL (mipmapsEnabled, MipmapsEnabled)	///< only affects the upload size counted
+
+	/** Create the texture bitmap, the content image is kept. */
+	bool setup (IImage* content, int width, int height);
+
+	IImage* getTexture () const { return texture; }
+
+	/** Move the content to its position at time (seconds), returns true if the texture changed
+		and has to be uploaded again. */
+	bool update (double time);
+
+	/** Rows of the texture changed by the last update. */
+	RectRef getDirtyRect () const { return dirtyRect; }
+
+	struct Statistics
+	{
+		int64 ticks = 0;			///< update () calls
+		int64 uploads = 0;			///< update () calls that changed the texture
+		int64 uploadedBytes = 0;	///< whole texture (and mip levels) per upload
+		int64 dirtyBytes = 0;		///< changed rows only
+		int64 textureBytes = 0;		///< one upload including mip levels
+	};
+
+	const Statistics& getStatistics () const { return statistics; }
+	void resetStatistics ();
+
+protected:
+	AutoPtr<IImage> content;
+	AutoPtr<IImage> texture;
+	Rect contentRect;				///< in texture coordinates
+	Rect dirtyRect;
+	double startTime;
+	int lastOffset;
+	Statistics statistics;
+};
+
+} // namespace CCL
+
+#endif // _scrollingtexture_h
@@ -0,0 +1,785 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : softwarerasterizer.cpp
+// Description : Software Rasterizer
+//
+//************************************************************************************************
+
+#include "softwarerasterizer.h"
+#include "scenebvh.h"
+
+#include "../workerpool.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/math/mathprimitives.h"
+#include "ccl/public/systemservices.h"
+
+#include "core/gui/corebitmapprimitives.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace CCL;
+
+//************************************************************************************************
+// Helpers
+//************************************************************************************************
+
+namespace RasterMath
+{
+	static constexpr int kSubpixelBits = 4;			///< fixed point precision of screen positions
+	static constexpr int kSubpixelScale = 1 << kSubpixelBits;
+	static constexpr float kGuardBand = 2.f;		///< triangles are clipped at twice the view size
+	static constexpr int kVertexBatch = 4096;		///< vertices per vertex pass job
+	static constexpr int kTriangleBatch = 2048;		///< triangles per binning job
+	static constexpr int kMaxClipVertices = 8;		///< a triangle clipped at 5 planes
+
+	struct ViewVertex
+	{
+		PointF3D position;		///< view space, visible at negative z
+		float light;
+		PointF coordinate;		///< texture coordinate
+	};
+
+	inline ViewVertex interpolate (const ViewVertex& a, const ViewVertex& b, float t)
+	{
+		ViewVertex v;
+		v.position = PointF3D (a.position.x + (b.position.x - a.position.x) * t,
+							   a.position.y + (b.position.y - a.position.y) * t,
+							   a.position.z + (b.position.z - a.position.z) * t);
+		v.light = a.light + (b.light - a.light) * t;
+		v.coordinate = PointF (a.coordinate.x + (b.coordinate.x - a.coordinate.x) * t,
+							   a.coordinate.y + (b.coordinate.y - a.coordinate.y) * t);
+		return v;
+	}
+
+	inline uint8 toByte (float value)
+	{
+		return uint8 (ccl_max (0.f, ccl_min (value, 1.f)) * 255.f + .5f);
+	}
+
+	inline const uint8* sampleTexture (const SoftwareRasterizer::Texture& texture, float u, float v)
+	{
+		int x = int ((u - ::floorf (u)) * texture.width);
+		int y = int ((v - ::floorf (v)) * texture.height);
+		x = ccl_max (0, ccl_min (x, texture.width - 1));
+		y = ccl_max (0, ccl_min (y, texture.height - 1));
+		return reinterpret_cast<const uint8*> (texture.pixels + size_t (y) * texture.width + x);
+	}
+
+	// frame or texture pixels as bitmap data for the BitmapPrimitives32 helpers
+	inline void describePixels (BitmapData& data, const uint32* pixels, int width, int height, int rowPixels)
+	{
+		data.width = width;
+		data.height = height;
+		data.format = Core::kBitmapRGBAlpha;
+		data.bitsPerPixel = 32;
+		data.rowBytes = rowPixels * sizeof(uint32);
+		data.scan0 = const_cast<uint32*> (pixels);
+	}
+
+	inline int floorDivide (int32 value, int32 divisor)
+	{
+		return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+	}
+
+	inline int64 edge (int32 ax, int32 ay, int32 bx, int32 by, int64 px, int64 py)
+	{
+		return int64 (bx - ax) * (py - ay) - int64 (by - ay) * (px - ax);
+	}
+}
+
+using namespace RasterMath;
+
+//************************************************************************************************
+// SoftwareRasterizer::Implementation
+//************************************************************************************************
+
+struct SoftwareRasterizer::Implementation
+{
+	struct Stream
+	{
+		const uint8* positions = nullptr;
+		int stride = 0;
+		const PointF3D* normals = nullptr;	///< null for unlit draws
+		const uint8* coordinates = nullptr;	///< null for untextured draws
+		int coordinateStride = 0;
+		int vertexCount = 0;
+		const uint32* indices = nullptr;	///< null for triangle lists
+		Placement placement;
+		int firstVertex = 0;				///< in the view vertices
+	};
+
+	struct Batch
+	{
+		int stream = 0;
+		int firstIndex = 0;
+		int triangleCount = 0;
+		int firstTriangle = 0;				///< in submission order over all batches
+		float color[4] = {};				///< premultiplied
+		bool cullBackFaces = true;
+		Texture texture;
+	};
+
+	struct Triangle
+	{
+		int32 x[3];					///< fixed point sample positions
+		int32 y[3];
+		float invW[3];				///< 1 / view distance, interpolates linearly on screen
+		float lightW[3];			///< light * invW
+		float uW[3];				///< texture coordinates * invW
+		float vW[3];
+		float invArea;
+		int bounds[4];				///< covered samples, left, top, right, bottom (inclusive)
+		const float* color;
+		const Texture* texture;		///< null if untextured
+	};
+
+	struct Chunk
+	{
+		std::vector<Triangle> triangles;
+		std::vector<std::vector<int>> bins;		///< triangle indices per tile
+		int binned = 0;
+	};
+
+	PointF3D cameraPosition;
+	float cameraAngles[3] = {};
+	float fieldOfView = 45.f;
+	float nearDistance = .1f;
+	PointF3D lightDirection = PointF3D (0.f, -1.f, 0.f);
+	float ambient = .3f;
+	uint8 clearColor[4] = {0, 0, 0, 255};
+
+	std::vector<Stream> streams;
+	std::vector<Batch> batches;
+	int vertexCount = 0;
+	int triangleCount = 0;
+
+	std::vector<ViewVertex> viewVertices;
+	std::vector<Chunk> chunks;
+	std::vector<uint8> colors;		///< 4 bytes per sample
+	std::vector<float> depths;		///< invW per sample, 0 is infinitely far
+	std::vector<uint32> pixels;
+	int tileColumns = 0;
+	int tileRows = 0;
+};
+
+//************************************************************************************************
+// SoftwareRasterizer
+//************************************************************************************************
+
+SoftwareRasterizer::SoftwareRasterizer ()
+: threadCount (WorkerPool::getHardwareThreadCount ()),
+  tileSize (kDefaultTileSize),
+  implementation (NEW Implementation),
+  width (0),
+  height (0),
+  sampleCount (1)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+SoftwareRasterizer::~SoftwareRasterizer ()
+{
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SoftwareRasterizer::setup (int _width, int _height, int _sampleCount)
+{
+	if(_width <= 0 || _height <= 0 || (_sampleCount != 1 && _sampleCount != 4))
+		return false;
+
+	width = _width;
+	height = _height;
+	sampleCount = _sampleCount;
+
+	int factor = sampleCount == 4 ? 2 : 1;
+	size_t samples = size_t (width * factor) * size_t (height * factor);
+	implementation->colors.assign (samples * 4, 0);
+	implementation->depths.assign (samples, 0.f);
+	implementation->pixels.assign (size_t (width) * size_t (height), 0);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::setCamera (PointF3DRef position, float yaw, float pitch, float roll, float fieldOfView, float nearDistance)
+{
+	implementation->cameraPosition = position;
+	implementation->cameraAngles[0] = yaw;
+	implementation->cameraAngles[1] = pitch;
+	implementation->cameraAngles[2] = roll;
+	implementation->fieldOfView = fieldOfView;
+	implementation->nearDistance = ccl_max (nearDistance, .0001f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::setCamera (ICamera3D& camera, float nearDistance)
+{
+	setCamera (camera.getPosition (), camera.getYawAngle (), camera.getPitchAngle (), camera.getRollAngle (),
+			   camera.getFieldOfViewAngle (), nearDistance);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::setLight (PointF3DRef direction, float ambient)
+{
+	float length = ::sqrtf (direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+	if(length > 0.f)
+		implementation->lightDirection = PointF3D (direction.x / length, direction.y / length, direction.z / length);
+	implementation->ambient = ambient;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::setClearColor (float red, float green, float blue, float alpha)
+{
+	uint8* color = implementation->clearColor;
+	color[0] = toByte (red * alpha);
+	color[1] = toByte (green * alpha);
+	color[2] = toByte (blue * alpha);
+	color[3] = toByte (alpha);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::addMesh (const MeshData& mesh, const Placement& placement, const Texture* texture)
+{
+	if(mesh.isEmpty ())
+		return;
+
+	Implementation::Stream stream;
+	stream.positions = reinterpret_cast<const uint8*> (mesh.positions.getItems ());
+	stream.stride = sizeof(PointF3D);
+	stream.normals = mesh.normals.count () == mesh.positions.count () ? mesh.normals.getItems () : nullptr;
+	stream.vertexCount = mesh.getVertexCount ();
+	stream.indices = mesh.indices.getItems ();
+	if(texture && texture->isValid () && mesh.textureCoordinates.count () == mesh.positions.count ())
+	{
+		stream.coordinates = reinterpret_cast<const uint8*> (mesh.textureCoordinates.getItems ());
+		stream.coordinateStride = sizeof(PointF);
+	}
+	stream.placement = placement;
+	stream.firstVertex = implementation->vertexCount;
+	implementation->streams.push_back (stream);
+	implementation->vertexCount += stream.vertexCount;
+
+	auto addBatch = [&] (int32 material, int firstIndex, int indexCount)
+	{
+		MeshData::Material defaultMaterial;
+		const MeshData::Material& source = material >= 0 && material < mesh.materials.count () ? mesh.materials[material] : defaultMaterial;
+
+		Implementation::Batch batch;
+		batch.stream = int (implementation->streams.size ()) - 1;
+		batch.firstIndex = firstIndex;
+		batch.triangleCount = indexCount / 3;
+		batch.firstTriangle = implementation->triangleCount;
+		for(int c = 0; c < 3; c++)
+			batch.color[c] = source.color[c] * source.opacity;
+		batch.color[3] = source.opacity;
+		if(stream.coordinates)
+			batch.texture = *texture;
+		implementation->batches.push_back (batch);
+		implementation->triangleCount += batch.triangleCount;
+	};
+
+	if(mesh.groups.isEmpty ())
+		addBatch (-1, 0, mesh.indices.count ());
+	else
+		for(const MeshData::Group& group : mesh.groups)
+			addBatch (group.material, group.firstIndex, group.indexCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::addTriangles (const void* vertices, int vertexStride, int vertexCount, const Material& material, const Placement& placement)
+{
+	if(!vertices || vertexCount < 3)
+		return;
+
+	Implementation::Stream stream;
+	stream.positions = static_cast<const uint8*> (vertices);
+	stream.stride = vertexStride;
+	stream.vertexCount = vertexCount;
+	if(material.texture.isValid () && material.textureOffset >= 0)
+	{
+		stream.coordinates = stream.positions + material.textureOffset;
+		stream.coordinateStride = vertexStride;
+	}
+	stream.placement = placement;
+	stream.firstVertex = implementation->vertexCount;
+	implementation->streams.push_back (stream);
+	implementation->vertexCount += vertexCount;
+
+	// triangle lists have no normals and are drawn unlit
+	Implementation::Batch batch;
+	batch.stream = int (implementation->streams.size ()) - 1;
+	batch.triangleCount = vertexCount / 3;
+	batch.firstTriangle = implementation->triangleCount;
+	for(int c = 0; c < 3; c++)
+		batch.color[c] = material.color[c] * material.color[3];
+	batch.color[3] = material.color[3];
+	batch.cullBackFaces = material.cullBackFaces;
+	if(stream.coordinates)
+		batch.texture = material.texture;
+	implementation->batches.push_back (batch);
+	implementation->triangleCount += batch.triangleCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::removeAll ()
+{
+	implementation->streams.clear ();
+	implementation->batches.clear ();
+	implementation->vertexCount = 0;
+	implementation->triangleCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+const uint32* SoftwareRasterizer::getPixels () const
+{
+	return implementation->pixels.empty () ? nullptr : implementation->pixels.data ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRasterizer::render ()
+{
+	statistics = Statistics ();
+	if(width <= 0 || height <= 0)
+		return;
+
+	Implementation& impl = *implementation;
+	WorkerPool& pool = WorkerPool::instance ();
+	int threads = ccl_max (1, threadCount);
+	double startTime = System::GetProfileTime ();
+
+	// Vertex pass
+	RotationMatrix3D cameraRotation (impl.cameraAngles[0], impl.cameraAngles[1], impl.cameraAngles[2]);
+	impl.viewVertices.resize (impl.vertexCount);
+
+	struct VertexJob { int stream; int first; int count; };
+	std::vector<VertexJob> vertexJobs;
+	for(int s = 0; s < int (impl.streams.size ()); s++)
+		for(int first = 0; first < impl.streams[s].vertexCount; first += kVertexBatch)
+			vertexJobs.push_back ({s, first, ccl_min (kVertexBatch, impl.streams[s].vertexCount - first)});
+
+	pool.parallelFor (int (vertexJobs.size ()), threads, [&] (int j)
+	{
+		const VertexJob& job = vertexJobs[j];
+		const Implementation::Stream& stream = impl.streams[job.stream];
+		const Placement& placement = stream.placement;
+		RotationMatrix3D rotation (placement.yaw, placement.pitch, placement.roll);
+		PointF3D inverseScale (1.f / placement.scale.x, 1.f / placement.scale.y, 1.f / placement.scale.z);
+
+		for(int v = job.first; v < job.first + job.count; v++)
+		{
+			PointF3D p;
+			::memcpy (&p, stream.positions + size_t (v) * stream.stride, sizeof(float) * 3);
+			p = rotation * PointF3D (p.x * placement.scale.x, p.y * placement.scale.y, p.z * placement.scale.z);
+			p = PointF3D (p.x + placement.position.x - impl.cameraPosition.x,
+						  p.y + placement.position.y - impl.cameraPosition.y,
+						  p.z + placement.position.z - impl.cameraPosition.z);
+
+			ViewVertex& out = impl.viewVertices[stream.firstVertex + v];
+			out.position = cameraRotation.applyInverse (p);
+			out.light = 1.f;
+			if(stream.coordinates)
+				::memcpy (&out.coordinate, stream.coordinates + size_t (v) * stream.coordinateStride, sizeof(float) * 2);
+			if(stream.normals)
+			{
+				// normals transform with rotation and inverse scale, see InstancedModel
+				PointF3D n = stream.normals[v];
+				n = rotation * PointF3D (n.x * inverseScale.x, n.y * inverseScale.y, n.z * inverseScale.z);
+				float length = ::sqrtf (n.x * n.x + n.y * n.y + n.z * n.z);
+				if(length > 0.f)
+				{
+					float diffuse = -(n.x * impl.lightDirection.x + n.y * impl.lightDirection.y + n.z * impl.lightDirection.z) / length;
+					out.light = impl.ambient + (1.f - impl.ambient) * ccl_max (0.f, diffuse);
+				}
+			}
+		}
+	});
+
+	double vertexTime = System::GetProfileTime ();
+
+	// Binning, each chunk sets up a contiguous range of triangles in submission order
+	int factor = sampleCount == 4 ? 2 : 1;
+	int sampleWidth = width * factor;
+	int sampleHeight = height * factor;
+	int tileSamples = ccl_max (8, tileSize) * factor;
+	impl.tileColumns = (sampleWidth + tileSamples - 1) / tileSamples;
+	impl.tileRows = (sampleHeight + tileSamples - 1) / tileSamples;
+	int tileCount = impl.tileColumns * impl.tileRows;
+
+	int chunkCount = (impl.triangleCount + kTriangleBatch - 1) / kTriangleBatch;
+	impl.chunks.resize (chunkCount);
+
+	float tanY = ::tanf (Math::degreesToRad (impl.fieldOfView) * .5f);
+	float tanX = tanY * float (width) / float (height);
+
+	pool.parallelFor (chunkCount, threads, [&] (int c)
+	{
+		Implementation::Chunk& chunk = impl.chunks[c];
+		chunk.triangles.clear ();
+		chunk.bins.resize (tileCount);
+		for(std::vector<int>& bin : chunk.bins)
+			bin.clear ();
+		chunk.binned = 0;
+
+		int first = c * kTriangleBatch;
+		int last = ccl_min (first + kTriangleBatch, impl.triangleCount);
+
+		// the batch of the first triangle, batches are sorted by firstTriangle
+		int b = 0;
+		int low = 0, high = int (impl.batches.size ()) - 1;
+		while(low <= high)
+		{
+			int middle = (low + high) / 2;
+			if(impl.batches[middle].firstTriangle <= first)
+			{
+				b = middle;
+				low = middle + 1;
+			}
+			else
+				high = middle - 1;
+		}
+
+		for(int t = first; t < last; t++)
+		{
+			while(t >= impl.batches[b].firstTriangle + impl.batches[b].triangleCount)
+				b++;
+			const Implementation::Batch& batch = impl.batches[b];
+			const Implementation::Stream& stream = impl.streams[batch.stream];
+
+			int corner = batch.firstIndex + (t - batch.firstTriangle) * 3;
+			ViewVertex polygon[kMaxClipVertices];
+			for(int k = 0; k < 3; k++)
+			{
+				int index = stream.indices ? int (stream.indices[corner + k]) : corner + k;
+				polygon[k] = impl.viewVertices[stream.firstVertex + index];
+			}
+
+			// Clip at the near plane and the guard band, trivially accepted triangles skip this
+			auto distance = [&] (const ViewVertex& v, int plane)
+			{
+				const PointF3D& p = v.position;
+				switch(plane)
+				{
+				case 0 : return -p.z - impl.nearDistance;
+				case 1 : return -p.z * tanX * kGuardBand + p.x;
+				case 2 : return -p.z * tanX * kGuardBand - p.x;
+				case 3 : return -p.z * tanY * kGuardBand + p.y;
+				default : return -p.z * tanY * kGuardBand - p.y;
+				}
+			};
+
+			int vertexCount = 3;
+			bool rejected = false;
+			for(int plane = 0; plane < 5 && !rejected; plane++)
+			{
+				float d[kMaxClipVertices];
+				int inside = 0;
+				for(int k = 0; k < vertexCount; k++)
+					if((d[k] = distance (polygon[k], plane)) >= 0.f)
+						inside++;
+
+				if(inside == vertexCount)
+					continue;
+				if(inside == 0)
+				{
+					rejected = true;
+					break;
+				}
+
+				ViewVertex clipped[kMaxClipVertices];
+				int clippedCount = 0;
+				for(int k = 0; k < vertexCount; k++)
+				{
+					int next = (k + 1) % vertexCount;
+					if(d[k] >= 0.f)
+						clipped[clippedCount++] = polygon[k];
+					if((d[k] >= 0.f) != (d[next] >= 0.f) && clippedCount < kMaxClipVertices)
+						clipped[clippedCount++] = interpolate (polygon[k], polygon[next], d[k] / (d[k] - d[next]));
+				}
+				vertexCount = clippedCount;
+				for(int k = 0; k < vertexCount; k++)
+					polygon[k] = clipped[k];
+			}
+			if(rejected || vertexCount < 3)
+				continue;
+
+			// Project and set up the fan of the clipped polygon
+			int32 sx[kMaxClipVertices];
+			int32 sy[kMaxClipVertices];
+			float invW[kMaxClipVertices];
+			for(int k = 0; k < vertexCount; k++)
+			{
+				const PointF3D& p = polygon[k].position;
+				invW[k] = 1.f / -p.z;
+				float x = (p.x * invW[k] / tanX * .5f + .5f) * sampleWidth;
+				float y = (.5f - p.y * invW[k] / tanY * .5f) * sampleHeight;
+				sx[k] = int32 (::lroundf (x * kSubpixelScale));
+				sy[k] = int32 (::lroundf (y * kSubpixelScale));
+			}
+
+			for(int k = 1; k + 1 < vertexCount; k++)
+			{
+				int corners[3] = {0, k, k + 1};
+				int64 area = edge (sx[0], sy[0], sx[k], sy[k], sx[k + 1], sy[k + 1]);
+				if(area == 0)
+					continue;
+
+				// front faces are counter-clockwise on screen, which is a negative area with y down,
+				// they are turned around so all triangles are set up clockwise
+				if(area < 0)
+				{
+					corners[1] = k + 1;
+					corners[2] = k;
+					area = -area;
+				}
+				else if(batch.cullBackFaces)
+					continue;
+
+				Implementation::Triangle triangle;
+				int32 minX = sx[0], minY = sy[0], maxX = sx[0], maxY = sy[0];
+				for(int i = 0; i < 3; i++)
+				{
+					int v = corners[i];
+					triangle.x[i] = sx[v];
+					triangle.y[i] = sy[v];
+					triangle.invW[i] = invW[v];
+					triangle.lightW[i] = polygon[v].light * invW[v];
+					triangle.uW[i] = polygon[v].coordinate.x * invW[v];
+					triangle.vW[i] = polygon[v].coordinate.y * invW[v];
+					minX = ccl_min (minX, sx[v]);
+					minY = ccl_min (minY, sy[v]);
+					maxX = ccl_max (maxX, sx[v]);
+					maxY = ccl_max (maxY, sy[v]);
+				}
+
+				// samples are at the centers, covered if their center is inside
+				constexpr int32 kHalf = kSubpixelScale / 2;
+				triangle.bounds[0] = ccl_max (0, floorDivide (minX - kHalf + kSubpixelScale - 1, kSubpixelScale));
+				triangle.bounds[1] = ccl_max (0, floorDivide (minY - kHalf + kSubpixelScale - 1, kSubpixelScale));
+				triangle.bounds[2] = ccl_min (sampleWidth - 1, floorDivide (maxX - kHalf, kSubpixelScale));
+				triangle.bounds[3] = ccl_min (sampleHeight - 1, floorDivide (maxY - kHalf, kSubpixelScale));
+				if(triangle.bounds[0] > triangle.bounds[2] || triangle.bounds[1] > triangle.bounds[3])
+					continue;
+
+				triangle.invArea = 1.f / float (area);
+				triangle.color = batch.color;
+				triangle.texture = batch.texture.isValid () ? &batch.texture : nullptr;
+
+				int index = int (chunk.triangles.size ());
+				chunk.triangles.push_back (triangle);
+				for(int ty = triangle.bounds[1] / tileSamples; ty <= triangle.bounds[3] / tileSamples; ty++)
+					for(int tx = triangle.bounds[0] / tileSamples; tx <= triangle.bounds[2] / tileSamples; tx++)
+					{
+						chunk.bins[ty * impl.tileColumns + tx].push_back (index);
+						chunk.binned++;
+					}
+			}
+		}
+	});
+
+	double binTime = System::GetProfileTime ();
+
+	// Raster pass, one tile per job: clear, draw the bins of all chunks in order, resolve
+	uint8* colors = impl.colors.data ();
+	float* depths = impl.depths.data ();
+	uint32* pixels = impl.pixels.data ();
+
+	pool.parallelFor (tileCount, threads, [&] (int tile)
+	{
+		int left = (tile % impl.tileColumns) * tileSamples;
+		int top = (tile / impl.tileColumns) * tileSamples;
+		int right = ccl_min (left + tileSamples, sampleWidth) - 1;
+		int bottom = ccl_min (top + tileSamples, sampleHeight) - 1;
+
+		for(int y = top; y <= bottom; y++)
+		{
+			size_t row = size_t (y) * sampleWidth;
+			for(int x = left; x <= right; x++)
+			{
+				::memcpy (colors + (row + x) * 4, impl.clearColor, 4);
+				depths[row + x] = 0.f;
+			}
+		}
+
+		for(const Implementation::Chunk& chunk : impl.chunks)
+			for(int index : chunk.bins[tile])
+			{
+				const Implementation::Triangle& triangle = chunk.triangles[index];
+				int x0 = ccl_max (left, triangle.bounds[0]);
+				int y0 = ccl_max (top, triangle.bounds[1]);
+				int x1 = ccl_min (right, triangle.bounds[2]);
+				int y1 = ccl_min (bottom, triangle.bounds[3]);
+				if(x0 > x1 || y0 > y1)
+					continue;
+
+				// edge k is opposite vertex k, top-left edges own the samples exactly on them
+				const int32* tx = triangle.x;
+				const int32* ty = triangle.y;
+				int64 px = int64 (x0) * kSubpixelScale + kSubpixelScale / 2;
+				int64 py = int64 (y0) * kSubpixelScale + kSubpixelScale / 2;
+				int64 rowW[3];
+				int64 stepX[3];
+				int64 stepY[3];
+				for(int k = 0; k < 3; k++)
+				{
+					int a = (k + 1) % 3;
+					int b = (k + 2) % 3;
+					int32 dx = tx[b] - tx[a];
+					int32 dy = ty[b] - ty[a];
+					bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+					rowW[k] = edge (tx[a], ty[a], tx[b], ty[b], px, py) - (topLeft ? 0 : 1);
+					stepX[k] = -int64 (dy) * kSubpixelScale;
+					stepY[k] = int64 (dx) * kSubpixelScale;
+				}
+
+				const float* color = triangle.color;
+				for(int y = y0; y <= y1; y++)
+				{
+					int64 w0 = rowW[0], w1 = rowW[1], w2 = rowW[2];
+					size_t row = size_t (y) * sampleWidth;
+					for(int x = x0; x <= x1; x++, w0 += stepX[0], w1 += stepX[1], w2 += stepX[2])
+					{
+						if((w0 | w1 | w2) < 0)
+							continue;
+
+						float l1 = float (w1) * triangle.invArea;
+						float l2 = float (w2) * triangle.invArea;
+						float l0 = 1.f - l1 - l2;
+						float q = triangle.invW[0] * l0 + triangle.invW[1] * l1 + triangle.invW[2] * l2;
+						size_t sample = row + x;
+						if(q <= depths[sample])
+							continue;
+
+						float light = (triangle.lightW[0] * l0 + triangle.lightW[1] * l1 + triangle.lightW[2] * l2) / q;
+						float source[4] = {color[0] * light, color[1] * light, color[2] * light, color[3]};
+						if(triangle.texture)
+						{
+							// both are premultiplied, so is their product
+							float u = (triangle.uW[0] * l0 + triangle.uW[1] * l1 + triangle.uW[2] * l2) / q;
+							float v = (triangle.vW[0] * l0 + triangle.vW[1] * l1 + triangle.vW[2] * l2) / q;
+							const uint8* texel = sampleTexture (*triangle.texture, u, v);
+							for(int c = 0; c < 4; c++)
+								source[c] *= texel[c] * (1.f / 255.f);
+							if(texel[3] == 0)
+								continue;
+						}
+
+						uint8* target = colors + sample * 4;
+						if(source[3] < 1.f)
+						{
+							float inverseAlpha = 1.f - source[3];
+							for(int c = 0; c < 4; c++)
+								target[c] = toByte (source[c] + target[c] * (1.f / 255.f) * inverseAlpha);
+						}
+						else
+						{
+							for(int c = 0; c < 3; c++)
+								target[c] = toByte (source[c]);
+							target[3] = 255;
+							depths[sample] = q;
+						}
+					}
+					for(int k = 0; k < 3; k++)
+						rowW[k] += stepY[k];
+				}
+			}
+
+		for(int y = top / factor; y <= bottom / factor; y++)
+			for(int x = left / factor; x <= right / factor; x++)
+			{
+				uint8 pixel[4];
+				if(factor == 1)
+					::memcpy (pixel, colors + (size_t (y) * sampleWidth + x) * 4, 4);
+				else
+				{
+					const uint8* upper = colors + (size_t (y * 2) * sampleWidth + x * 2) * 4;
+					const uint8* lower = upper + size_t (sampleWidth) * 4;
+					for(int c = 0; c < 4; c++)
+						pixel[c] = uint8 ((upper[c] + upper[c + 4] + lower[c] + lower[c + 4] + 2) / 4);
+				}
+				::memcpy (pixels + size_t (y) * width + x, pixel, 4);
+			}
+	});
+
+	double endTime = System::GetProfileTime ();
+
+	statistics.triangles = impl.triangleCount;
+	for(const Implementation::Chunk& chunk : impl.chunks)
+	{
+		statistics.rasterized += int (chunk.triangles.size ());
+		statistics.binned += chunk.binned;
+	}
+	statistics.tiles = tileCount;
+	statistics.vertexMs = (vertexTime - startTime) * 1000.;
+	statistics.binMs = (binTime - vertexTime) * 1000.;
+	statistics.rasterMs = (endTime - binTime) * 1000.;
+	statistics.totalMs = (endTime - startTime) * 1000.;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SoftwareRasterizer::copyTo (IBitmap& bitmap) const
+{
+	if(implementation->pixels.empty ())
+		return false;
+
+	BitmapDataLocker locker (&bitmap, IBitmap::kRGBAlpha, IBitmap::kLockWrite);
+	if(locker.result != kResultOk)
+		return false;
+
+	// both limited to the overlapping area, the frame rows keep their full stride
+	BitmapData source;
+	BitmapData target = locker.data;
+	target.width = ccl_min (width, int (locker.data.width));
+	target.height = ccl_min (height, int (locker.data.height));
+	describePixels (source, implementation->pixels.data (), target.width, target.height, width);
+	Core::BitmapPrimitives32::copyFrom (target, source);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SoftwareRasterizer::copyFrom (Texture& texture, Vector<uint32>& pixels, IBitmap& bitmap)
+{
+	BitmapDataLocker locker (&bitmap, IBitmap::kRGBAlpha, IBitmap::kLockRead);
+	if(locker.result != kResultOk || locker.data.width <= 0 || locker.data.height <= 0)
+		return false;
+
+	int textureWidth = int (locker.data.width);
+	int textureHeight = int (locker.data.height);
+	pixels.setCount (textureWidth * textureHeight);
+
+	BitmapData target;
+	describePixels (target, pixels.getItems (), textureWidth, textureHeight, textureWidth);
+	Core::BitmapPrimitives32::copyFrom (target, locker.data);
+
+	texture.pixels = pixels.getItems ();
+	texture.width = textureWidth;
+	texture.height = textureHeight;
+	return true;
+}
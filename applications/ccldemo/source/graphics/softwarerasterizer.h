@@ -0,0 +1,151 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : softwarerasterizer.h
+// Description : Software Rasterizer
+//
+//************************************************************************************************
+
+#ifndef _softwarerasterizer_h
+#define _softwarerasterizer_h
+
+#include "meshdata.h"
+
+namespace CCL {
+
+interface IBitmap;
+
+//************************************************************************************************
+// SoftwareRasterizer
+/** Renders triangle meshes into a CPU buffer, e.g. for offscreen rendering where no GPU is
+	available. A frame runs in three parallel passes:
+
+	- vertex pass: vertices are transformed to view space and lit per vertex (ambient plus one
+	  directional light, the model of the stock solid color shader)
+	- binning: triangles are clipped at the near plane, culled, set up and sorted into the
+	  screen tiles they touch, each thread bins a contiguous range so draw order is kept
+	- raster pass: each tile is rasterized by one thread with edge functions, depth test,
+	  texture sampling and alpha blending, then resolved to pixels
+
+	With 4 samples per pixel the tiles hold a 2x2 sample grid per pixel which is averaged on
+	resolve. Blended draws and translucent texels test the depth but don't write it, add them
+	after the opaque ones and back to front. Drawn meshes and textures are referenced, not
+	copied, and must stay valid until render () returns. */
+//************************************************************************************************
+
+class SoftwareRasterizer: public Object
+{
+public:
+	SoftwareRasterizer ();
+	~SoftwareRasterizer ();
+
+	static constexpr int kDefaultTileSize = 64;	///< pixels
+
+	PROPERTY_VARIABLE (int, threadCount, ThreadCount)
+	PROPERTY_VARIABLE (int, tileSize, TileSize)
+
+	/** Size of the target in pixels, sampleCount is 1 or 4. */
+	bool setup (int width, int height, int sampleCount = 1);
+
+	int getWidth () const { return width; }
+	int getHeight () const { return height; }
+	int getSampleCount () const { return sampleCount; }
+
+	/** Perspective camera looking along -z with all angles zero, angles in radians,
+		fieldOfView is the vertical angle in degrees. */
+	void setCamera (PointF3DRef position, float yaw, float pitch, float roll, float fieldOfView, float nearDistance = .1f);
+	void setCamera (ICamera3D& camera, float nearDistance = .1f);
+
+	/** Directional light shining along direction, ambient is the light level of faces turned away. */
+	void setLight (PointF3DRef direction, float ambient);
+
+	/** Color the frame is cleared with, straight RGBA from 0 to 1. */
+	void setClearColor (float red, float green, float blue, float alpha = 1.f);
+
+	struct Placement
+	{
+		PointF3D position;
+		PointF3D scale = PointF3D (1.f, 1.f, 1.f);
+		float yaw = 0.f;		///< radians
+		float pitch = 0.f;
+		float roll = 0.f;
+	};
+
+	/** Pixels in the layout of getPixels (), rows top down, sampled nearest with wrap around.
+		Texture coordinate 0, 0 is the top left corner. */
+	struct Texture
+	{
+		const uint32* pixels = nullptr;
+		int width = 0;
+		int height = 0;
+
+		bool isValid () const { return pixels && width > 0 && height > 0; }
+	};
+
+	struct Material
+	{
+		float color[4] = {.8f, .8f, .8f, 1.f};	///< straight RGBA, blended if alpha is below 1
+		bool cullBackFaces = true;				///< front faces are counter-clockwise
+		Texture texture;						///< multiplied with the color
+		int textureOffset = -1;					///< of 2 floats in each vertex, -1 if untextured
+	};
+
+	/** Draw each group of the mesh with the color and opacity of its material, multiplied with
+		the texture at the texture coordinates of the mesh if one is passed. */
+	void addMesh (const MeshData& mesh, const Placement& placement, const Texture* texture = nullptr);
+
+	/** Draw an unlit triangle list, the position of each vertex is 3 floats at its start (e.g. VertexP). */
+	void addTriangles (const void* vertices, int vertexStride, int vertexCount, const Material& material, const Placement& placement);
+
+	void removeAll ();
+
+	/** Draw everything that was added into the cleared frame. */
+	void render ();
+
+	struct Statistics
+	{
+		int triangles = 0;			///< submitted
+		int rasterized = 0;			///< after clipping and culling
+		int binned = 0;				///< triangle references in tiles
+		int tiles = 0;
+		double vertexMs = 0.;
+		double binMs = 0.;
+		double rasterMs = 0.;		///< including resolve
+		double totalMs = 0.;
+	};
+
+	const Statistics& getStatistics () const { return statistics; }
+
+	/** Resolved frame, premultiplied RGBA with bytes in the order red, green, blue, alpha. */
+	const uint32* getPixels () const;
+
+	/** Copy the frame into a bitmap, the overlapping area if sizes differ. */
+	bool copyTo (IBitmap& bitmap) const;
+
+	/** Copy a bitmap into pixels in the layout of getPixels () and describe them as texture. */
+	static bool copyFrom (Texture& texture, Vector<uint32>& pixels, IBitmap& bitmap);
+
+protected:
+	struct Implementation;
+	Implementation* implementation;
+	int width;
+	int height;
+	int sampleCount;
+	Statistics statistics;
+};
+
+} // namespace CCL
+
+#endif // _softwarerasterizer_h
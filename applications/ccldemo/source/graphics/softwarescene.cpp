@@ -0,0 +1,323 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : softwarescene.cpp
+// Description : Software Scene
+//
+//************************************************************************************************
+
+#include "softwarescene.h"
+#include "objimporter.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+#include "ccl/public/math/mathprimitives.h"
+#include "ccl/public/plugservices.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace CCL;
+
+//************************************************************************************************
+// Helpers
+//************************************************************************************************
+
+namespace SceneGeometry
+{
+	// placements of the nodes in DemoSceneComponent
+	static const PointF3D kGridPosition (-2.5f, 0.f, -2.5f);
+	static const PointF3D kTeapotPosition (0.f, 1.f, 0.f);
+	static const PointF3D kOutlineCubePosition (2.5f, 1.f, -1.f);
+	static const PointF3D kTransparentCubePosition (4.f, 1.f, 1.f);
+	static const PointF3D kSpherePosition (0.f, 1.f, 2.5f);
+	static const PointF3D kBillboardPosition (0.f, 1.f, 2.5f);
+
+	static constexpr float kSphereRadius = .5f;
+	static constexpr int kSphereSegments = 32;
+	static constexpr float kGridLineWidth = .03f;
+	static constexpr float kPi = 3.14159265f;
+
+	// quad around center spanning +/- u and +/- v, facing along u x v, texture top at +v
+	static void addQuad (MeshData& mesh, PointF3DRef center, PointF3DRef u, PointF3DRef v, bool lit)
+	{
+		static const float kCorners[4][2] = {{-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f}};
+
+		PointF3D normal (u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x);
+		float length = ::sqrtf (normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if(length > 0.f)
+			normal = PointF3D (normal.x / length, normal.y / length, normal.z / length);
+
+		uint32 first = uint32 (mesh.positions.count ());
+		for(const auto& corner : kCorners)
+		{
+			mesh.positions.add (PointF3D (center.x + u.x * corner[0] + v.x * corner[1],
+										  center.y + u.y * corner[0] + v.y * corner[1],
+										  center.z + u.z * corner[0] + v.z * corner[1]));
+			if(lit)
+				mesh.normals.add (normal);
+			mesh.textureCoordinates.add (PointF ((corner[0] + 1.f) * .5f, (1.f - corner[1]) * .5f));
+		}
+
+		static const uint32 kIndices[6] = {0, 1, 2, 0, 2, 3};
+		for(uint32 index : kIndices)
+			mesh.indices.add (first + index);
+	}
+
+	// one group drawn with one material
+	static void finish (MeshData& mesh, float red, float green, float blue, float opacity)
+	{
+		MeshData::Material material;
+		material.color[0] = red;
+		material.color[1] = green;
+		material.color[2] = blue;
+		material.opacity = opacity;
+		mesh.materials.add (material);
+
+		MeshData::Group group;
+		group.material = 0;
+		group.indexCount = mesh.indices.count ();
+		mesh.groups.add (group);
+		mesh.computeBounds ();
+	}
+
+	// cells of 1 from the origin along x and z, like the grid model of the demo
+	static void buildGrid (MeshData& mesh, int columns, int rows)
+	{
+		float halfWidth = kGridLineWidth * .5f;
+		for(int column = 0; column <= columns; column++)
+			addQuad (mesh, PointF3D (float (column), 0.f, rows * .5f), PointF3D (halfWidth, 0.f, 0.f), PointF3D (0.f, 0.f, -rows * .5f), true);
+		for(int row = 0; row <= rows; row++)
+			addQuad (mesh, PointF3D (columns * .5f, 0.f, float (row)), PointF3D (columns * .5f, 0.f, 0.f), PointF3D (0.f, 0.f, -halfWidth), true);
+	}
+
+	// from -1 to 1 on all axes, each face with the whole texture
+	static void buildCube (MeshData& mesh)
+	{
+		static const float kFaces[6][9] =
+		{
+			// normal, u, v
+			{ 1.f, 0.f, 0.f,   0.f, 0.f, -1.f,   0.f, 1.f, 0.f},
+			{-1.f, 0.f, 0.f,   0.f, 0.f, 1.f,    0.f, 1.f, 0.f},
+			{ 0.f, 1.f, 0.f,   1.f, 0.f, 0.f,    0.f, 0.f, -1.f},
+			{ 0.f, -1.f, 0.f,  1.f, 0.f, 0.f,    0.f, 0.f, 1.f},
+			{ 0.f, 0.f, 1.f,   1.f, 0.f, 0.f,    0.f, 1.f, 0.f},
+			{ 0.f, 0.f, -1.f,  -1.f, 0.f, 0.f,   0.f, 1.f, 0.f}
+		};
+
+		for(const auto& face : kFaces)
+			addQuad (mesh, PointF3D (face[0], face[1], face[2]), PointF3D (face[3], face[4], face[5]), PointF3D (face[6], face[7], face[8]), true);
+	}
+
+	static void invert (MeshData& result, const MeshData& mesh)
+	{
+		for(int v = 0; v < mesh.getVertexCount (); v++)
+		{
+			result.positions.add (mesh.positions[v]);
+			result.normals.add (PointF3D (-mesh.normals[v].x, -mesh.normals[v].y, -mesh.normals[v].z));
+			result.textureCoordinates.add (mesh.textureCoordinates[v]);
+		}
+		for(int i = 0; i + 2 < mesh.indices.count (); i += 3)
+		{
+			result.indices.add (mesh.indices[i]);
+			result.indices.add (mesh.indices[i + 2]);
+			result.indices.add (mesh.indices[i + 1]);
+		}
+	}
+
+	static void buildSphere (MeshData& mesh, float radius, int segments)
+	{
+		for(int latitude = 0; latitude <= segments; latitude++)
+		{
+			float theta = kPi * latitude / segments;
+			for(int longitude = 0; longitude <= segments; longitude++)
+			{
+				float phi = 2.f * kPi * longitude / segments;
+				PointF3D normal (::sinf (theta) * ::cosf (phi), ::cosf (theta), ::sinf (theta) * ::sinf (phi));
+				mesh.positions.add (PointF3D (normal.x * radius, normal.y * radius, normal.z * radius));
+				mesh.normals.add (normal);
+				mesh.textureCoordinates.add (PointF (float (longitude) / segments, float (latitude) / segments));
+			}
+		}
+
+		uint32 rowLength = uint32 (segments + 1);
+		for(int latitude = 0; latitude < segments; latitude++)
+			for(int longitude = 0; longitude < segments; longitude++)
+			{
+				uint32 a = uint32 (latitude) * rowLength + uint32 (longitude);
+				uint32 b = a + rowLength;
+				const uint32 corners[6] = {a, a + 1, b + 1, a, b + 1, b};
+				for(uint32 index : corners)
+					mesh.indices.add (index);
+			}
+	}
+
+	static bool loadTexture (SoftwareRasterizer::Texture& texture, Vector<uint32>& pixels, UrlRef path)
+	{
+		AutoPtr<IImage> image = GraphicsFactory::loadImageFile (path);
+		UnknownPtr<IBitmap> bitmap (image);
+		return bitmap && SoftwareRasterizer::copyFrom (texture, pixels, *bitmap);
+	}
+}
+
+using namespace SceneGeometry;
+
+//************************************************************************************************
+// SoftwareScene
+//************************************************************************************************
+
+SoftwareScene::SoftwareScene ()
+: billboardAspect (1.f)
+{
+	buildGrid (grid, 4, 4);
+	finish (grid, .83f, .83f, .83f, 1.f);
+
+	buildCube (cube);
+	buildCube (transparentCube);
+	invert (innerCube, cube);
+	finish (cube, 1.f, 1.f, 1.f, 1.f);
+	finish (innerCube, 1.f, 1.f, 1.f, 1.f);
+	finish (transparentCube, 0.f, 0.f, 1.f, .7f);
+
+	buildSphere (sphere, kSphereRadius, kSphereSegments);
+	finish (sphere, 1.f, 0.f, 0.f, 200.f / 255.f);
+
+	addQuad (billboard, PointF3D (), PointF3D (.5f, 0.f, 0.f), PointF3D (0.f, .5f, 0.f), false);
+	finish (billboard, 1.f, 1.f, 1.f, 1.f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SoftwareScene::load (UrlRef skinFolder)
+{
+	// the files of the "DemoModel", "DemoTexture" and "OutlineTexture" resources of the skin
+	Url modelPath (skinFolder);
+	modelPath.descend ("3d/demo.obj");
+	if(teapot.isEmpty ())
+	{
+		ObjImporter importer;
+		if(!importer.import (teapot, modelPath))
+			return false;
+	}
+
+	Url demoPath (skinFolder);
+	demoPath.descend ("images/Voodoo.png");
+	Url outlinePath (skinFolder);
+	outlinePath.descend ("images/outline.png");
+	if(!loadTexture (demoTexture, demoPixels, demoPath) || !loadTexture (outlineTexture, outlinePixels, outlinePath))
+		return false;
+
+	billboardAspect = float (demoTexture.width) / float (demoTexture.height);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareScene::addOpaque (SoftwareRasterizer& rasterizer) const
+{
+	SoftwareRasterizer::Placement gridPlacement;
+	gridPlacement.position = kGridPosition;
+	rasterizer.addMesh (grid, gridPlacement);
+
+	SoftwareRasterizer::Placement teapotPlacement;
+	teapotPlacement.position = kTeapotPosition;
+	rasterizer.addMesh (teapot, teapotPlacement);
+
+	// texels of the outline are opaque or skipped, so the faces need no order
+	SoftwareRasterizer::Placement outlinePlacement;
+	outlinePlacement.position = kOutlineCubePosition;
+	outlinePlacement.scale = PointF3D (.5f, .5f, .5f);
+	outlinePlacement.roll = 2.5f;
+	outlinePlacement.yaw = 2.f;
+	rasterizer.addMesh (innerCube, outlinePlacement, &outlineTexture);
+	rasterizer.addMesh (cube, outlinePlacement, &outlineTexture);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareScene::addBlended (SoftwareRasterizer& rasterizer, ICamera3D& camera) const
+{
+	struct Draw
+	{
+		const MeshData* mesh;
+		const SoftwareRasterizer::Texture* texture;
+		SoftwareRasterizer::Placement placement;
+		float distance;
+	};
+
+	Draw draws[3] = {};
+	draws[0].mesh = &transparentCube;
+	draws[0].texture = &demoTexture;
+	draws[0].placement.position = kTransparentCubePosition;
+	draws[0].placement.scale = PointF3D (1.2f, 1.2f, 1.2f);
+
+	draws[1].mesh = &sphere;
+	draws[1].placement.position = kSpherePosition;
+
+	draws[2].mesh = &billboard;
+	draws[2].texture = &demoTexture;
+	draws[2].placement.position = kBillboardPosition;
+	draws[2].placement.scale = PointF3D (.8f * billboardAspect, .8f, 1.f);
+	draws[2].placement.yaw = camera.getYawAngle ();
+	draws[2].placement.pitch = camera.getPitchAngle ();
+	draws[2].placement.roll = camera.getRollAngle ();
+
+	PointF3D eye = camera.getPosition ();
+	for(Draw& draw : draws)
+	{
+		PointF3DRef p = draw.placement.position;
+		draw.distance = (p.x - eye.x) * (p.x - eye.x) + (p.y - eye.y) * (p.y - eye.y) + (p.z - eye.z) * (p.z - eye.z);
+	}
+	std::stable_sort (draws, draws + ARRAY_COUNT (draws), [] (const Draw& a, const Draw& b) { return a.distance > b.distance; });
+
+	for(const Draw& draw : draws)
+		rasterizer.addMesh (*draw.mesh, draw.placement, draw.texture);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SoftwareScene::renderToFile (UrlRef path, UrlRef skinFolder, int width, int height, int sampleCount)
+{
+	SoftwareScene scene;
+	if(!scene.load (skinFolder))
+		return false;
+
+	// camera and directional light as set up by DemoSceneComponent
+	AutoPtr<ICamera3D> camera = ccl_new<ICamera3D> (ClassID::Camera3D);
+	if(!camera)
+		return false;
+	camera->setPosition (PointF3D (6.f, 8.f, 12.f));
+	camera->lookAt (PointF3D (0.f, 0.f, 0.f));
+	camera->setFieldOfViewAngle (33.f);
+
+	SoftwareRasterizer rasterizer;
+	if(!rasterizer.setup (width, height, sampleCount))
+		return false;
+	rasterizer.setCamera (*camera);
+	RotationMatrix3D lightRotation (-.2f, -.9f, .1f);
+	rasterizer.setLight (lightRotation * PointF3D (0.f, 0.f, -1.f), .25f);
+	rasterizer.setClearColor (.1f, .1f, .12f);
+
+	scene.addOpaque (rasterizer);
+	scene.addBlended (rasterizer, *camera);
+	rasterizer.render ();
+
+	AutoPtr<IImage> frame = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+	UnknownPtr<IBitmap> bitmap (frame);
+	if(!bitmap || !rasterizer.copyTo (*bitmap))
+		return false;
+
+	return GraphicsFactory::saveImageFile (path, frame);
+}
@@ -0,0 +1,70 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : softwarescene.h
+// Description : Software Scene
+//
+//************************************************************************************************
+
+#ifndef _softwarescene_h
+#define _softwarescene_h
+
+#include "softwarerasterizer.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// SoftwareScene
+/** The nodes of the 3D graphics demo for the SoftwareRasterizer: grid, teapot, outline cube,
+	transparent cube, sphere and the image billboard, where the demo places them. Models and
+	textures are loaded from the skin folder, not the theme, so the scene renders without a
+	window or GPU. The text billboard is left out, its texture is updated while it is shown. */
+//************************************************************************************************
+
+class SoftwareScene: public Object
+{
+public:
+	SoftwareScene ();
+
+	/** Load the teapot and the textures, fails if one is missing. */
+	bool load (UrlRef skinFolder);
+
+	/** Add the opaque nodes, before the blended ones. */
+	void addOpaque (SoftwareRasterizer& rasterizer) const;
+
+	/** Add the blended nodes back to front, billboards turn towards the camera. */
+	void addBlended (SoftwareRasterizer& rasterizer, ICamera3D& camera) const;
+
+	/** Render the scene from the default camera of the demo and save it as PNG file. */
+	static bool renderToFile (UrlRef path, UrlRef skinFolder, int width, int height, int sampleCount = 4);
+
+protected:
+	MeshData teapot;
+	MeshData grid;
+	MeshData cube;
+	MeshData innerCube;			///< faces turned inwards, seen through the outline texture
+	MeshData transparentCube;
+	MeshData sphere;
+	MeshData billboard;			///< unlit unit quad
+	Vector<uint32> demoPixels;
+	Vector<uint32> outlinePixels;
+	SoftwareRasterizer::Texture demoTexture;
+	SoftwareRasterizer::Texture outlineTexture;
+	float billboardAspect;
+};
+
+} // namespace CCL
+
+#endif // _softwarescene_h
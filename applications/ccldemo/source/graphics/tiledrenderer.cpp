@@ -0,0 +1,192 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : tiledrenderer.cpp
+// Description : Tiled Renderer
+//
+//************************************************************************************************
+
+#include "tiledrenderer.h"
+
+#include "../workerpool.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// TiledRenderer
+//************************************************************************************************
+
+TiledRenderer::TiledRenderer ()
+: enabled (false),
+  parallel (false),
+  threadCount (WorkerPool::getHardwareThreadCount ()),
+  tileSize (kDefaultTileSize),
+  bitmapScaleFactor (1.f),
+  lastTileCount (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+TiledRenderer::~TiledRenderer ()
+{
+	purge ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TiledRenderer::purge ()
+{
+	VectorForEach (tiles, Tile*, tile)
+		delete tile;
+	EndFor
+	tiles.removeAll ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+Coord TiledRenderer::alignToGrid (Coord value, Coord size)
+{
+	// rounds towards negative infinity, division alone would round negative origins up
+	Coord cell = value / size;
+	if(value % size != 0 && value < 0)
+		cell--;
+	return cell * size;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TiledRenderer::prepareTiles (RectRef updateRect, float scaleFactor)
+{
+	if(scaleFactor != bitmapScaleFactor)
+	{
+		purge ();
+		bitmapScaleFactor = scaleFactor;
+	}
+
+	// tile grid is anchored at the client origin, so a tile always covers the same device pixels
+	Coord size = ccl_max<Coord> (tileSize, 16);
+	Coord left = alignToGrid (updateRect.left, size);
+	Coord top = alignToGrid (updateRect.top, size);
+
+	int index = 0;
+	for(Coord y = top; y < updateRect.bottom; y += size)
+		for(Coord x = left; x < updateRect.right; x += size)
+		{
+			Rect rect (x, y, x + size, y + size);
+			rect.bound (updateRect);
+			if(rect.isEmpty ())
+				continue;
+
+			if(index >= tiles.count ())
+				tiles.add (NEW Tile);
+
+			// bitmaps are reused as long as they are large enough
+			Tile* tile = tiles.at (index++);
+			if(!tile->bitmap || tile->bitmap->getWidth () < rect.getWidth () || tile->bitmap->getHeight () < rect.getHeight ())
+				tile->bitmap = GraphicsFactory::createBitmap (size, size, IBitmap::kRGBAlpha, bitmapScaleFactor);
+			tile->rect = rect;
+		}
+
+	lastTileCount = index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TiledRenderer::render (IGraphics& target, RectRef updateRect, TileContent& content, float scaleFactor)
+{
+	if(updateRect.isEmpty ())
+		return;
+
+	prepareTiles (updateRect, scaleFactor);
+
+	// rasterize tiles, in parallel if enabled...
+	WorkerPool::instance ().parallelFor (lastTileCount, parallel ? threadCount : 1, [&] (int index)
+	{
+		Tile* tile = tiles.at (index);
+		AutoPtr<IGraphics> graphics = GraphicsFactory::createBitmapGraphics (tile->bitmap);
+		if(!graphics)
+			return;
+
+		Rect tileClip (0, 0, tile->rect.getWidth (), tile->rect.getHeight ());
+		graphics->clearRect (Rect (0, 0, tile->bitmap->getWidth (), tile->bitmap->getHeight ()));
+		graphics->addClip (tileClip);
+		graphics->addTransform (Transform ().translate ((float)-tile->rect.left, (float)-tile->rect.top));
+		content.drawTile (*graphics);
+	});
+
+	// ...and composite them on the calling thread
+	for(int i = 0; i < lastTileCount; i++)
+	{
+		Tile* tile = tiles.at (i);
+		Rect src (0, 0, tile->rect.getWidth (), tile->rect.getHeight ());
+		target.drawImage (tile->bitmap, src, tile->rect);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int TiledRenderer::compare (Coord width, Coord height, TileContent& content, int* maxDelta, int* tileCount)
+{
+	AutoPtr<IImage> direct = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+	AutoPtr<IImage> tiled = GraphicsFactory::createBitmap (width, height, IBitmap::kRGBAlpha);
+	AutoPtr<IGraphics> directGraphics = GraphicsFactory::createBitmapGraphics (direct);
+	AutoPtr<IGraphics> tiledGraphics = GraphicsFactory::createBitmapGraphics (tiled);
+	if(!directGraphics || !tiledGraphics)
+		return -1;
+
+	Rect rect (0, 0, width, height);
+	directGraphics->clearRect (rect);
+	content.drawTile (*directGraphics);
+	tiledGraphics->clearRect (rect);
+
+	// rendering at scale 1 here would replace the tiles cached for the view's scale factor
+	TiledRenderer renderer;
+	renderer.setParallel (parallel);
+	renderer.setThreadCount (threadCount);
+	renderer.setTileSize (tileSize);
+	renderer.render (*tiledGraphics, rect, content);
+	if(tileCount)
+		*tileCount = renderer.getLastTileCount ();
+	directGraphics.release ();
+	tiledGraphics.release ();
+
+	BitmapDataLocker a (UnknownPtr<IBitmap> (direct), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+	BitmapDataLocker b (UnknownPtr<IBitmap> (tiled), IBitmap::kRGBAlpha, IBitmap::kLockRead);
+	if(a.result != kResultOk || b.result != kResultOk)
+		return -1;
+
+	int mismatches = 0;
+	int delta = 0;
+	for(int y = 0; y < height; y++)
+	{
+		const uint8* rowA = static_cast<const uint8*> (a.data.scan0) + y * a.data.rowBytes;
+		const uint8* rowB = static_cast<const uint8*> (b.data.scan0) + y * b.data.rowBytes;
+		for(int x = 0; x < width; x++)
+		{
+			int pixelDelta = 0;
+			for(int c = 0; c < 4; c++)
+				pixelDelta = ccl_max (pixelDelta, ccl_abs (int (rowA[x * 4 + c]) - int (rowB[x * 4 + c])));
+			if(pixelDelta > 0)
+				mismatches++;
+			delta = ccl_max (delta, pixelDelta);
+		}
+	}
+	if(maxDelta)
+		*maxDelta = delta;
+	return mismatches;
+}
@@ -0,0 +1,102 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : tiledrenderer.h
+// Description : Tiled Renderer
+//
+//************************************************************************************************
+
+#ifndef _tiledrenderer_h
+#define _tiledrenderer_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/iimage.h"
+#include "ccl/public/collections/vector.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// TileContent
+/** Content that can be drawn multiple times, once per tile. With parallel tiles drawTile () is
+	called concurrently from worker threads and must not modify shared state. */
+//************************************************************************************************
+
+struct TileContent
+{
+	virtual ~TileContent () {}
+
+	virtual void drawTile (IGraphics& graphics) = 0;
+};
+
+//************************************************************************************************
+// TiledRenderer
+/** Splits an update rectangle into tiles, replays the content into one offscreen bitmap per tile
+	(clipped to the tile) and composites the tiles into the target graphics. Tile origins are
+	aligned to whole device pixels, so content with an opaque background is reproduced exactly,
+	compare () checks this against drawing without tiles.
+
+	Tiles are drawn on the calling thread. The framework doesn't document graphics and text
+	calls on bitmaps as thread-safe, so drawing the tiles on the worker pool is an opt-in
+	experiment (parallel) for backends known to allow it. */
+//************************************************************************************************
+
+class TiledRenderer: public Object
+{
+public:
+	TiledRenderer ();
+	~TiledRenderer ();
+
+	static constexpr Coord kDefaultTileSize = 128;
+
+	PROPERTY_BOOL (enabled, Enabled)
+	PROPERTY_BOOL (parallel, Parallel)
+	PROPERTY_VARIABLE (int, threadCount, ThreadCount)
+	PROPERTY_VARIABLE (Coord, tileSize, TileSize)
+
+	/** Draw content into target, limited to updateRect (client coordinates). */
+	void render (IGraphics& target, RectRef updateRect, TileContent& content, float scaleFactor = 1.f);
+
+	/** Render content once with and once without tiles into bitmaps of the given size and count
+		the pixels that differ, -1 if the bitmaps can't be created. maxDelta receives the largest
+		channel difference, tileCount the number of tiles. The tiles are drawn by a separate
+		renderer with the same settings, the cached tiles of this one are kept. */
+	int compare (Coord width, Coord height, TileContent& content, int* maxDelta = nullptr, int* tileCount = nullptr);
+
+	/** Number of tiles drawn by the last render () call. */
+	int getLastTileCount () const { return lastTileCount; }
+
+	/** Release cached tile bitmaps. */
+	void purge ();
+
+protected:
+	struct Tile
+	{
+		Rect rect;
+		AutoPtr<IImage> bitmap;
+	};
+
+	Vector<Tile*> tiles;
+	float bitmapScaleFactor;
+	int lastTileCount;
+
+	void prepareTiles (RectRef updateRect, float scaleFactor);
+	static Coord alignToGrid (Coord value, Coord size);
+};
+
+} // namespace CCL
+
+#endif // _tiledrenderer_h
@@ -0,0 +1,108 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : transformedlayer.cpp
+// Description : Transformed Layer
+//
+//************************************************************************************************
+
+#include "transformedlayer.h"
+
+#include "ccl/public/gui/graphics/ibitmap.h"
+#include "ccl/public/gui/graphics/graphicsfactory.h"
+
+using namespace CCL;
+
+//************************************************************************************************
+// TransformedLayer
+//************************************************************************************************
+
+TransformedLayer::TransformedLayer ()
+: scaleTolerance (kDefaultScaleTolerance),
+  rasterScale (0.f),
+  rasterCount (0)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TransformedLayer::invalidate ()
+{
+	rasterScale = 0.f;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TransformedLayer::purge ()
+{
+	bitmap.release ();
+	rasterScale = 0.f;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool TransformedLayer::needsRasterize (PointRef size, float scale) const
+{
+	if(!bitmap || rasterScale <= 0.f || size != bitmapSize)
+		return true;
+
+	// drift is symmetric, magnifying and minifying by the same ratio count the same
+	float ratio = scale / rasterScale;
+	if(ratio < 1.f)
+		ratio = 1.f / ratio;
+	return ratio > 1.f + scaleTolerance;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TransformedLayer::rasterize (LayerContent& content, PointRef size, float scale)
+{
+	bitmap = GraphicsFactory::createBitmap (size.x, size.y, IBitmap::kRGBAlpha, scale);
+	AutoPtr<IGraphics> graphics = bitmap ? GraphicsFactory::createBitmapGraphics (bitmap) : nullptr;
+	if(!graphics)
+	{
+		purge ();
+		return;
+	}
+
+	graphics->clearRect (Rect (0, 0, size.x, size.y));
+	content.drawContent (*graphics, scale);
+
+	bitmapSize = size;
+	rasterScale = scale;
+	rasterCount++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TransformedLayer::draw (IGraphics& target, LayerContent& content, PointRef size, const Transform& transform, float scale)
+{
+	if(size.x <= 0 || size.y <= 0)
+		return;
+
+	scale = ccl_bound (scale, 1.f / kMaxScale, kMaxScale);
+	if(needsRasterize (size, scale))
+		rasterize (content, size, scale);
+
+	target.saveState ();
+	target.addTransform (transform);
+	if(bitmap)
+	{
+		Rect rect (0, 0, size.x, size.y);
+		target.drawImage (bitmap, rect, rect);
+	}
+	else
+		content.drawContent (target, scale); // no bitmap available, draw directly
+	target.restoreState ();
+}
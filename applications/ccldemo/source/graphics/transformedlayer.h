@@ -0,0 +1,88 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : transformedlayer.h
+// Description : Transformed Layer
+//
+//************************************************************************************************
+
+#ifndef _transformedlayer_h
+#define _transformedlayer_h
+
+#include "ccl/base/object.h"
+
+#include "ccl/public/gui/graphics/igraphics.h"
+#include "ccl/public/gui/graphics/iimage.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// LayerContent
+/** Static content of a layer, drawn in layer coordinates starting at (0, 0). */
+//************************************************************************************************
+
+struct LayerContent
+{
+	virtual ~LayerContent () {}
+
+	/** scale is the number of device pixels per layer unit the content is rasterized at. */
+	virtual void drawContent (IGraphics& graphics, float scale) = 0;
+};
+
+//************************************************************************************************
+// TransformedLayer
+/** Rasterizes content once into an offscreen bitmap and composites the bitmap with a transform
+	that may change from paint to paint. The content is rasterized again when it is invalidated
+	or when the required scale drifts from the rasterized one by more than the tolerance,
+	e.g. 0.25 accepts scales from 0.8x to 1.25x of the bitmap resolution. */
+//************************************************************************************************
+
+class TransformedLayer: public Object
+{
+public:
+	TransformedLayer ();
+
+	static constexpr float kDefaultScaleTolerance = .25f;
+	static constexpr float kMaxScale = 8.f;
+
+	PROPERTY_VARIABLE (float, scaleTolerance, ScaleTolerance)
+
+	/** Content has changed, rasterize it on the next draw. */
+	void invalidate ();
+
+	/** Draw content of the given size into target with the transform applied. scale is the number
+		of device pixels per layer unit after the transform. */
+	void draw (IGraphics& target, LayerContent& content, PointRef size, const Transform& transform, float scale);
+
+	/** Number of times the content has been rasterized. */
+	int getRasterCount () const { return rasterCount; }
+	float getRasterScale () const { return rasterScale; }
+
+	/** Release the bitmap. */
+	void purge ();
+
+protected:
+	AutoPtr<IImage> bitmap;
+	Point bitmapSize;
+	float rasterScale;
+	int rasterCount;
+
+	bool needsRasterize (PointRef size, float scale) const;
+	void rasterize (LayerContent& content, PointRef size, float scale);
+};
+
+} // namespace CCL
+
+#endif // _transformedlayer_h
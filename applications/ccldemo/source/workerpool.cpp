@@ -0,0 +1,210 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : workerpool.cpp
+// Description : Worker Pool
+//
+//************************************************************************************************
+
+#include "workerpool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace CCL;
+
+/** Set on pool threads and on a thread while it takes part in a job. */
+static thread_local bool insideJob = false;
+
+//************************************************************************************************
+// WorkerPool::Implementation
+//************************************************************************************************
+
+struct WorkerPool::Implementation
+{
+	std::mutex jobLock;				///< serializes parallelFor () calls
+	std::mutex stateLock;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+	std::thread threads[kMaxThreads - 1];
+	int threadCount = 0;
+
+	Job* job = nullptr;
+	int jobCount = 0;
+	int jobGeneration = 0;
+	int jobWorkers = 0;				///< number of pool threads allowed to join the current job
+	int activeWorkers = 0;
+	std::atomic<int> nextIndex {0};
+	bool terminate = false;
+
+	std::thread backgroundThread;
+	std::condition_variable taskAvailable;
+	std::deque<Task*> tasks;			///< guarded by stateLock
+
+	void processIndices (Job& job, int count)
+	{
+		for(int index = nextIndex++; index < count; index = nextIndex++)
+			job.run (index);
+	}
+
+	void workerLoop (int workerIndex)
+	{
+		insideJob = true;
+		int seenGeneration = 0;
+		while(true)
+		{
+			Job* currentJob = nullptr;
+			int count = 0;
+			{
+				std::unique_lock<std::mutex> lock (stateLock);
+				wakeUp.wait (lock, [&] { return terminate || (jobGeneration != seenGeneration && workerIndex < jobWorkers); });
+				if(terminate)
+					return;
+
+				seenGeneration = jobGeneration;
+				currentJob = job;
+				count = jobCount;
+				activeWorkers++;
+			}
+
+			processIndices (*currentJob, count);
+
+			std::lock_guard<std::mutex> lock (stateLock);
+			if(--activeWorkers == 0)
+				finished.notify_all ();
+		}
+	}
+
+	void backgroundLoop ()
+	{
+		while(true)
+		{
+			Task* task = nullptr;
+			{
+				std::unique_lock<std::mutex> lock (stateLock);
+				taskAvailable.wait (lock, [&] { return terminate || !tasks.empty (); });
+				if(terminate)
+					return;
+
+				task = tasks.front ();
+				tasks.pop_front ();
+			}
+
+			task->run ();
+			delete task;
+		}
+	}
+
+	void startThreads (int count)
+	{
+		for(; threadCount < count; threadCount++)
+			threads[threadCount] = std::thread ([this, index = threadCount] { workerLoop (index); });
+	}
+};
+
+//************************************************************************************************
+// WorkerPool
+//************************************************************************************************
+
+DEFINE_SINGLETON (WorkerPool)
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+int WorkerPool::getHardwareThreadCount ()
+{
+	return ccl_bound<int> (std::thread::hardware_concurrency (), 1, kMaxThreads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerPool::WorkerPool ()
+: implementation (NEW Implementation)
+{}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerPool::~WorkerPool ()
+{
+	{
+		std::lock_guard<std::mutex> lock (implementation->stateLock);
+		implementation->terminate = true;
+	}
+	implementation->wakeUp.notify_all ();
+	implementation->taskAvailable.notify_all ();
+
+	for(int i = 0; i < implementation->threadCount; i++)
+		implementation->threads[i].join ();
+	if(implementation->backgroundThread.joinable ())
+		implementation->backgroundThread.join ();
+	for(Task* task : implementation->tasks)
+		delete task;
+
+	delete implementation;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::runJob (Job& job, int count, int threadCount)
+{
+	threadCount = ccl_bound (threadCount, 1, kMaxThreads);
+	int poolThreads = ccl_min (threadCount, count) - 1;
+
+	// Nested calls (from a job body) or calls from a background task while another job runs
+	// would wait for threads that are busy with the outer job, so they run inline
+	std::unique_lock<std::mutex> jobLock (implementation->jobLock, std::try_to_lock);
+	if(insideJob || !jobLock.owns_lock ())
+	{
+		for(int i = 0; i < count; i++)
+			job.run (i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock (implementation->stateLock);
+		implementation->startThreads (poolThreads);
+		implementation->job = &job;
+		implementation->jobCount = count;
+		implementation->jobWorkers = poolThreads;
+		implementation->nextIndex = 0;
+		implementation->jobGeneration++;
+	}
+	implementation->wakeUp.notify_all ();
+
+	insideJob = true;
+	implementation->processIndices (job, count);
+	insideJob = false;
+
+	// wait until all indices are done and no worker still references the job
+	std::unique_lock<std::mutex> lock (implementation->stateLock);
+	implementation->jobWorkers = 0;
+	implementation->finished.wait (lock, [&] { return implementation->activeWorkers == 0; });
+	implementation->job = nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::postTask (Task* task)
+{
+	{
+		std::lock_guard<std::mutex> lock (implementation->stateLock);
+		if(!implementation->backgroundThread.joinable ())
+			implementation->backgroundThread = std::thread ([this] { implementation->backgroundLoop (); });
+		implementation->tasks.push_back (task);
+	}
+	implementation->taskAvailable.notify_one ();
+}
@@ -0,0 +1,132 @@
+//************************************************************************************************
+//
+// CCL Demo Application
+//
+// This file is part of Crystal Class Library (R)
+// Copyright (c) 2025 CCL Software Licensing GmbH.
+// All Rights Reserved.
+//
+// Licensed for use under either:
+//  1. a Commercial License provided by CCL Software Licensing GmbH, or
+//  2. GNU Affero General Public License v3.0 (AGPLv3).
+//
+// You must choose and comply with one of the above licensing options.
+// For more information, please visit ccl.dev.
+//
+// Filename    : workerpool.h
+// Description : Worker Pool
+//
+//************************************************************************************************
+
+#ifndef _workerpool_h
+#define _workerpool_h
+
+#include "ccl/base/singleton.h"
+
+namespace CCL {
+
+//************************************************************************************************
+// WorkerPool
+/** Fixed set of worker threads for data-parallel jobs of the demos.
+	parallelFor () blocks until all indices have been processed, the calling thread takes part.
+	Calls from inside a job body, or while another thread runs a job, process their indices
+	inline on the calling thread. post () runs a task asynchronously on a separate background
+	thread.
+
+	Standard library use in the demo sources: the pool and the caches and importers that run
+	on it (font metrics, scaled images, geometry, scene index, OBJ import, capture) use
+	std::thread, atomics, mutexes and hash maps keyed by bytes inside their .cpp files. They
+	need lock-free counters, reader-writer locks and hashing of composite keys, which behave the
+	same on every platform the demo builds for. Headers stay on framework types (Object, String,
+	Vector, SharedPtr), so none of it shows up in an interface. */
+//************************************************************************************************
+
+class WorkerPool: public Object,
+				  public Singleton<WorkerPool>
+{
+public:
+	WorkerPool ();
+	~WorkerPool ();
+
+	static constexpr int kMaxThreads = 16;
+
+	/** Number of hardware threads available. */
+	static int getHardwareThreadCount ();
+
+	/** Call body (index) for all indices in [0, count) using up to threadCount threads. */
+	template <typename Body>
+	void parallelFor (int count, int threadCount, const Body& body);
+
+	/** Call body () on the background thread, tasks run one after another in posting order.
+		The body is copied, tasks still queued on shutdown are dropped. */
+	template <typename Body>
+	void post (const Body& body);
+
+protected:
+	struct Job
+	{
+		virtual ~Job () {}
+		virtual void run (int index) = 0;
+	};
+
+	template <typename Body>
+	struct BodyJob: Job
+	{
+		const Body& body;
+		BodyJob (const Body& body): body (body) {}
+		void run (int index) override { body (index); }
+	};
+
+	struct Task
+	{
+		virtual ~Task () {}
+		virtual void run () = 0;
+	};
+
+	template <typename Body>
+	struct BodyTask: Task
+	{
+		Body body;
+		BodyTask (const Body& body): body (body) {}
+		void run () override { body (); }
+	};
+
+	struct Implementation;
+	Implementation* implementation;
+
+	void runJob (Job& job, int count, int threadCount);
+	void postTask (Task* task);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+// WorkerPool inline
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Body>
+inline void WorkerPool::parallelFor (int count, int threadCount, const Body& body)
+{
+	if(count <= 0)
+		return;
+
+	if(threadCount <= 1 || count == 1)
+	{
+		for(int i = 0; i < count; i++)
+			body (i);
+		return;
+	}
+
+	BodyJob<Body> job (body);
+	runJob (job, count, threadCount);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Body>
+inline void WorkerPool::post (const Body& body)
+{
+	postTask (NEW BodyTask<Body> (body));
+}
+
+} // namespace CCL
+
+#endif // _workerpool_h